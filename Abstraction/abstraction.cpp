@@ -0,0 +1,434 @@
+#include "abstraction.h"
+#include "../Card/isomorphism.h"
+#include "../Concurrency/scheduler.h"
+#include "../pokerHand/handstate.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../Random/rng.h"
+#include "../Range/range.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+    constexpr char MAGIC[8] = {'A', 'Y', 'B', 'K', 'T', 0, 0, 0};
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t boardCards;
+        uint32_t bucketCount;
+        uint32_t reserved;
+        uint64_t boardCount;     // 之后依次为 uint64_t[boardCount] 和 uint16_t[boardCount * 1326]，
+                                 // 第 2 版再接 E[HS] 和 E[HS²] 各 uint16_t[boardCount * 1326]
+    };
+    static_assert(sizeof(FileHeader) == 32, "file header layout changed");
+
+    uint16_t quantize(float value) {
+        return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    // 在 scheduler 上并行执行 body(i)，i 取遍 [0, count)
+    template<typename Body>
+    void parallelEach(TaskScheduler &scheduler, size_t count, int grain, Body body) {
+        scheduler.parallelFor(static_cast<int>(count), grain, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                body(static_cast<size_t>(i));
+            }
+        });
+    }
+
+    // 特征点：量化到 0~255 的累积直方图，每个点 dims 个字节
+    struct Features {
+        int dims = 0;
+        std::vector<uint8_t> values;
+
+        [[nodiscard]] const uint8_t *point(size_t index) const { return values.data() + index * dims; }
+    };
+
+    // 一维 EMD：累积直方图逐项差的绝对值之和
+    float emd(const uint8_t *point, const float *centroid, int dims) {
+        float distance = 0;
+        for (int d = 0; d < dims; ++d) {
+            distance += std::fabs(static_cast<float>(point[d]) - centroid[d]);
+        }
+        return distance;
+    }
+
+    int nearest(const uint8_t *point, const std::vector<float> &centroids, int k, int dims) {
+        int best = 0;
+        float bestDistance = emd(point, centroids.data(), dims);
+        for (int c = 1; c < k; ++c) {
+            float distance = emd(point, centroids.data() + c * dims, dims);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = c;
+            }
+        }
+        return best;
+    }
+
+    // 在抽样点上做 k-means（k-means++ 初始化），返回聚类中心
+    // 中心取累积直方图的平均值，平均后仍是合法的累积直方图
+    std::vector<float> trainCentroids(const Features &features, const std::vector<size_t> &sample, int k,
+                                      const AbstractionConfig &config, TaskScheduler &scheduler) {
+        const int dims = features.dims;
+        Xoshiro256 rng(config.seed);
+        std::vector<float> centroids;
+        centroids.reserve(static_cast<size_t>(k) * dims);
+        auto addCentroid = [&](size_t index) {
+            const uint8_t *point = features.point(index);
+            centroids.insert(centroids.end(), point, point + dims);
+        };
+
+        addCentroid(sample[rng() % sample.size()]);
+        std::vector<float> distances(sample.size());
+        for (size_t i = 0; i < sample.size(); ++i) {
+            float d = emd(features.point(sample[i]), centroids.data(), dims);
+            distances[i] = d * d;
+        }
+        for (int c = 1; c < k; ++c) {
+            double total = std::accumulate(distances.begin(), distances.end(), 0.0);
+            size_t chosen = rng() % sample.size();
+            if (total > 0) {
+                double target = static_cast<double>(rng() >> 11) * 0x1.0p-53 * total;
+                for (size_t i = 0; i < sample.size(); ++i) {
+                    target -= distances[i];
+                    if (target <= 0) {
+                        chosen = i;
+                        break;
+                    }
+                }
+            }
+            addCentroid(sample[chosen]);
+            const float *latest = centroids.data() + static_cast<size_t>(c) * dims;
+            for (size_t i = 0; i < sample.size(); ++i) {
+                float d = emd(features.point(sample[i]), latest, dims);
+                distances[i] = std::min(distances[i], d * d);
+            }
+        }
+
+        std::vector<int> assignment(sample.size());
+        for (int iteration = 0; iteration < config.iterations; ++iteration) {
+            parallelEach(scheduler, sample.size(), 4096, [&](size_t i) {
+                assignment[i] = nearest(features.point(sample[i]), centroids, k, dims);
+            });
+            std::vector<double> sums(static_cast<size_t>(k) * dims, 0);
+            std::vector<size_t> counts(k, 0);
+            for (size_t i = 0; i < sample.size(); ++i) {
+                const uint8_t *point = features.point(sample[i]);
+                double *sum = sums.data() + static_cast<size_t>(assignment[i]) * dims;
+                for (int d = 0; d < dims; ++d) {
+                    sum[d] += point[d];
+                }
+                ++counts[assignment[i]];
+            }
+            for (int c = 0; c < k; ++c) {
+                // 空簇保留原来的中心
+                if (counts[c] == 0) {
+                    continue;
+                }
+                for (int d = 0; d < dims; ++d) {
+                    centroids[static_cast<size_t>(c) * dims + d] =
+                            static_cast<float>(sums[static_cast<size_t>(c) * dims + d] / counts[c]);
+                }
+            }
+        }
+        return centroids;
+    }
+
+}
+
+void HandStrength::river(uint64_t board, float *strengths) {
+    // 对手均匀随机，只需要计数：按牌力等价类计数排序后从小到大扫描，
+    // 用每张牌的计数扣除与英雄共享牌的对手组合
+    uint16_t classes[COMBO_COUNT];
+    int live[COMBO_COUNT];
+    int sorted[COMBO_COUNT];
+    int liveCount = 0;
+    int cardLive[CARD_COUNT] = {};
+    std::vector<int> bucketStart(LookupEvaluator::HAND_CLASS_COUNT + 1, 0);
+    const HandState boardState(CardSet{board});
+    for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+        strengths[combo] = -1;
+        const uint64_t mask = COMBO_MASKS[combo];
+        if (mask & board) {
+            continue;
+        }
+        classes[combo] = boardState.add(CardSet(mask)).evaluateClass();
+        ++bucketStart[classes[combo] + 1];
+        live[liveCount++] = combo;
+        ++cardLive[__builtin_ctzll(mask)];
+        ++cardLive[63 - __builtin_clzll(mask)];
+    }
+    for (int i = 1; i <= LookupEvaluator::HAND_CLASS_COUNT; ++i) {
+        bucketStart[i] += bucketStart[i - 1];
+    }
+    for (int i = 0; i < liveCount; ++i) {
+        sorted[bucketStart[classes[live[i]]]++] = live[i];
+    }
+
+    int below = 0;
+    int cardBelow[CARD_COUNT] = {};
+    int cardGroup[CARD_COUNT] = {};
+    for (int begin = 0; begin < liveCount;) {
+        int end = begin;
+        while (end < liveCount && classes[sorted[end]] == classes[sorted[begin]]) {
+            const uint64_t mask = COMBO_MASKS[sorted[end]];
+            ++cardGroup[__builtin_ctzll(mask)];
+            ++cardGroup[63 - __builtin_clzll(mask)];
+            ++end;
+        }
+        const int groupSize = end - begin;
+        for (int i = begin; i < end; ++i) {
+            const uint64_t mask = COMBO_MASKS[sorted[i]];
+            const int first = __builtin_ctzll(mask);
+            const int second = 63 - __builtin_clzll(mask);
+            // 同时含有两张牌的只有自己，两张牌的计数各含一次，所以加回 1
+            const int wins = below - cardBelow[first] - cardBelow[second];
+            const int ties = groupSize - cardGroup[first] - cardGroup[second] + 1;
+            const int opponents = liveCount - cardLive[first] - cardLive[second] + 1;
+            strengths[sorted[i]] = (static_cast<float>(wins) + 0.5f * static_cast<float>(ties)) / static_cast<float>(opponents);
+        }
+        for (int i = begin; i < end; ++i) {
+            const uint64_t mask = COMBO_MASKS[sorted[i]];
+            for (int card: {__builtin_ctzll(mask), 63 - __builtin_clzll(mask)}) {
+                cardBelow[card] += cardGroup[card];
+                cardGroup[card] = 0;
+            }
+        }
+        below += groupSize;
+        begin = end;
+    }
+}
+
+void HandStrength::distribution(uint64_t board, int bins, uint32_t *counts, float *expected, float *expectedSquare) {
+    std::fill(counts, counts + static_cast<size_t>(COMBO_COUNT) * bins, 0);
+    std::vector<double> sums(COMBO_COUNT, 0);
+    std::vector<double> squares(COMBO_COUNT, 0);
+    std::vector<uint32_t> runouts(COMBO_COUNT, 0);
+    float strengths[COMBO_COUNT];
+
+    auto accumulate = [&](uint64_t fullBoard) {
+        river(fullBoard, strengths);
+        for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+            const float hs = strengths[combo];
+            if (hs < 0) {
+                continue;
+            }
+            const int bin = std::min(bins - 1, static_cast<int>(hs * static_cast<float>(bins)));
+            ++counts[static_cast<size_t>(combo) * bins + bin];
+            sums[combo] += hs;
+            squares[combo] += static_cast<double>(hs) * hs;
+            ++runouts[combo];
+        }
+    };
+
+    const std::vector<Card> deck = (CardSet::full() - CardSet(board)).toCards();
+    const int needed = 5 - __builtin_popcountll(board);
+    if (needed == 1) {
+        for (Card card: deck) {
+            accumulate(board | CardSet(card).getBits());
+        }
+    } else if (needed == 2) {
+        for (size_t i = 0; i < deck.size(); ++i) {
+            for (size_t j = i + 1; j < deck.size(); ++j) {
+                accumulate(board | CardSet(deck[i]).getBits() | CardSet(deck[j]).getBits());
+            }
+        }
+    } else {
+        throw std::invalid_argument("distribution needs a flop or a turn");
+    }
+    for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+        expected[combo] = runouts[combo] ? static_cast<float>(sums[combo] / runouts[combo]) : 0.0f;
+        expectedSquare[combo] = runouts[combo] ? static_cast<float>(squares[combo] / runouts[combo]) : 0.0f;
+    }
+}
+
+BucketMap BucketMap::build(int boardCards, const AbstractionConfig &config) {
+    if (boardCards != 3 && boardCards != 4) {
+        throw std::invalid_argument("bucket maps are built for the flop or the turn");
+    }
+    // 抽样点在调度器中按 int 下标切分
+    if (config.buckets < 1 || config.buckets >= NO_BUCKET || config.histogramBins < 2 ||
+        config.trainingSamples > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        throw std::invalid_argument("invalid abstraction config");
+    }
+    LookupEvaluator::initialize();
+    TaskScheduler scheduler(config.threads);
+    const int bins = config.histogramBins;
+
+    std::vector<WeightedCards> canonical = SuitIsomorphism::canonicalSets(boardCards);
+    std::sort(canonical.begin(), canonical.end(), [](const WeightedCards &a, const WeightedCards &b) {
+        return a.cards.getBits() < b.cards.getBits();
+    });
+
+    BucketMap map;
+    map.boardCards = boardCards;
+    map.boards.reserve(canonical.size());
+    for (const WeightedCards &board: canonical) {
+        map.boards.push_back(board.cards.getBits());
+    }
+
+    // 每副规范公共牌上每个组合的累积直方图，以及 E[HS] 和 E[HS²]
+    Features features;
+    features.dims = bins;
+    features.values.assign(canonical.size() * COMBO_COUNT * bins, 0);
+    map.expected.assign(canonical.size() * COMBO_COUNT, 0);
+    map.expectedSquare.assign(canonical.size() * COMBO_COUNT, 0);
+    parallelEach(scheduler, canonical.size(), 1, [&](size_t b) {
+        std::vector<uint32_t> counts(static_cast<size_t>(COMBO_COUNT) * bins);
+        float expected[COMBO_COUNT];
+        float expectedSquare[COMBO_COUNT];
+        HandStrength::distribution(map.boards[b], bins, counts.data(), expected, expectedSquare);
+        for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+            const uint32_t *histogram = counts.data() + static_cast<size_t>(combo) * bins;
+            const uint32_t total = std::accumulate(histogram, histogram + bins, 0u);
+            if (total == 0) {
+                continue;
+            }
+            map.expected[b * COMBO_COUNT + combo] = quantize(expected[combo]);
+            map.expectedSquare[b * COMBO_COUNT + combo] = quantize(expectedSquare[combo]);
+            uint8_t *point = features.values.data() + (b * COMBO_COUNT + combo) * bins;
+            uint32_t running = 0;
+            for (int d = 0; d < bins; ++d) {
+                running += histogram[d];
+                point[d] = static_cast<uint8_t>((running * 255u + total / 2) / total);
+            }
+        }
+    });
+
+    // 按公共牌重数抽样训练；每副公共牌上不冲突的组合数相同，先按重数选公共牌，再均匀选组合
+    std::vector<double> cumulativeWeight;
+    double totalWeight = 0;
+    for (const WeightedCards &board: canonical) {
+        totalWeight += board.multiplicity;
+        cumulativeWeight.push_back(totalWeight);
+    }
+    Xoshiro256 rng(config.seed);
+    std::vector<size_t> sample;
+    sample.reserve(config.trainingSamples);
+    while (sample.size() < config.trainingSamples) {
+        double target = static_cast<double>(rng() >> 11) * 0x1.0p-53 * totalWeight;
+        size_t b = std::upper_bound(cumulativeWeight.begin(), cumulativeWeight.end(), target) - cumulativeWeight.begin();
+        b = std::min(b, canonical.size() - 1);
+        const int combo = static_cast<int>(rng.bounded(COMBO_COUNT));
+        if ((COMBO_MASKS[combo] & map.boards[b]) == 0) {
+            sample.push_back(b * COMBO_COUNT + combo);
+        }
+    }
+    const int k = std::min<int>(config.buckets, static_cast<int>(sample.size()));
+    std::vector<float> centroids = trainCentroids(features, sample, k, config, scheduler);
+
+    // 桶按平均胜率升序编号：累积直方图越小，胜率越高
+    std::vector<int> order(k);
+    std::iota(order.begin(), order.end(), 0);
+    auto mass = [&](int c) {
+        return std::accumulate(centroids.begin() + static_cast<ptrdiff_t>(c) * bins,
+                               centroids.begin() + static_cast<ptrdiff_t>(c + 1) * bins, 0.0f);
+    };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return mass(a) > mass(b); });
+    std::vector<uint16_t> label(k);
+    for (int rank = 0; rank < k; ++rank) {
+        label[order[rank]] = static_cast<uint16_t>(rank);
+    }
+
+    map.bucketCount = k;
+    map.buckets.assign(canonical.size() * COMBO_COUNT, NO_BUCKET);
+    parallelEach(scheduler, canonical.size(), 16, [&](size_t b) {
+        for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+            if ((COMBO_MASKS[combo] & map.boards[b]) == 0) {
+                const size_t point = b * COMBO_COUNT + combo;
+                map.buckets[point] = label[nearest(features.point(point), centroids, k, bins)];
+            }
+        }
+    });
+    return map;
+}
+
+std::optional<size_t> BucketMap::pointIndex(CardSet hole, CardSet board) const {
+    if (board.size() != boardCards || hole.size() != 2 || hole.intersects(board)) {
+        return std::nullopt;
+    }
+    // 只按公共牌规范化，与 canonicalSets 选出的代表一致；手牌跟着同一个置换变换
+    const SuitPermutation permutation = SuitIsomorphism::canonicalPermutation({board});
+    const uint64_t canonicalBoard = SuitIsomorphism::apply(board, permutation).getBits();
+    auto found = std::lower_bound(boards.begin(), boards.end(), canonicalBoard);
+    if (found == boards.end() || *found != canonicalBoard) {
+        return std::nullopt;
+    }
+    const uint64_t canonicalHole = SuitIsomorphism::apply(hole, permutation).getBits();
+    const int combo = comboIndex(static_cast<CardIndex>(__builtin_ctzll(canonicalHole)),
+                                 static_cast<CardIndex>(63 - __builtin_clzll(canonicalHole)));
+    return static_cast<size_t>(found - boards.begin()) * COMBO_COUNT + combo;
+}
+
+uint16_t BucketMap::bucket(CardSet hole, CardSet board) const {
+    const std::optional<size_t> point = pointIndex(hole, board);
+    return point ? buckets[*point] : NO_BUCKET;
+}
+
+std::optional<StrengthMoments> BucketMap::moments(CardSet hole, CardSet board) const {
+    const std::optional<size_t> point = pointIndex(hole, board);
+    if (!point || expected.empty()) {
+        return std::nullopt;
+    }
+    return StrengthMoments{expected[*point] / 65535.0f, expectedSquare[*point] / 65535.0f};
+}
+
+size_t BucketMap::memoryBytes() const {
+    return boards.size() * sizeof(uint64_t) + (buckets.size() + expected.size() + expectedSquare.size()) * sizeof(uint16_t);
+}
+
+void BucketMap::save(const std::string &path) const {
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.boardCards = static_cast<uint32_t>(boardCards);
+    header.bucketCount = static_cast<uint32_t>(bucketCount);
+    header.boardCount = boards.size();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(boards.data()), static_cast<std::streamsize>(boards.size() * sizeof(uint64_t)));
+    out.write(reinterpret_cast<const char *>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(uint16_t)));
+    out.write(reinterpret_cast<const char *>(expected.data()), static_cast<std::streamsize>(expected.size() * sizeof(uint16_t)));
+    out.write(reinterpret_cast<const char *>(expectedSquare.data()),
+              static_cast<std::streamsize>(expectedSquare.size() * sizeof(uint16_t)));
+    if (!out) {
+        throw std::runtime_error("cannot write bucket map: " + path);
+    }
+}
+
+std::optional<BucketMap> BucketMap::load(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    FileHeader header{};
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version < 1 || header.version > VERSION ||
+        (header.boardCards != 3 && header.boardCards != 4) || header.boardCount > 1000000) {
+        return std::nullopt;
+    }
+    BucketMap map;
+    map.boardCards = static_cast<int>(header.boardCards);
+    map.bucketCount = static_cast<int>(header.bucketCount);
+    map.boards.resize(header.boardCount);
+    map.buckets.resize(header.boardCount * COMBO_COUNT);
+    if (!in.read(reinterpret_cast<char *>(map.boards.data()), static_cast<std::streamsize>(map.boards.size() * sizeof(uint64_t))) ||
+        !in.read(reinterpret_cast<char *>(map.buckets.data()), static_cast<std::streamsize>(map.buckets.size() * sizeof(uint16_t)))) {
+        return std::nullopt;
+    }
+    // 第 1 版只有桶表
+    if (header.version >= 2) {
+        map.expected.resize(map.buckets.size());
+        map.expectedSquare.resize(map.buckets.size());
+        if (!in.read(reinterpret_cast<char *>(map.expected.data()), static_cast<std::streamsize>(map.expected.size() * sizeof(uint16_t))) ||
+            !in.read(reinterpret_cast<char *>(map.expectedSquare.data()),
+                     static_cast<std::streamsize>(map.expectedSquare.size() * sizeof(uint16_t)))) {
+            return std::nullopt;
+        }
+    }
+    return map;
+}
@@ -0,0 +1,76 @@
+#ifndef ABSTRACTION_H
+#define ABSTRACTION_H
+
+#include "../Card/cardset.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct AbstractionConfig {
+    int buckets = 200;               // 聚类得到的桶数，最多 65535
+    int histogramBins = 16;          // 胜率分布直方图的区间数
+    int iterations = 20;             // k-means 迭代次数
+    size_t trainingSamples = 100000; // 训练聚类中心时按重数抽样的点数，分配桶时使用全部点
+    int threads = 0;                 // 0 表示使用全部核心
+    uint64_t seed = 0;
+};
+
+// 手牌强度特征
+// HS 为河牌上对一手随机牌的胜率（平局算一半）；翻牌和转牌上对所有后续发牌求 HS 的分布，
+// 得到直方图以及 E[HS]、E[HS²]。同一副河牌上所有组合的 HS 只需一次计数排序和一次扫描。
+class HandStrength {
+public:
+    // board 为 5 张公共牌；strengths[combo] 为该组合的 HS，与公共牌冲突的组合为 -1
+    static void river(uint64_t board, float *strengths);
+    // board 为 3 或 4 张公共牌；counts[combo * bins + b] 为 HS 落在第 b 个区间的发法数，
+    // expected 和 expectedSquare 为 E[HS] 和 E[HS²]；与公共牌冲突的组合全部为 0
+    static void distribution(uint64_t board, int bins, uint32_t *counts, float *expected, float *expectedSquare);
+};
+
+// 一手牌在一副公共牌上的 E[HS] 和 E[HS²]
+struct StrengthMoments {
+    float expected = 0;
+    float expectedSquare = 0;
+};
+
+// 翻牌或转牌的手牌抽象：(规范公共牌, 组合) -> 桶编号
+// 特征为 HS 分布的累积直方图，距离为一维 EMD（累积直方图的 L1 距离），用 k-means 聚类；
+// 桶按平均胜率从小到大编号。桶表为每副规范公共牌 1326 个 uint16，翻牌约 4.6MB，转牌约 44MB。
+// 同时保存每个点的 E[HS] 和 E[HS²]（各量化为 uint16），供需要势能特征的抽象使用，大小是桶表的两倍。
+class BucketMap {
+public:
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint16_t NO_BUCKET = 0xFFFF;
+
+    // boardCards 为 3（翻牌）或 4（转牌）
+    static BucketMap build(int boardCards, const AbstractionConfig &config = AbstractionConfig());
+    // 文件不存在或格式不对时返回空
+    static std::optional<BucketMap> load(const std::string &path);
+    // 写入失败时抛出 std::runtime_error
+    void save(const std::string &path) const;
+
+    // 任意手牌和公共牌所在的桶；公共牌张数不对或手牌与公共牌冲突时返回 NO_BUCKET
+    [[nodiscard]] uint16_t bucket(CardSet hole, CardSet board) const;
+    // 任意手牌和公共牌的 E[HS] 和 E[HS²]；不匹配或文件是不含这两项的第 1 版时返回空
+    [[nodiscard]] std::optional<StrengthMoments> moments(CardSet hole, CardSet board) const;
+
+    [[nodiscard]] int getBoardCards() const { return boardCards; }
+    [[nodiscard]] int getBucketCount() const { return bucketCount; }
+    [[nodiscard]] size_t getBoardCount() const { return boards.size(); }
+    [[nodiscard]] size_t memoryBytes() const;
+
+private:
+    int boardCards = 0;
+    int bucketCount = 0;
+    std::vector<uint64_t> boards;    // 规范公共牌的位掩码，升序
+    std::vector<uint16_t> buckets;   // boards.size() * COMBO_COUNT
+    std::vector<uint16_t> expected;        // 同 buckets 的布局，E[HS] × 65535；第 1 版文件为空
+    std::vector<uint16_t> expectedSquare;  // E[HS²] × 65535
+
+    // (规范公共牌, 组合) 在各数组中的下标，不匹配时返回空
+    [[nodiscard]] std::optional<size_t> pointIndex(CardSet hole, CardSet board) const;
+};
+
+#endif  // ABSTRACTION_H
@@ -0,0 +1,281 @@
+#include "../Deck/deck.h"
+#include "../pokerHand/evaluator.h"
+#include "../pokerHand/handevaluator.h"
+#include "../pokerHand/handstate.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../pokerHand/omahaevaluator.h"
+#include "../pokerHand/pokerhand.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <utility>
+#include <vector>
+
+// 手牌求值、发牌和比较路径的性能基准
+// 每个求值基准都用三种输入各跑一次：
+//   random  均匀随机的手牌
+//   worst   高牌：没有提前结束的分支，位运算求值器要比较全部五个踢脚
+//   skewed  同花及以上：走同花表和罕见牌型的分支
+// 运行 bench --benchmark_out=bench.json --benchmark_out_format=json 导出 JSON，
+// 或者直接构建 bench_json 目标。
+
+namespace {
+
+    enum InputKind {
+        RANDOM,
+        WORST_CASE,
+        SKEWED
+    };
+
+    constexpr int POOL_SIZE = 4096;  // 2 的幂，循环取用时用掩码代替取模
+    constexpr const char *INPUT_LABELS[] = {"random", "worst", "skewed"};
+
+    bool accepts(InputKind kind, CardSet cards) {
+        const HandType type = Evaluator::handType(Evaluator::evaluate(cards));
+        switch (kind) {
+            case WORST_CASE:
+                return type == HandType::HIGH_CARD;
+            case SKEWED:
+                return type >= HandType::FLUSH;
+            default:
+                return true;
+        }
+    }
+
+    // 一组 holeCount 张手牌加 boardCount 张公共牌的输入，种子固定，每次运行都相同
+    struct Deal {
+        CardSet hole;
+        CardSet board;
+        std::vector<Card> holeCards;
+        std::vector<Card> boardCards;
+    };
+
+    std::vector<Deal> makeDeals(InputKind kind, int holeCount, int boardCount) {
+        std::vector<Deal> deals;
+        deals.reserve(POOL_SIZE);
+        Deck deck(static_cast<uint64_t>(kind) * 1000 + holeCount * 10 + boardCount);
+        while (static_cast<int>(deals.size()) < POOL_SIZE) {
+            deck.reset();
+            Deal deal;
+            deal.hole = deck.deal(holeCount);
+            deal.board = deck.deal(boardCount);
+            if (!accepts(kind, deal.hole | deal.board)) {
+                continue;
+            }
+            deal.holeCards = deal.hole.toCards();
+            deal.boardCards = deal.board.toCards();
+            deals.push_back(std::move(deal));
+        }
+        return deals;
+    }
+
+    const std::vector<Deal> &pool(InputKind kind, int holeCount, int boardCount) {
+        static std::vector<Deal> pools[3][8][8];
+        std::vector<Deal> &deals = pools[kind][holeCount][boardCount];
+        if (deals.empty()) {
+            deals = makeDeals(kind, holeCount, boardCount);
+        }
+        return deals;
+    }
+
+    template<int N, size_t... I>
+    std::array<Card, N> toArray(const std::vector<Card> &cards, std::index_sequence<I...>) {
+        return {cards[I]...};
+    }
+
+    void setup(benchmark::State &state) {
+        LookupEvaluator::initialize();
+        state.SetLabel(INPUT_LABELS[state.range(0)]);
+    }
+
+}
+
+// 5 张牌的 PokerHand::getHandType
+static void BM_HandType5(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), 5, 0);
+    size_t i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(PokerHand(deals[i++ & (POOL_SIZE - 1)].holeCards).getHandType());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HandType5)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+// 7 张牌的 PokerHand::getBestHand（21 个五张牌组合）
+static void BM_BestHand7(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), 2, 5);
+    size_t i = 0;
+    for (auto _: state) {
+        const Deal &deal = deals[i++ & (POOL_SIZE - 1)];
+        benchmark::DoNotOptimize(PokerHand::getBestHand(deal.boardCards, deal.holeCards));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BestHand7)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+static void BM_BestHand7CardSet(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), 2, 5);
+    size_t i = 0;
+    for (auto _: state) {
+        const Deal &deal = deals[i++ & (POOL_SIZE - 1)];
+        benchmark::DoNotOptimize(PokerHand::getBestHand(deal.board, deal.hole));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BestHand7CardSet)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+// 两手 5 张牌的 PokerHand::compareHands
+static void BM_CompareHands(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), 5, 0);
+    size_t i = 0;
+    for (auto _: state) {
+        const Deal &first = deals[i & (POOL_SIZE - 1)];
+        const Deal &second = deals[(i + 1) & (POOL_SIZE - 1)];
+        ++i;
+        benchmark::DoNotOptimize(PokerHand::compareHands(first.holeCards, second.holeCards));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CompareHands)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+// 7 张牌直接求值，对比两种求值器
+static void BM_Evaluator7(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), 2, 5);
+    size_t i = 0;
+    for (auto _: state) {
+        const Deal &deal = deals[i++ & (POOL_SIZE - 1)];
+        benchmark::DoNotOptimize(Evaluator::evaluate(deal.hole | deal.board));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Evaluator7)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+static void BM_LookupEvaluator7(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), 2, 5);
+    size_t i = 0;
+    for (auto _: state) {
+        const Deal &deal = deals[i++ & (POOL_SIZE - 1)];
+        benchmark::DoNotOptimize(LookupEvaluator::evaluate(deal.hole | deal.board));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LookupEvaluator7)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+// 固定张数的 HandEvaluator，牌放在 std::array 中
+template<int N>
+static void BM_HandEvaluator(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), N - 5, 5);
+    std::vector<std::array<Card, N>> hands;
+    for (const Deal &deal: deals) {
+        std::vector<Card> cards = deal.holeCards;
+        cards.insert(cards.end(), deal.boardCards.begin(), deal.boardCards.end());
+        hands.push_back(toArray<N>(cards, std::make_index_sequence<N>()));
+    }
+    size_t i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(HandEvaluator<N>::evaluate(hands[i++ & (POOL_SIZE - 1)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_HandEvaluator, 5)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+BENCHMARK_TEMPLATE(BM_HandEvaluator, 6)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+BENCHMARK_TEMPLATE(BM_HandEvaluator, 7)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+// 奥马哈 4/5 张手牌，每手牌都重新构造公共牌的预计算（等价于每副公共牌只比较一手牌的最坏情况）
+template<int HOLE>
+static void BM_Omaha(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(RANDOM, HOLE, 5);
+    size_t i = 0;
+    for (auto _: state) {
+        const Deal &deal = deals[i++ & (POOL_SIZE - 1)];
+        benchmark::DoNotOptimize(OmahaEvaluator(deal.board).evaluate(deal.hole));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Omaha, 4)->Arg(RANDOM)->ArgName("input");
+BENCHMARK_TEMPLATE(BM_Omaha, 5)->Arg(RANDOM)->ArgName("input");
+
+// 对比：逐个组合求值的 OmahaEvaluator::bestHand（60/100 个五张牌组合）
+template<int HOLE>
+static void BM_OmahaBestHand(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(RANDOM, HOLE, 5);
+    size_t i = 0;
+    for (auto _: state) {
+        const Deal &deal = deals[i++ & (POOL_SIZE - 1)];
+        benchmark::DoNotOptimize(OmahaEvaluator(deal.board).bestHand(deal.hole));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_OmahaBestHand, 4)->Arg(RANDOM)->ArgName("input");
+BENCHMARK_TEMPLATE(BM_OmahaBestHand, 5)->Arg(RANDOM)->ArgName("input");
+
+// 手牌加转牌的状态已知，只加一张河牌再求值（枚举河牌时每个叶子的开销）
+static void BM_HandStateRiver(benchmark::State &state) {
+    setup(state);
+    const std::vector<Deal> &deals = pool(static_cast<InputKind>(state.range(0)), 2, 5);
+    std::vector<HandState> turns;
+    std::vector<Card> rivers;
+    for (const Deal &deal: deals) {
+        turns.push_back(HandState(deal.hole).add(deal.board - CardSet(deal.boardCards.back())));
+        rivers.push_back(deal.boardCards.back());
+    }
+    size_t i = 0;
+    for (auto _: state) {
+        const size_t k = i++ & (POOL_SIZE - 1);
+        benchmark::DoNotOptimize(turns[k].add(rivers[k]).evaluate());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HandStateRiver)->DenseRange(RANDOM, SKEWED)->ArgName("input");
+
+// 洗整副牌后发 9 张（单挑一手牌需要的张数）
+static void BM_DeckShuffleDeal(benchmark::State &state) {
+    Deck deck(1);
+    for (auto _: state) {
+        deck.reset();
+        deck.shuffle();
+        for (int i = 0; i < 9; ++i) {
+            benchmark::DoNotOptimize(deck.dealCard());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeckShuffleDeal);
+
+// 不洗牌，直接随机发 9 张
+static void BM_DeckDeal(benchmark::State &state) {
+    Deck deck(1);
+    for (auto _: state) {
+        deck.reset();
+        for (int i = 0; i < 9; ++i) {
+            benchmark::DoNotOptimize(deck.dealCard());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeckDeal);
+
+// 完整的单挑摊牌：发两手牌和五张公共牌，求值并比较
+static void BM_HeadsUpShowdown(benchmark::State &state) {
+    LookupEvaluator::initialize();
+    Deck deck(1);
+    for (auto _: state) {
+        deck.reset();
+        const CardSet hole1 = deck.deal(2);
+        const CardSet hole2 = deck.deal(2);
+        const CardSet board = deck.deal(5);
+        benchmark::DoNotOptimize(PokerHand::compareHands(hole1 | board, hole2 | board));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HeadsUpShowdown);
+
+BENCHMARK_MAIN();
@@ -1,61 +1,65 @@
 #include "card.h"
 
-Card::Card(Suit s, Rank r) : suit(s), rank(r) {}
+namespace {
 
-Rank Card::getRank() const {
-    return rank;
+    constexpr std::string_view SUIT_NAMES[] = {"Clubs", "Diamonds", "Hearts", "Spades"};
+    constexpr std::string_view RANK_NAMES[] = {"Ace", "2", "3", "4", "5", "6", "7", "8", "9", "10",
+                                               "Jack", "Queen", "King"};
+    constexpr char SUIT_CHARS[] = "cdhs";
+    constexpr char RANK_CHARS[] = "23456789TJQKA";
+
+}
+
+int charToRankStrength(char c) {
+    if (c >= 'a' && c <= 'z') {
+        c = static_cast<char>(c - 'a' + 'A');
+    }
+    for (int i = 0; i < RANK_COUNT; ++i) {
+        if (RANK_CHARS[i] == c) {
+            return i;
+        }
+    }
+    return -1;
 }
 
-Suit Card::getSuit() const {
-    return suit;
+char rankStrengthToChar(int strength) {
+    return strength >= 0 && strength < RANK_COUNT ? RANK_CHARS[strength] : '?';
 }
 
-std::string Card::getSuitString() const {
-    switch (suit) {
-        case Suit::CLUBS:
-            return "Clubs";
-        case Suit::DIAMONDS:
-            return "Diamonds";
-        case Suit::HEARTS:
-            return "Hearts";
-        case Suit::SPADES:
-            return "Spades";
-        default:
-            return "Unknown";
+std::string_view Card::getSuitString() const {
+    if (index >= CARD_COUNT) {
+        return "Unknown";
     }
+    return SUIT_NAMES[static_cast<int>(getSuit())];
 }
 
-std::string Card::getRankString() const {
-    switch (rank) {
-        case Rank::ACE:
-            return "Ace";
-        case Rank::TWO:
-            return "2";
-        case Rank::THREE:
-            return "3";
-        case Rank::FOUR:
-            return "4";
-        case Rank::FIVE:
-            return "5";
-        case Rank::SIX:
-            return "6";
-        case Rank::SEVEN:
-            return "7";
-        case Rank::EIGHT:
-            return "8";
-        case Rank::NINE:
-            return "9";
-        case Rank::TEN:
-            return "10";
-        case Rank::JACK:
-            return "Jack";
-        case Rank::QUEEN:
-            return "Queen";
-        case Rank::KING:
-            return "King";
-        default:
-            return "Unknown";
+std::string_view Card::getRankString() const {
+    if (index >= CARD_COUNT) {
+        return "Unknown";
     }
+    return RANK_NAMES[static_cast<int>(getRank())];
 }
 
+std::string Card::toShortString() const {
+    if (index >= CARD_COUNT) {
+        return "??";
+    }
+    return {RANK_CHARS[index % RANK_COUNT], SUIT_CHARS[index / RANK_COUNT]};
+}
 
+std::optional<Card> Card::fromString(std::string_view text) {
+    if (text.size() != 2) {
+        return std::nullopt;
+    }
+    int strength = charToRankStrength(text[0]);
+    int suit = -1;
+    for (int i = 0; i < SUIT_COUNT; ++i) {
+        if (SUIT_CHARS[i] == text[1] || SUIT_CHARS[i] == text[1] - 'A' + 'a') {
+            suit = i;
+        }
+    }
+    if (strength < 0 || suit < 0) {
+        return std::nullopt;
+    }
+    return Card(static_cast<CardIndex>(suit * RANK_COUNT + strength));
+}
@@ -1,9 +1,12 @@
 #ifndef CARD_H
 #define CARD_H
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 
-enum class Suit {
+enum class Suit : uint8_t {
     CLUBS,
     DIAMONDS,
     HEARTS,
@@ -11,7 +14,7 @@ enum class Suit {
     UNKNOWN
 };
 
-enum class Rank {
+enum class Rank : uint8_t {
     ACE,
     TWO,
     THREE,
@@ -28,19 +31,64 @@ enum class Rank {
     UNKNOWN
 };
 
+// 牌的紧凑编号：index = 花色 * 13 + 点数强度，点数强度 2 为 0，A 为 12
+// 编号同时也是 CardSet 和各评估器位掩码中的位置
+using CardIndex = uint8_t;
+
+constexpr int RANK_COUNT = 13;
+constexpr int SUIT_COUNT = 4;
+constexpr int CARD_COUNT = RANK_COUNT * SUIT_COUNT;
+
+// Rank 枚举中 A 排在最前面，点数强度把 A 换到最大
+constexpr int rankStrength(Rank rank) {
+    return rank == Rank::ACE ? 12 : static_cast<int>(rank) - 1;
+}
+
+constexpr Rank strengthToRank(int strength) {
+    return strength == 12 ? Rank::ACE : static_cast<Rank>(strength + 1);
+}
+
+constexpr CardIndex toCardIndex(Suit suit, Rank rank) {
+    return static_cast<CardIndex>(static_cast<int>(suit) * RANK_COUNT + rankStrength(rank));
+}
+
+constexpr Suit indexSuit(CardIndex index) {
+    return static_cast<Suit>(index / RANK_COUNT);
+}
+
+constexpr Rank indexRank(CardIndex index) {
+    return strengthToRank(index % RANK_COUNT);
+}
+
+// 点数字符 "23456789TJQKA" 与点数强度互相转换，字符无效时返回 -1
+int charToRankStrength(char c);
+char rankStrengthToChar(int strength);
+
+// 一张牌只占 1 个字节
 class Card {
 public:
-    Card(Suit s, Rank r);
+    constexpr Card(Suit s, Rank r) : index(toCardIndex(s, r)) {}
+    constexpr explicit Card(CardIndex i) : index(i) {}
+
+    // 解析两个字符的简写，例如 "As"、"td"，格式不对时返回空
+    static std::optional<Card> fromString(std::string_view text);
 
-    [[nodiscard]] std::string getSuitString() const;
-    [[nodiscard]] std::string getRankString() const;
+    [[nodiscard]] std::string_view getSuitString() const;
+    [[nodiscard]] std::string_view getRankString() const;
+    // 两个字符的简写，例如 "As"、"Td"
+    [[nodiscard]] std::string toShortString() const;
 
-    [[nodiscard]] Suit getSuit() const;
-    [[nodiscard]] Rank getRank() const;
+    [[nodiscard]] constexpr Suit getSuit() const { return indexSuit(index); }
+    [[nodiscard]] constexpr Rank getRank() const { return indexRank(index); }
+    [[nodiscard]] constexpr CardIndex getIndex() const { return index; }
+
+    constexpr bool operator==(const Card &other) const { return index == other.index; }
+    constexpr bool operator!=(const Card &other) const { return index != other.index; }
 
 private:
-    Suit suit;
-    Rank rank;
+    CardIndex index;
 };
 
+static_assert(sizeof(Card) == 1, "Card should be packed into one byte");
+
 #endif  // CARD_H
@@ -0,0 +1,125 @@
+#ifndef CARDSET_H
+#define CARDSET_H
+
+#include "card.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 用一个 64 位整数表示一组牌，第 i 位对应编号为 i 的牌
+class CardSet {
+public:
+    constexpr CardSet() : bits(0) {}
+    constexpr explicit CardSet(uint64_t mask) : bits(mask) {}
+    constexpr CardSet(Card card) : bits(1ull << card.getIndex()) {}
+
+    static CardSet fromCards(const std::vector<Card> &cards) {
+        CardSet set;
+        for (const Card &card: cards) {
+            set.add(card);
+        }
+        return set;
+    }
+
+    // 解析连续的简写，例如 "AsKd" 或 "As Kd Qc"，忽略空格和逗号；格式不对或有重复牌时返回空
+    static std::optional<CardSet> fromString(std::string_view text) {
+        CardSet set;
+        size_t i = 0;
+        while (i < text.size()) {
+            if (text[i] == ' ' || text[i] == ',') {
+                ++i;
+                continue;
+            }
+            std::optional<Card> card = Card::fromString(text.substr(i, 2));
+            if (!card || set.contains(*card)) {
+                return std::nullopt;
+            }
+            set.add(*card);
+            i += 2;
+        }
+        return set;
+    }
+
+    [[nodiscard]] std::string toString() const {
+        std::string text;
+        for (Card card: *this) {
+            text += card.toShortString();
+        }
+        return text;
+    }
+
+    static constexpr CardSet full() {
+        return CardSet((1ull << CARD_COUNT) - 1);
+    }
+
+    [[nodiscard]] constexpr uint64_t getBits() const { return bits; }
+    [[nodiscard]] constexpr bool empty() const { return bits == 0; }
+    [[nodiscard]] constexpr int size() const { return __builtin_popcountll(bits); }
+    [[nodiscard]] constexpr bool contains(Card card) const { return (bits >> card.getIndex()) & 1; }
+    [[nodiscard]] constexpr bool intersects(CardSet other) const { return (bits & other.bits) != 0; }
+
+    constexpr void add(Card card) { bits |= 1ull << card.getIndex(); }
+    constexpr void remove(Card card) { bits &= ~(1ull << card.getIndex()); }
+
+    // 某一花色的 13 位点数掩码
+    [[nodiscard]] constexpr uint32_t suitRanks(Suit suit) const {
+        return static_cast<uint32_t>(bits >> (static_cast<int>(suit) * RANK_COUNT)) & ((1u << RANK_COUNT) - 1);
+    }
+
+    // 编号最小的一张牌，集合不能为空
+    [[nodiscard]] constexpr Card first() const {
+        return Card(static_cast<CardIndex>(__builtin_ctzll(bits)));
+    }
+
+    [[nodiscard]] std::vector<Card> toCards() const {
+        std::vector<Card> cards;
+        cards.reserve(size());
+        for (Card card: *this) {
+            cards.push_back(card);
+        }
+        return cards;
+    }
+
+    constexpr CardSet operator|(CardSet other) const { return CardSet(bits | other.bits); }
+    constexpr CardSet operator&(CardSet other) const { return CardSet(bits & other.bits); }
+    constexpr CardSet operator-(CardSet other) const { return CardSet(bits & ~other.bits); }
+    constexpr CardSet &operator|=(CardSet other) {
+        bits |= other.bits;
+        return *this;
+    }
+    constexpr CardSet &operator&=(CardSet other) {
+        bits &= other.bits;
+        return *this;
+    }
+    constexpr CardSet &operator-=(CardSet other) {
+        bits &= ~other.bits;
+        return *this;
+    }
+    constexpr bool operator==(CardSet other) const { return bits == other.bits; }
+    constexpr bool operator!=(CardSet other) const { return bits != other.bits; }
+
+    // 按编号从小到大遍历集合中的牌
+    class Iterator {
+    public:
+        constexpr explicit Iterator(uint64_t remaining) : remaining(remaining) {}
+        constexpr Card operator*() const { return Card(static_cast<CardIndex>(__builtin_ctzll(remaining))); }
+        constexpr Iterator &operator++() {
+            remaining &= remaining - 1;
+            return *this;
+        }
+        constexpr bool operator!=(const Iterator &other) const { return remaining != other.remaining; }
+
+    private:
+        uint64_t remaining;
+    };
+
+    [[nodiscard]] constexpr Iterator begin() const { return Iterator(bits); }
+    [[nodiscard]] constexpr Iterator end() const { return Iterator(0); }
+
+private:
+    uint64_t bits;
+};
+
+#endif  // CARDSET_H
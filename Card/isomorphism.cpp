@@ -0,0 +1,137 @@
+#include "isomorphism.h"
+#include <algorithm>
+
+namespace {
+
+    constexpr int FACTORIAL[SUIT_COUNT + 1] = {1, 1, 2, 6, 24};
+
+    // 按轮次依次比较两种花色的点数掩码，返回负数、0、正数
+    int compareSuits(const std::vector<CardSet> &rounds, int a, int b) {
+        for (const CardSet &round: rounds) {
+            uint32_t left = round.suitRanks(static_cast<Suit>(a));
+            uint32_t right = round.suitRanks(static_cast<Suit>(b));
+            if (left != right) {
+                return left < right ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+}
+
+SuitSymmetry::SuitSymmetry() : SuitSymmetry(std::vector<CardSet>()) {}
+
+SuitSymmetry::SuitSymmetry(const std::vector<CardSet> &fixedRounds) : SuitSymmetry(fixedRounds, {}) {}
+
+SuitSymmetry::SuitSymmetry(const std::vector<CardSet> &fixedRounds, const std::array<uint8_t, SUIT_COUNT> &labels) {
+    int classOf[SUIT_COUNT];
+    for (int suit = 0; suit < SUIT_COUNT; ++suit) {
+        classOf[suit] = -1;
+        for (int earlier = 0; earlier < suit; ++earlier) {
+            if (labels[earlier] == labels[suit] && compareSuits(fixedRounds, earlier, suit) == 0) {
+                classOf[suit] = classOf[earlier];
+                break;
+            }
+        }
+        if (classOf[suit] < 0) {
+            classOf[suit] = classCount++;
+        }
+        members[classOf[suit]][classSize[classOf[suit]]++] = static_cast<uint8_t>(suit);
+    }
+    for (int c = 0; c < classCount; ++c) {
+        groupOrder *= FACTORIAL[classSize[c]];
+    }
+}
+
+int SuitSymmetry::weight(CardSet cards) const {
+    if (groupOrder == 1) {
+        return 1;
+    }
+    int weight = 1;
+    for (int c = 0; c < classCount; ++c) {
+        const int size = classSize[c];
+        if (size == 1) {
+            continue;
+        }
+        weight *= FACTORIAL[size];
+        int run = 1;
+        uint32_t previous = cards.suitRanks(static_cast<Suit>(members[c][0]));
+        for (int i = 1; i < size; ++i) {
+            uint32_t ranks = cards.suitRanks(static_cast<Suit>(members[c][i]));
+            if (ranks > previous) {
+                return 0;
+            }
+            run = ranks == previous ? run + 1 : 1;
+            // 相同掩码的花色互换不产生新情形
+            weight /= run;
+            previous = ranks;
+        }
+    }
+    return weight;
+}
+
+Card SuitIsomorphism::apply(Card card, const SuitPermutation &permutation) {
+    const int suit = card.getIndex() / RANK_COUNT;
+    return Card(static_cast<CardIndex>(permutation[suit] * RANK_COUNT + card.getIndex() % RANK_COUNT));
+}
+
+CardSet SuitIsomorphism::apply(CardSet cards, const SuitPermutation &permutation) {
+    uint64_t bits = 0;
+    for (int suit = 0; suit < SUIT_COUNT; ++suit) {
+        bits |= static_cast<uint64_t>(cards.suitRanks(static_cast<Suit>(suit))) << (permutation[suit] * RANK_COUNT);
+    }
+    return CardSet(bits);
+}
+
+SuitPermutation SuitIsomorphism::canonicalPermutation(const std::vector<CardSet> &rounds) {
+    std::array<int, SUIT_COUNT> suits = {0, 1, 2, 3};
+    std::stable_sort(suits.begin(), suits.end(), [&](int a, int b) { return compareSuits(rounds, a, b) > 0; });
+    SuitPermutation permutation{};
+    for (int i = 0; i < SUIT_COUNT; ++i) {
+        permutation[suits[i]] = static_cast<uint8_t>(i);
+    }
+    return permutation;
+}
+
+int SuitIsomorphism::multiplicity(const std::vector<CardSet> &rounds) {
+    return FACTORIAL[SUIT_COUNT] / SuitSymmetry(rounds).order();
+}
+
+CanonicalHand SuitIsomorphism::canonicalize(CardSet hole, CardSet board) {
+    CanonicalHand canonical;
+    const std::vector<CardSet> rounds = {hole, board};
+    canonical.permutation = canonicalPermutation(rounds);
+    canonical.hole = apply(hole, canonical.permutation);
+    canonical.board = apply(board, canonical.permutation);
+    canonical.multiplicity = multiplicity(rounds);
+    return canonical;
+}
+
+WeightedCards SuitIsomorphism::canonicalize(CardSet cards) {
+    const std::vector<CardSet> rounds = {cards};
+    return {apply(cards, canonicalPermutation(rounds)), multiplicity(rounds)};
+}
+
+std::vector<WeightedCards> SuitIsomorphism::canonicalSets(int count, const SuitSymmetry &symmetry, CardSet dead) {
+    std::vector<WeightedCards> sets;
+    std::vector<Card> deck = (CardSet::full() - dead).toCards();
+    auto walk = [&](auto &&self, size_t start, int depth, CardSet prefix) -> void {
+        if (depth == count) {
+            if (int weight = symmetry.weight(prefix)) {
+                sets.push_back({prefix, weight});
+            }
+            return;
+        }
+        for (size_t i = start; i + (count - depth) <= deck.size(); ++i) {
+            self(self, i + 1, depth + 1, prefix | CardSet(deck[i]));
+        }
+    };
+    if (count >= 0 && count <= static_cast<int>(deck.size())) {
+        walk(walk, 0, 0, CardSet());
+    }
+    return sets;
+}
+
+std::vector<WeightedCards> SuitIsomorphism::canonicalHoleCards() {
+    return canonicalSets(2);
+}
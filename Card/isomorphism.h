@@ -0,0 +1,73 @@
+#ifndef ISOMORPHISM_H
+#define ISOMORPHISM_H
+
+#include "cardset.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// 花色置换：permutation[s] 是花色 s 被映射到的花色
+using SuitPermutation = std::array<uint8_t, SUIT_COUNT>;
+
+// 一组牌及与它同构（只差一个花色置换）的不同情形个数
+struct WeightedCards {
+    CardSet cards;
+    int multiplicity = 1;
+};
+
+// 手牌 + 公共牌的规范形式
+struct CanonicalHand {
+    CardSet hole;
+    CardSet board;
+    SuitPermutation permutation{};  // 原花色到规范花色
+    int multiplicity = 1;
+};
+
+// 固定若干轮牌之后仍然无法区分的花色构成的对称群
+// 例如固定 AsAd 对 KsKd 后，黑桃与方块可以互换，红桃与梅花可以互换。
+// 对之后发出的牌，只有每组可互换花色内的点数掩码按花色编号不增的那一种是规范代表，
+// 它的权重就是同一轨道里不同发法的个数；其余发法的权重为 0，可以直接跳过。
+class SuitSymmetry {
+public:
+    // 没有固定的牌，四种花色全部可以互换
+    SuitSymmetry();
+    // 按顺序固定的若干轮牌（例如英雄手牌、每个对手的手牌、公共牌），每轮之间相互区分
+    explicit SuitSymmetry(const std::vector<CardSet> &fixedRounds);
+    // 另外只允许 labels 相同的花色互换，用于牌以外的信息区分了花色的情形（例如对花色不对称的范围）
+    SuitSymmetry(const std::vector<CardSet> &fixedRounds, const std::array<uint8_t, SUIT_COUNT> &labels);
+
+    // 群的阶，1 表示没有对称性
+    [[nodiscard]] int order() const { return groupOrder; }
+    // cards 是规范代表时返回它所在轨道的大小，否则返回 0
+    // cards 中可以包含固定的牌，它们在可互换的花色之间完全相同，不影响结果
+    [[nodiscard]] int weight(CardSet cards) const;
+
+private:
+    int classCount = 0;
+    int groupOrder = 1;
+    std::array<uint8_t, SUIT_COUNT> classSize{};
+    std::array<std::array<uint8_t, SUIT_COUNT>, SUIT_COUNT> members{};  // 每组内按花色编号升序
+};
+
+class SuitIsomorphism {
+public:
+    static Card apply(Card card, const SuitPermutation &permutation);
+    static CardSet apply(CardSet cards, const SuitPermutation &permutation);
+
+    // 使若干轮牌变为规范形式的花色置换：按 (第 1 轮掩码, 第 2 轮掩码, ...) 从大到小给花色重新编号
+    static SuitPermutation canonicalPermutation(const std::vector<CardSet> &rounds);
+    // 与这几轮牌同构的不同情形个数
+    static int multiplicity(const std::vector<CardSet> &rounds);
+
+    // 手牌与公共牌一起规范化，手牌优先决定花色顺序
+    static CanonicalHand canonicalize(CardSet hole, CardSet board);
+    static WeightedCards canonicalize(CardSet cards);
+
+    // 全部 count 张牌组合的规范代表，按字典序；3 张公共牌有 1755 个，重数之和为 22100
+    static std::vector<WeightedCards> canonicalSets(int count, const SuitSymmetry &symmetry = SuitSymmetry(),
+                                                    CardSet dead = CardSet());
+    // 169 种起手牌，重数分别为 6（对子）、4（同花）、12（不同花）
+    static std::vector<WeightedCards> canonicalHoleCards();
+};
+
+#endif  // ISOMORPHISM_H
@@ -0,0 +1,157 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// 读多写少的并发缓存，按键的哈希分成若干片，每片容量固定
+// 淘汰用 CLOCK 近似 LRU：命中只在读锁下设置一个原子的访问标记，不移动链表，
+// 并发的命中互不阻塞；只有插入新值时才加写锁，指针转过一圈仍未被访问的项被淘汰。
+// getOrCompute() 把同一个键的并发计算合并为一次，其余线程等待它的结果。
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;     // 由本线程计算的次数
+        uint64_t coalesced = 0;  // 等待其他线程正在进行的同一个计算的次数
+    };
+
+    explicit LruCache(size_t capacity, int shardCount = 16) {
+        shardCount = std::max(1, shardCount);
+        const size_t perShard = std::max<size_t>(1, (capacity + shardCount - 1) / shardCount);
+        for (int i = 0; i < shardCount; ++i) {
+            shards.push_back(std::make_unique<Shard>(perShard));
+        }
+    }
+
+    std::optional<Value> find(const Key &key) const {
+        const Shard &shard = shardOf(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.index.find(key);
+        if (found == shard.index.end()) {
+            return std::nullopt;
+        }
+        Slot &slot = shard.slots[found->second];
+        slot.referenced.store(true, std::memory_order_relaxed);
+        return slot.value;
+    }
+
+    // 命中时返回缓存的值；否则由一个线程调用 compute() 并写入缓存，compute() 抛出的异常传给所有等待者
+    template<typename Compute>
+    Value getOrCompute(const Key &key, Compute &&compute) {
+        if (std::optional<Value> cached = find(key)) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return std::move(*cached);
+        }
+        Shard &shard = shardOf(key);
+        std::promise<Value> promise;
+        {
+            std::unique_lock<std::mutex> lock(shard.pendingMutex);
+            auto running = shard.pending.find(key);
+            if (running != shard.pending.end()) {
+                std::shared_future<Value> result = running->second;
+                lock.unlock();
+                coalesced.fetch_add(1, std::memory_order_relaxed);
+                return result.get();
+            }
+            // 计算方先写入缓存再移除 pending，所以这里没找到 pending 时需要再查一次缓存
+            if (std::optional<Value> cached = find(key)) {
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return std::move(*cached);
+            }
+            shard.pending.emplace(key, promise.get_future().share());
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        try {
+            Value value = compute();
+            insert(shard, key, value);
+            finish(shard, key);
+            promise.set_value(value);
+            return value;
+        } catch (...) {
+            finish(shard, key);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    [[nodiscard]] Stats stats() const {
+        return {hits.load(std::memory_order_relaxed), misses.load(std::memory_order_relaxed),
+                coalesced.load(std::memory_order_relaxed)};
+    }
+
+private:
+    struct Slot {
+        Key key;
+        Value value;
+        std::atomic<bool> referenced{false};
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, size_t, Hash> index;
+        std::unique_ptr<Slot[]> slots;
+        size_t capacity;
+        size_t used = 0;
+        size_t hand = 0;  // CLOCK 指针
+        std::mutex pendingMutex;
+        std::unordered_map<Key, std::shared_future<Value>, Hash> pending;
+
+        explicit Shard(size_t capacity) : slots(new Slot[capacity]), capacity(capacity) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    Hash hash;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> coalesced{0};
+
+    Shard &shardOf(const Key &key) const {
+        // 高位决定分片，低位留给分片内的哈希表
+        const uint64_t mixed = static_cast<uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ull;
+        return *shards[(mixed >> 32) % shards.size()];
+    }
+
+    void insert(Shard &shard, const Key &key, const Value &value) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            shard.slots[found->second].value = value;
+            return;
+        }
+        size_t victim;
+        if (shard.used < shard.capacity) {
+            victim = shard.used++;
+        } else {
+            while (shard.slots[shard.hand].referenced.exchange(false, std::memory_order_relaxed)) {
+                shard.hand = (shard.hand + 1) % shard.capacity;
+            }
+            victim = shard.hand;
+            shard.hand = (shard.hand + 1) % shard.capacity;
+            shard.index.erase(shard.slots[victim].key);
+        }
+        Slot &slot = shard.slots[victim];
+        slot.key = key;
+        slot.value = value;
+        slot.referenced.store(false, std::memory_order_relaxed);
+        shard.index.emplace(key, victim);
+    }
+
+    void finish(Shard &shard, const Key &key) {
+        std::lock_guard<std::mutex> lock(shard.pendingMutex);
+        shard.pending.erase(key);
+    }
+};
+
+#endif  // LRUCACHE_H
@@ -0,0 +1,160 @@
+#include "scheduler.h"
+#include "threads.h"
+#include <cstdint>
+
+namespace {
+
+    // 当前线程所属的调度器和它在其中的队列编号
+    thread_local const TaskScheduler *ownerScheduler = nullptr;
+    thread_local int ownerSlot = 0;
+    thread_local uint32_t victimSeed = 0x9E3779B9u;
+
+}
+
+struct alignas(64) TaskScheduler::Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+TaskScheduler::TaskScheduler(int threads) : threadCount(resolveThreadCount(threads)) {
+    for (int i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (int slot = 1; slot < threadCount; ++slot) {
+        workers.emplace_back([this, slot]() { workerLoop(slot); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+}
+
+int TaskScheduler::currentSlot() const {
+    return ownerScheduler == this ? ownerSlot : 0;
+}
+
+void TaskScheduler::push(Task task) {
+    Queue &queue = *queues[currentSlot()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    // 睡眠的线程先增加 sleeping 再检查 queued，两边都是顺序一致的原子操作，不会丢失唤醒
+    if (sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+bool TaskScheduler::runOne() {
+    const int slot = currentSlot();
+    Task task;
+    bool found = false;
+    {
+        Queue &own = *queues[slot];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    if (!found) {
+        // 从随机位置开始依次尝试偷别人队列头部的任务
+        victimSeed ^= victimSeed << 13;
+        victimSeed ^= victimSeed >> 17;
+        victimSeed ^= victimSeed << 5;
+        const int start = static_cast<int>(victimSeed % static_cast<uint32_t>(threadCount));
+        for (int i = 0; i < threadCount && !found; ++i) {
+            const int victim = (start + i) % threadCount;
+            if (victim == slot) {
+                continue;
+            }
+            Queue &queue = *queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                found = true;
+            }
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    queued.fetch_sub(1);
+    std::exception_ptr error;
+    try {
+        task.function();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    task.group->finish(error);
+    return true;
+}
+
+void TaskScheduler::workerLoop(int slot) {
+    ownerScheduler = this;
+    ownerSlot = slot;
+    victimSeed = 0x9E3779B9u * static_cast<uint32_t>(slot + 1);
+    while (true) {
+        if (runOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.fetch_add(1);
+        wake.wait(lock, [&]() { return stopping || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+TaskScheduler::TaskGroup::~TaskGroup() {
+    // 析构时不能留下还在引用本组的任务；异常已经没有人接收，只能丢弃
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!scheduler.runOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::TaskGroup::run(std::function<void()> function) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    scheduler.push({std::move(function), this});
+}
+
+void TaskScheduler::TaskGroup::wait() {
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!scheduler.runOne()) {
+            std::this_thread::yield();
+        }
+    }
+    std::exception_ptr thrown;
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        std::swap(thrown, error);
+    }
+    if (thrown) {
+        std::rethrow_exception(thrown);
+    }
+}
+
+void TaskScheduler::TaskGroup::finish(std::exception_ptr thrown) {
+    if (thrown) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+            error = thrown;
+        }
+    }
+    pending.fetch_sub(1, std::memory_order_release);
+}
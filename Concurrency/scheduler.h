@@ -0,0 +1,98 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取的任务调度器
+// 每个线程有自己的双端队列：自己从尾部取（后进先出，刚派生的子任务数据还在缓存里），
+// 空闲线程从别人的头部偷（先进先出，偷到的是更大的任务）。线程在构造时创建，之后反复使用。
+// 调用线程本身也算一个线程：TaskGroup::wait() 在等待期间执行队列中的任务，
+// 所以任务中可以再派生任务并等待（递归的分治），不会死锁。
+class TaskScheduler {
+public:
+    class TaskGroup;
+
+    // threads 为包括调用线程在内的线程数，0 表示使用全部核心
+    explicit TaskScheduler(int threads = 0);
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+    ~TaskScheduler();
+
+    [[nodiscard]] int getThreadCount() const { return threadCount; }
+
+    // 把 [0, count) 按 grain 切块并行执行 body(begin, end)，全部完成后返回
+    template<typename Body>
+    void parallelFor(int count, int grain, Body &&body);
+
+private:
+    struct Task {
+        std::function<void()> function;
+        TaskGroup *group = nullptr;
+    };
+    struct Queue;
+
+    void push(Task task);
+    // 取一个任务执行；没有任务时返回 false
+    bool runOne();
+    [[nodiscard]] int currentSlot() const;
+    void workerLoop(int slot);
+
+    int threadCount;
+    std::vector<std::unique_ptr<Queue>> queues;  // 第 0 个给不属于本调度器的调用线程
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{0};
+    std::atomic<int> sleeping{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+// 一组任务，wait() 返回时组内任务全部完成；任务抛出的第一个异常在 wait() 中重新抛出
+class TaskScheduler::TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler &scheduler) : scheduler(scheduler) {}
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+    ~TaskGroup();
+
+    void run(std::function<void()> function);
+    void wait();
+
+private:
+    friend class TaskScheduler;
+
+    void finish(std::exception_ptr error);
+
+    TaskScheduler &scheduler;
+    std::atomic<int> pending{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+template<typename Body>
+void TaskScheduler::parallelFor(int count, int grain, Body &&body) {
+    grain = std::max(1, grain);
+    if (threadCount == 1 || count <= grain) {
+        if (count > 0) {
+            body(0, count);
+        }
+        return;
+    }
+    TaskGroup group(*this);
+    for (int begin = grain; begin < count; begin += grain) {
+        group.run([&body, begin, grain, count]() { body(begin, std::min(count, begin + grain)); });
+    }
+    body(0, grain);
+    group.wait();
+}
+
+#endif  // SCHEDULER_H
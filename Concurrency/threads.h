@@ -0,0 +1,13 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <algorithm>
+#include <thread>
+
+// 线程数选项的统一解释：大于 0 时原样使用，否则使用全部核心；结果至少为 1
+inline int resolveThreadCount(int threads) {
+    const int count = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, count);
+}
+
+#endif  // THREADS_H
@@ -1,33 +1,57 @@
 #include "deck.h"
-#include <algorithm>
-#include <chrono>
+#include <random>
 
-Deck::Deck() {
+template<typename Generator>
+BasicDeck<Generator>::BasicDeck() : generator(static_cast<uint64_t>(std::random_device()()) << 32 | std::random_device()()) {
+    fill();
+}
+
+template<typename Generator>
+BasicDeck<Generator>::BasicDeck(uint64_t seed) : generator(seed) {
+    fill();
+}
+
+template<typename Generator>
+BasicDeck<Generator>::BasicDeck(const Generator &generator) : generator(generator) {
+    fill();
+}
+
+template<typename Generator>
+void BasicDeck<Generator>::fill() {
     // 初始化一副完整的扑克牌
-    for (int suit = static_cast<int>(Suit::CLUBS); suit <= static_cast<int>(Suit::SPADES); ++suit) {
-        for (int rank = static_cast<int>(Rank::ACE); rank <= static_cast<int>(Rank::KING); ++rank) {
-            cards.emplace_back(static_cast<Suit>(suit), static_cast<Rank>(rank));
-        }
+    for (int i = 0; i < CARD_COUNT; ++i) {
+        cards[i] = static_cast<CardIndex>(i);
     }
+}
 
-    // 使用当前时间作为种子值初始化随机数引擎
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    randomEngine = std::default_random_engine(seed);
+template<typename Generator>
+void BasicDeck<Generator>::remove(CardSet dead) {
+    // 换到剩余部分的末尾，整副牌始终是 52 张牌的一个排列
+    for (int i = 0; i < count;) {
+        if (dead.contains(Card(cards[i]))) {
+            std::swap(cards[i], cards[--count]);
+        } else {
+            ++i;
+        }
+    }
 }
 
-void Deck::shuffle() {
+template<typename Generator>
+void BasicDeck<Generator>::shuffle() {
     //洗牌
-    std::shuffle(cards.begin(), cards.end(), randomEngine);
+    for (int i = count - 1; i > 0; --i) {
+        std::swap(cards[i], cards[generator.bounded(static_cast<uint32_t>(i + 1))]);
+    }
 }
 
-Card Deck::dealCard() {
-    //发牌
-    Card card = cards.back();
-    cards.pop_back();
-    return card;
+template<typename Generator>
+CardSet BasicDeck<Generator>::getRemaining() const {
+    CardSet remaining;
+    for (int i = 0; i < count; ++i) {
+        remaining.add(Card(cards[i]));
+    }
+    return remaining;
 }
 
-int Deck::getNumCards() const {
-    //返回牌堆数量
-    return cards.size();
-}
+template class BasicDeck<Xoshiro256>;
+template class BasicDeck<Pcg32>;
@@ -2,19 +2,68 @@
 #define DECK_H
 
 #include "../Card/card.h"
-#include <vector>
-#include <random>
+#include "../Card/cardset.h"
+#include "../Random/rng.h"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
 
-class Deck {
+// 一副牌，随机数生成器可以替换（需要提供 bounded() 和 jump()）
+// 剩余的牌放在数组前 count 个位置，发牌时从中随机选一张换到末尾（部分 Fisher–Yates），
+// 所以发 k 张牌只需要 k 次随机数；发出和去掉的牌仍留在数组尾部，reset() 不需要重新分配或填充。
+template<typename Generator = Xoshiro256>
+class BasicDeck {
 public:
-    Deck();
+    // 用随机设备生成种子，每次运行结果不同
+    BasicDeck();
+    // 固定种子，结果可复现
+    explicit BasicDeck(uint64_t seed);
+    explicit BasicDeck(const Generator &generator);
+
+    // 把所有发出和去掉的牌放回牌堆
+    void reset() { count = CARD_COUNT; }
+    // 从牌堆中去掉已知的牌，例如已经亮出的手牌或公共牌
+    void remove(CardSet dead);
+    // 打乱剩余的牌；发牌本身已经是随机的，只有需要按顺序查看剩余牌时才需要洗牌
     void shuffle();
-    Card dealCard();
-    [[nodiscard]] int getNumCards() const;
+
+    // 从剩余的牌中随机发一张，牌堆为空时抛出 std::out_of_range
+    Card dealCard() {
+        if (count == 0) {
+            throw std::out_of_range("deck is empty");
+        }
+        const uint32_t chosen = generator.bounded(static_cast<uint32_t>(count));
+        std::swap(cards[chosen], cards[count - 1]);
+        return Card(cards[--count]);
+    }
+
+    // 随机发 k 张牌
+    CardSet deal(int k) {
+        CardSet dealt;
+        for (int i = 0; i < k; ++i) {
+            dealt.add(dealCard());
+        }
+        return dealt;
+    }
+
+    [[nodiscard]] int getNumCards() const { return count; }
+    // 牌堆中剩余的牌
+    [[nodiscard]] CardSet getRemaining() const;
+    // 多线程时每个线程用 jump() 分出独立的随机数流
+    Generator &getGenerator() { return generator; }
 
 private:
-    std::vector<Card> cards;
-    std::default_random_engine randomEngine;
+    std::array<CardIndex, CARD_COUNT> cards{};
+    int count = CARD_COUNT;
+    Generator generator;
+
+    void fill();
 };
 
+using Deck = BasicDeck<>;
+
+extern template class BasicDeck<Xoshiro256>;
+extern template class BasicDeck<Pcg32>;
+
 #endif  // DECK_H
@@ -0,0 +1,308 @@
+#include "equity.h"
+#include "../Card/isomorphism.h"
+#include "../Concurrency/threads.h"
+#include "../pokerHand/handstate.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../Random/rng.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+    // 平局时的底池份额用整数表示，1~10 人平分都能整除
+    constexpr uint64_t SHARE_SCALE = 2520;
+    constexpr uint64_t BATCH_SIZE = 1024;
+
+    // 所有线程共享的累加结果，只用原子加法更新
+    struct SharedTotals {
+        std::atomic<uint64_t> claimed{0};
+        std::atomic<uint64_t> trials{0};
+        std::atomic<uint64_t> wins{0};
+        std::atomic<uint64_t> ties{0};
+        std::atomic<uint64_t> shares{0};
+        std::atomic<uint64_t> shareSquares{0};
+        std::atomic<bool> done{false};
+    };
+
+    double standardError(uint64_t trials, uint64_t shares, uint64_t shareSquares) {
+        if (trials < 2) {
+            return 1.0;
+        }
+        double n = static_cast<double>(trials);
+        double mean = static_cast<double>(shares) / SHARE_SCALE / n;
+        double meanSquare = static_cast<double>(shareSquares) / SHARE_SCALE / SHARE_SCALE / n;
+        return std::sqrt(std::max(0.0, meanSquare - mean * mean) / n);
+    }
+
+}
+
+EquityCalculator::EquityCalculator(CardSet hero, CardSet board) : hero(hero), board(board) {
+    if (hero.size() != 2 || board.size() > 5 || hero.intersects(board)) {
+        throw std::invalid_argument("hero needs two cards not on a board of at most five");
+    }
+}
+
+void EquityCalculator::addOpponent(CardSet hand) {
+    if (hand.size() != 2 || hand.intersects(getDeadCards())) {
+        throw std::invalid_argument("opponent needs two unseen cards");
+    }
+    if (getOpponentCount() >= MAX_OPPONENTS) {
+        throw std::invalid_argument("too many opponents");
+    }
+    opponents.push_back(hand);
+}
+
+void EquityCalculator::addRandomOpponents(int count) {
+    if (count < 0 || getOpponentCount() + count > MAX_OPPONENTS) {
+        throw std::invalid_argument("too many opponents");
+    }
+    randomOpponents += count;
+}
+
+int EquityCalculator::getOpponentCount() const {
+    return static_cast<int>(opponents.size()) + randomOpponents;
+}
+
+CardSet EquityCalculator::getDeadCards() const {
+    CardSet dead = hero | board;
+    for (CardSet hand: opponents) {
+        dead |= hand;
+    }
+    return dead;
+}
+
+EquityResult EquityCalculator::monteCarlo(const EquityConfig &config) const {
+    if (getOpponentCount() == 0) {
+        throw std::invalid_argument("no opponents");
+    }
+    LookupEvaluator::initialize();
+
+    // 剩余的牌，每个线程复制一份在上面做部分洗牌
+    CardIndex remaining[CARD_COUNT];
+    int remainingCount = 0;
+    for (Card card: CardSet::full() - getDeadCards()) {
+        remaining[remainingCount++] = card.getIndex();
+    }
+    const int boardNeeded = 5 - board.size();
+    const int needed = boardNeeded + 2 * randomOpponents;
+
+    const int threadCount = resolveThreadCount(config.threads);
+
+    SharedTotals totals;
+    auto worker = [&](int threadIndex) {
+        // 同一个种子跳跃不同次数，得到互不重叠的随机数流
+        Xoshiro256 rng(config.seed);
+        for (int i = 0; i < threadIndex; ++i) {
+            rng.jump();
+        }
+        CardIndex deck[CARD_COUNT];
+        std::copy(remaining, remaining + remainingCount, deck);
+
+        while (!totals.done.load(std::memory_order_relaxed)) {
+            uint64_t start = totals.claimed.fetch_add(BATCH_SIZE, std::memory_order_relaxed);
+            if (start >= config.maxTrials) {
+                break;
+            }
+            uint64_t batch = std::min(BATCH_SIZE, config.maxTrials - start);
+
+            uint64_t wins = 0, ties = 0, shares = 0, shareSquares = 0;
+            for (uint64_t trial = 0; trial < batch; ++trial) {
+                // 部分 Fisher-Yates：只洗出本局需要的牌
+                for (int i = 0; i < needed; ++i) {
+                    int j = i + static_cast<int>(rng.bounded(remainingCount - i));
+                    std::swap(deck[i], deck[j]);
+                }
+                CardSet fullBoard = board;
+                for (int i = 0; i < boardNeeded; ++i) {
+                    fullBoard.add(Card(deck[i]));
+                }
+
+                const uint32_t heroStrength = LookupEvaluator::evaluate(hero | fullBoard);
+                uint32_t best = 0;
+                int bestCount = 0;
+                auto score = [&](CardSet hand) {
+                    uint32_t strength = LookupEvaluator::evaluate(hand | fullBoard);
+                    if (strength > best) {
+                        best = strength;
+                        bestCount = 1;
+                    } else if (strength == best) {
+                        ++bestCount;
+                    }
+                };
+                for (CardSet hand: opponents) {
+                    score(hand);
+                }
+                for (int i = 0; i < randomOpponents; ++i) {
+                    score(CardSet(Card(deck[boardNeeded + 2 * i])) | CardSet(Card(deck[boardNeeded + 2 * i + 1])));
+                }
+
+                if (heroStrength > best) {
+                    ++wins;
+                    shares += SHARE_SCALE;
+                    shareSquares += SHARE_SCALE * SHARE_SCALE;
+                } else if (heroStrength == best) {
+                    ++ties;
+                    uint64_t share = SHARE_SCALE / (bestCount + 1);
+                    shares += share;
+                    shareSquares += share * share;
+                }
+            }
+
+            totals.wins.fetch_add(wins, std::memory_order_relaxed);
+            totals.ties.fetch_add(ties, std::memory_order_relaxed);
+            totals.shares.fetch_add(shares, std::memory_order_relaxed);
+            totals.shareSquares.fetch_add(shareSquares, std::memory_order_relaxed);
+            uint64_t trials = totals.trials.fetch_add(batch, std::memory_order_acq_rel) + batch;
+
+            if (config.targetStandardError > 0 && trials >= config.minTrials &&
+                standardError(trials, totals.shares.load(std::memory_order_relaxed),
+                              totals.shareSquares.load(std::memory_order_relaxed)) <= config.targetStandardError) {
+                totals.done.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    EquityResult result;
+    result.trials = totals.trials.load();
+    if (result.trials == 0) {
+        return result;
+    }
+    double n = static_cast<double>(result.trials);
+    result.win = static_cast<double>(totals.wins.load()) / n;
+    result.tie = static_cast<double>(totals.ties.load()) / n;
+    result.lose = 1.0 - result.win - result.tie;
+    result.equity = static_cast<double>(totals.shares.load()) / SHARE_SCALE / n;
+    result.standardError = standardError(result.trials, totals.shares.load(), totals.shareSquares.load());
+    return result;
+}
+
+EquityResult EquityCalculator::enumerate(int threads) const {
+    if (opponents.empty() || randomOpponents > 0) {
+        throw std::invalid_argument("exact enumeration needs every opponent hand");
+    }
+    LookupEvaluator::initialize();
+
+    const std::vector<Card> remaining = (CardSet::full() - getDeadCards()).toCards();
+    const int remainingCount = static_cast<int>(remaining.size());
+    const int boardNeeded = 5 - board.size();
+    const int players = 1 + static_cast<int>(opponents.size());
+
+    // 已知的牌无法区分的花色之间，同构的发法只计算一次，再按轨道大小加权
+    std::vector<CardSet> fixedRounds = {hero, board};
+    fixedRounds.insert(fixedRounds.end(), opponents.begin(), opponents.end());
+    const SuitSymmetry symmetry(fixedRounds);
+
+    // 每个线程的局部计数，最后在主线程按固定顺序求和
+    struct Totals {
+        uint64_t boards = 0;
+        uint64_t wins = 0;
+        uint64_t ties = 0;
+        uint64_t shares = 0;
+    };
+
+    // states[0] 为英雄，之后依次为各对手，都已加上整副公共牌
+    auto score = [&](CardSet fullBoard, const HandState *states, Totals &totals) {
+        const int weight = symmetry.weight(fullBoard);
+        if (weight == 0) {
+            return;
+        }
+        const uint32_t heroStrength = states[0].evaluate();
+        uint32_t best = 0;
+        int bestCount = 0;
+        for (int i = 1; i < players; ++i) {
+            uint32_t strength = states[i].evaluate();
+            if (strength > best) {
+                best = strength;
+                bestCount = 1;
+            } else if (strength == best) {
+                ++bestCount;
+            }
+        }
+        totals.boards += weight;
+        if (heroStrength > best) {
+            totals.wins += weight;
+            totals.shares += static_cast<uint64_t>(weight) * SHARE_SCALE;
+        } else if (heroStrength == best) {
+            totals.ties += weight;
+            totals.shares += static_cast<uint64_t>(weight) * (SHARE_SCALE / (bestCount + 1));
+        }
+    };
+
+    // 按字典序枚举组合；每层为所有玩家保存一份加到当前前缀的牌力状态，
+    // 同一前缀下的转牌、河牌只在上一层的状态上再加一张牌
+    auto walk = [&](auto &&self, int start, int depth, CardSet prefix, HandState *states, Totals &totals) -> void {
+        if (depth == boardNeeded) {
+            score(prefix, states, totals);
+            return;
+        }
+        HandState *next = states + players;
+        for (int i = start; i <= remainingCount - (boardNeeded - depth); ++i) {
+            for (int p = 0; p < players; ++p) {
+                next[p] = states[p].add(remaining[i]);
+            }
+            self(self, i + 1, depth + 1, prefix | remaining[i], next, totals);
+        }
+    };
+
+    std::vector<HandState> roots(players);
+    roots[0] = HandState(hero | board);
+    for (int i = 1; i < players; ++i) {
+        roots[i] = HandState(opponents[i - 1] | board);
+    }
+
+    Totals result;
+    if (boardNeeded == 0) {
+        score(board, roots.data(), result);
+    } else {
+        const int firstCards = remainingCount - boardNeeded + 1;
+        const int threadCount = std::min(resolveThreadCount(threads), firstCards);
+        std::vector<Totals> perFirstCard(firstCards);
+        std::atomic<int> next{0};
+        auto worker = [&]() {
+            std::vector<HandState> levels(static_cast<size_t>(boardNeeded + 1) * players);
+            for (int first = next.fetch_add(1); first < firstCards; first = next.fetch_add(1)) {
+                for (int p = 0; p < players; ++p) {
+                    levels[p] = roots[p].add(remaining[first]);
+                }
+                walk(walk, first + 1, 1, board | remaining[first], levels.data(), perFirstCard[first]);
+            }
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(threadCount - 1);
+        for (int i = 1; i < threadCount; ++i) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread &thread: pool) {
+            thread.join();
+        }
+        for (const Totals &totals: perFirstCard) {
+            result.boards += totals.boards;
+            result.wins += totals.wins;
+            result.ties += totals.ties;
+            result.shares += totals.shares;
+        }
+    }
+
+    EquityResult equity;
+    equity.trials = result.boards;
+    double n = static_cast<double>(result.boards);
+    equity.win = static_cast<double>(result.wins) / n;
+    equity.tie = static_cast<double>(result.ties) / n;
+    equity.lose = 1.0 - equity.win - equity.tie;
+    equity.equity = static_cast<double>(result.shares) / SHARE_SCALE / n;
+    return equity;
+}
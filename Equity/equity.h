@@ -0,0 +1,58 @@
+#ifndef EQUITY_H
+#define EQUITY_H
+
+#include "../Card/cardset.h"
+#include <cstdint>
+#include <vector>
+
+// 胜率计算结果，比例都相对于 trials
+struct EquityResult {
+    uint64_t trials = 0;
+    double win = 0;            // 独赢的比例
+    double tie = 0;            // 与人平分底池的比例
+    double lose = 0;           // 输的比例
+    double equity = 0;         // 期望分到的底池份额，平局按人数平分
+    double standardError = 0;  // equity 的标准误差
+};
+
+struct EquityConfig {
+    int threads = 0;                    // 0 表示使用全部核心
+    uint64_t maxTrials = 10000000;      // 最多模拟的局数
+    uint64_t minTrials = 10000;         // 提前停止前至少模拟的局数
+    double targetStandardError = 0;     // 标准误差达到这个值就提前停止，0 表示跑满 maxTrials
+    uint64_t seed = 0;
+};
+
+// 英雄手牌对 1~9 个对手的胜率
+// 对手可以指定手牌，也可以是随机手牌；公共牌可以为空或已发出一部分
+class EquityCalculator {
+public:
+    static constexpr int MAX_OPPONENTS = 9;
+
+    explicit EquityCalculator(CardSet hero, CardSet board = CardSet());
+
+    // 指定手牌的对手，与已知的牌重复时抛出 std::invalid_argument
+    void addOpponent(CardSet hand);
+    // 随机手牌的对手
+    void addRandomOpponents(int count);
+
+    [[nodiscard]] int getOpponentCount() const;
+
+    // 多线程蒙特卡洛模拟：每个线程有独立的随机数流，结果用原子计数累加
+    [[nodiscard]] EquityResult monteCarlo(const EquityConfig &config = EquityConfig()) const;
+
+    // 精确枚举剩余公共牌的所有发法，要求所有对手都指定了手牌
+    // 按第一张公共牌把工作分给各线程，结果用整数累加，与线程数无关、完全可复现
+    // 已知的牌中无法区分的花色之间互为同构的发法只计算一次（见 SuitSymmetry）
+    [[nodiscard]] EquityResult enumerate(int threads = 0) const;
+
+private:
+    CardSet hero;
+    CardSet board;
+    std::vector<CardSet> opponents;
+    int randomOpponents = 0;
+
+    [[nodiscard]] CardSet getDeadCards() const;
+};
+
+#endif  // EQUITY_H
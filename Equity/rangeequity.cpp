@@ -0,0 +1,168 @@
+#include "rangeequity.h"
+#include "showdown.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../Random/rng.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+    // 一方范围中与公共牌不冲突的组合，按结构数组存放，方便编译器向量化
+    struct LiveCombos {
+        std::vector<int> combos;
+        std::vector<uint64_t> masks;
+        std::vector<float> weights;
+        std::vector<uint32_t> strengths;
+
+        void build(const Range &range, uint64_t board) {
+            for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+                if (range.getWeight(combo) > 0 && (COMBO_MASKS[combo] & board) == 0) {
+                    combos.push_back(combo);
+                    masks.push_back(COMBO_MASKS[combo]);
+                    weights.push_back(range.getWeight(combo));
+                }
+            }
+            strengths.resize(combos.size());
+        }
+
+        void evaluate(uint64_t fullBoard) {
+            for (size_t i = 0; i < combos.size(); ++i) {
+                // 与这副公共牌冲突的组合牌力记为 0，权重在比较时也会被排除
+                strengths[i] = (masks[i] & fullBoard) ? 0 : LookupEvaluator::evaluate(masks[i] | fullBoard);
+            }
+        }
+    };
+
+    // 每个线程的累加结果
+    struct Accumulator {
+        std::vector<double> wins;     // 按英雄存活组合下标
+        std::vector<double> weights;
+        std::vector<float> margins;    // 每副公共牌的临时结果：赢的权重减输的权重
+        std::vector<float> reachable;  // 每副公共牌的临时结果：不冲突的对手权重
+        uint64_t boards = 0;
+    };
+
+    void scoreBoard(uint64_t fullBoard, LiveCombos &hero, LiveCombos &villain, Accumulator &accumulator) {
+        hero.evaluate(fullBoard);
+        villain.evaluate(fullBoard);
+        const int heroCount = static_cast<int>(hero.combos.size());
+        const ShowdownKernel showdown(hero.strengths.data(), hero.masks.data(), heroCount, villain.strengths.data(),
+                                      villain.masks.data(), static_cast<int>(villain.combos.size()));
+        showdown.compute(villain.weights.data(), accumulator.margins.data(), accumulator.reachable.data(), 0, heroCount);
+        for (int h = 0; h < heroCount; ++h) {
+            // 赢 + 平 / 2 = (不冲突的权重 + 赢 - 输) / 2
+            accumulator.wins[h] += hero.weights[h] * 0.5 * (accumulator.reachable[h] + accumulator.margins[h]);
+            accumulator.weights[h] += hero.weights[h] * accumulator.reachable[h];
+        }
+        ++accumulator.boards;
+    }
+
+}
+
+RangeEquityResult RangeEquity::compute(const Range &hero, const Range &villain, CardSet board,
+                                       const RangeEquityConfig &config) {
+    if (board.size() > 5) {
+        throw std::invalid_argument("board has more than five cards");
+    }
+    LookupEvaluator::initialize();
+
+    LiveCombos heroLive;
+    LiveCombos villainLive;
+    heroLive.build(hero, board.getBits());
+    villainLive.build(villain, board.getBits());
+
+    std::vector<uint64_t> deck;
+    for (Card card: CardSet::full() - board) {
+        deck.push_back(CardSet(card).getBits());
+    }
+    const int boardNeeded = 5 - board.size();
+
+    // 精确模式先列出所有剩余发法
+    const bool exact = board.size() >= 3 && (config.exactRunouts || boardNeeded == 0);
+    std::vector<uint64_t> runouts;
+    if (exact) {
+        if (boardNeeded == 0) {
+            runouts.push_back(board.getBits());
+        } else if (boardNeeded == 1) {
+            for (uint64_t card: deck) {
+                runouts.push_back(board.getBits() | card);
+            }
+        } else {
+            for (size_t i = 0; i < deck.size(); ++i) {
+                for (size_t j = i + 1; j < deck.size(); ++j) {
+                    runouts.push_back(board.getBits() | deck[i] | deck[j]);
+                }
+            }
+        }
+    }
+
+    int threadCount = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, threadCount);
+    std::vector<Accumulator> accumulators(threadCount);
+
+    auto worker = [&](int threadIndex) {
+        LiveCombos localHero = heroLive;
+        LiveCombos localVillain = villainLive;
+        Accumulator &accumulator = accumulators[threadIndex];
+        accumulator.wins.assign(localHero.combos.size(), 0);
+        accumulator.weights.assign(localHero.combos.size(), 0);
+        accumulator.margins.resize(localHero.combos.size());
+        accumulator.reachable.resize(localHero.combos.size());
+
+        if (exact) {
+            for (size_t i = threadIndex; i < runouts.size(); i += threadCount) {
+                scoreBoard(runouts[i], localHero, localVillain, accumulator);
+            }
+            return;
+        }
+        Xoshiro256 rng(config.seed);
+        for (int i = 0; i < threadIndex; ++i) {
+            rng.jump();
+        }
+        std::vector<uint64_t> localDeck = deck;
+        const int deckSize = static_cast<int>(localDeck.size());
+        for (uint64_t sample = threadIndex; sample < config.boardSamples; sample += threadCount) {
+            uint64_t fullBoard = board.getBits();
+            for (int i = 0; i < boardNeeded; ++i) {
+                int j = i + static_cast<int>(rng.bounded(deckSize - i));
+                std::swap(localDeck[i], localDeck[j]);
+                fullBoard |= localDeck[i];
+            }
+            scoreBoard(fullBoard, localHero, localVillain, accumulator);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    RangeEquityResult result;
+    result.comboEquity.assign(COMBO_COUNT, 0);
+    double totalWins = 0;
+    for (size_t h = 0; h < heroLive.combos.size(); ++h) {
+        double wins = 0;
+        double weight = 0;
+        for (const Accumulator &accumulator: accumulators) {
+            wins += accumulator.wins[h];
+            weight += accumulator.weights[h];
+        }
+        if (weight > 0) {
+            result.comboEquity[heroLive.combos[h]] = wins / weight;
+        }
+        totalWins += wins;
+        result.matchupWeight += weight;
+    }
+    for (const Accumulator &accumulator: accumulators) {
+        result.boards += accumulator.boards;
+    }
+    if (result.matchupWeight > 0) {
+        result.equity = totalWins / result.matchupWeight;
+    }
+    return result;
+}
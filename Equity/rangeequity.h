@@ -0,0 +1,34 @@
+#ifndef RANGEEQUITY_H
+#define RANGEEQUITY_H
+
+#include "../Card/cardset.h"
+#include "../Range/range.h"
+#include <cstdint>
+#include <vector>
+
+struct RangeEquityConfig {
+    int threads = 0;                 // 0 表示使用全部核心
+    uint64_t boardSamples = 20000;   // 公共牌少于 3 张时随机抽取的公共牌数量
+    // 关闭后公共牌有 3~4 张时也按 boardSamples 随机抽取剩余发法（翻牌上精确枚举为 C(49,2) 种）
+    bool exactRunouts = true;
+    uint64_t seed = 0;
+};
+
+struct RangeEquityResult {
+    double equity = 0;                // 英雄范围整体的胜率（平局算一半）
+    double matchupWeight = 0;         // 参与计算的（英雄组合，对手组合，公共牌）权重总和
+    uint64_t boards = 0;              // 计算过的公共牌数量
+    std::vector<double> comboEquity;  // 每个英雄组合的胜率，不在范围内的组合为 0
+};
+
+// 范围对范围的胜率
+// 每一副公共牌只为所有存活的组合各评估一次牌力，然后用数组批量比较；
+// 组合之间、组合与公共牌之间的冲突都会被排除。
+// 公共牌已有 3 张及以上时精确枚举剩余发法（exactRunouts 关闭且未发完时除外），否则随机抽样公共牌。
+class RangeEquity {
+public:
+    static RangeEquityResult compute(const Range &hero, const Range &villain, CardSet board,
+                                     const RangeEquityConfig &config = RangeEquityConfig());
+};
+
+#endif  // RANGEEQUITY_H
@@ -0,0 +1,254 @@
+#include "showdown.h"
+#include <algorithm>
+
+#if !defined(AY_GTO_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHOWDOWN_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    // 临时前缀和数组的上限：排序后的对手手牌最多 1326 手，按牌分组最多 2652 条
+    constexpr int MAX_SORTED = COMBO_COUNT + 8;
+    constexpr int MAX_FLAT = 2 * COMBO_COUNT + 8;
+
+}
+
+ShowdownKernel::ShowdownKernel(const uint32_t *heroStrengths, const uint64_t *heroMasks, int heroCount,
+                               const uint32_t *villainStrengths, const uint64_t *villainMasks, int villainCount)
+        : heroCount(heroCount) {
+    // 牌力放在高 32 位、下标放在低 32 位一起排序，牌力相同时按下标，与稳定排序的结果相同，
+    // 又不用每次比较都间接读取牌力
+    std::vector<uint64_t> keys;
+    keys.reserve(villainCount);
+    for (int v = 0; v < villainCount; ++v) {
+        if (villainStrengths[v] != 0) {
+            keys.push_back(static_cast<uint64_t>(villainStrengths[v]) << 32 | static_cast<uint32_t>(v));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    sortedCount = static_cast<int>(keys.size());
+    order.resize(sortedCount);
+    std::vector<uint32_t> sortedStrengths(sortedCount);
+    for (int i = 0; i < sortedCount; ++i) {
+        order[i] = static_cast<int32_t>(keys[i] & 0xFFFFFFFFu);
+        sortedStrengths[i] = static_cast<uint32_t>(keys[i] >> 32);
+    }
+
+    // 按牌分组：每张牌下按排序位置列出含有这张牌的对手手牌，先计数再填入，段内自然有序
+    int32_t segmentStart[CARD_COUNT + 1] = {};
+    for (int i = 0; i < sortedCount; ++i) {
+        uint64_t mask = villainMasks[order[i]];
+        ++segmentStart[__builtin_ctzll(mask) + 1];
+        ++segmentStart[63 - __builtin_clzll(mask) + 1];
+    }
+    for (int card = 0; card < CARD_COUNT; ++card) {
+        segmentStart[card + 1] += segmentStart[card];
+    }
+    flatCount = segmentStart[CARD_COUNT];
+    flatSource.resize(flatCount);
+    int32_t fill[CARD_COUNT];
+    std::copy(segmentStart, segmentStart + CARD_COUNT, fill);
+    std::vector<int32_t> sortedOfCombo(COMBO_COUNT, -1);
+    for (int i = 0; i < sortedCount; ++i) {
+        uint64_t mask = villainMasks[order[i]];
+        const int low = __builtin_ctzll(mask);
+        const int high = 63 - __builtin_clzll(mask);
+        flatSource[fill[low]++] = i;
+        flatSource[fill[high]++] = i;
+        sortedOfCombo[comboIndex(low, high)] = i;
+    }
+
+    less.resize(heroCount);
+    lessEqual.resize(heroCount);
+    same.resize(heroCount);
+    valid.resize(heroCount);
+    for (int k = 0; k < 2; ++k) {
+        cardStart[k].resize(heroCount);
+        cardLess[k].resize(heroCount);
+        cardLessEqual[k].resize(heroCount);
+        cardEnd[k].resize(heroCount);
+    }
+    for (int h = 0; h < heroCount; ++h) {
+        const uint32_t strength = heroStrengths[h];
+        const uint64_t mask = heroMasks[h];
+        valid[h] = strength != 0 ? 1.0f : 0.0f;
+        less[h] = static_cast<int32_t>(std::lower_bound(sortedStrengths.begin(), sortedStrengths.end(), strength) -
+                                       sortedStrengths.begin());
+        lessEqual[h] = static_cast<int32_t>(std::upper_bound(sortedStrengths.begin(), sortedStrengths.end(), strength) -
+                                            sortedStrengths.begin());
+        const int cards[2] = {__builtin_ctzll(mask), 63 - __builtin_clzll(mask)};
+        for (int k = 0; k < 2; ++k) {
+            const int32_t *first = flatSource.data() + segmentStart[cards[k]];
+            const int32_t *last = flatSource.data() + segmentStart[cards[k] + 1];
+            cardStart[k][h] = segmentStart[cards[k]];
+            cardLess[k][h] = static_cast<int32_t>(std::lower_bound(first, last, less[h]) - flatSource.data());
+            cardLessEqual[k][h] = static_cast<int32_t>(std::lower_bound(first, last, lessEqual[h]) - flatSource.data());
+            cardEnd[k][h] = segmentStart[cards[k] + 1];
+        }
+        // 组合相同的对手手牌在两张牌下各被减了一次，需要加回一次
+        const int32_t sameCombo = sortedOfCombo[comboIndex(cards[0], cards[1])];
+        same[h] = sameCombo >= 0 ? sameCombo : sortedCount;
+        if (strength == 0) {
+            less[h] = lessEqual[h] = 0;
+            same[h] = sortedCount;
+            for (int k = 0; k < 2; ++k) {
+                cardStart[k][h] = cardLess[k][h] = cardLessEqual[k][h] = cardEnd[k][h] = 0;
+            }
+        }
+    }
+}
+
+bool ShowdownKernel::usesAvx2() {
+#ifdef SHOWDOWN_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void ShowdownKernel::compute(const float *villainReach, float *values, float *reachable, int begin, int end) const {
+    if (usesAvx2()) {
+        computeAvx2(villainReach, values, reachable, begin, end);
+        return;
+    }
+
+    // sorted 末尾多放一个 0，供没有相同组合的手牌引用
+    alignas(32) float sorted[MAX_SORTED];
+    alignas(32) float prefix[MAX_SORTED + 1];
+    alignas(32) float cardPrefix[MAX_FLAT + 1];
+    for (int i = 0; i < sortedCount; ++i) {
+        sorted[i] = villainReach[order[i]];
+    }
+    sorted[sortedCount] = 0;
+    prefix[0] = 0;
+    for (int i = 0; i < sortedCount; ++i) {
+        prefix[i + 1] = prefix[i] + sorted[i];
+    }
+    cardPrefix[0] = 0;
+    for (int j = 0; j < flatCount; ++j) {
+        cardPrefix[j + 1] = cardPrefix[j] + sorted[flatSource[j]];
+    }
+    computeScalar(sorted, prefix, cardPrefix, values, reachable, begin, end);
+}
+
+void ShowdownKernel::computeScalar(const float *sorted, const float *prefix, const float *cardPrefix, float *values,
+                                   float *reachable, int begin, int end) const {
+    const float total = prefix[sortedCount];
+    for (int h = begin; h < end; ++h) {
+        float win = prefix[less[h]];
+        float lose = total - prefix[lessEqual[h]];
+        float blocked = 0;
+        for (int k = 0; k < 2; ++k) {
+            win -= cardPrefix[cardLess[k][h]] - cardPrefix[cardStart[k][h]];
+            lose -= cardPrefix[cardEnd[k][h]] - cardPrefix[cardLessEqual[k][h]];
+            blocked += cardPrefix[cardEnd[k][h]] - cardPrefix[cardStart[k][h]];
+        }
+        values[h] = (win - lose) * valid[h];
+        if (reachable != nullptr) {
+            reachable[h] = (total - blocked + sorted[same[h]]) * valid[h];
+        }
+    }
+}
+
+#ifdef SHOWDOWN_AVX2
+
+namespace {
+
+    // 8 个 float 的前缀和写入 out[0..7]（包含自身），carry 为之前所有元素之和
+    __attribute__((target("avx2")))
+    inline __m256 scan8(__m256 x, __m256 carry) {
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+        __m256 low = _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3));
+        x = _mm256_add_ps(x, _mm256_permute2f128_ps(low, low, 0x08));
+        return _mm256_add_ps(x, carry);
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i load(const std::vector<int32_t> &indices, int offset) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices.data() + offset));
+    }
+
+    // out[0] = 0，out[i + 1] = in[0] + ... + in[i]
+    __attribute__((target("avx2")))
+    void exclusiveScan(const float *in, float *out, int count) {
+        __m256 carry = _mm256_setzero_ps();
+        const __m256i last = _mm256_set1_epi32(7);
+        out[0] = 0;
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 sum = scan8(_mm256_loadu_ps(in + i), carry);
+            _mm256_storeu_ps(out + i + 1, sum);
+            carry = _mm256_permutevar8x32_ps(sum, last);
+        }
+        float running = _mm256_cvtss_f32(carry);
+        for (; i < count; ++i) {
+            running += in[i];
+            out[i + 1] = running;
+        }
+    }
+
+}
+
+__attribute__((target("avx2")))
+void ShowdownKernel::computeAvx2(const float *villainReach, float *values, float *reachable, int begin,
+                                 int end) const {
+    alignas(32) float sorted[MAX_SORTED];
+    alignas(32) float flat[MAX_FLAT];
+    alignas(32) float prefix[MAX_SORTED + 1];
+    alignas(32) float cardPrefix[MAX_FLAT + 1];
+
+    int i = 0;
+    for (; i + 8 <= sortedCount; i += 8) {
+        _mm256_store_ps(sorted + i, _mm256_i32gather_ps(villainReach, load(order, i), 4));
+    }
+    for (; i < sortedCount; ++i) {
+        sorted[i] = villainReach[order[i]];
+    }
+    sorted[sortedCount] = 0;
+    int j = 0;
+    for (; j + 8 <= flatCount; j += 8) {
+        _mm256_store_ps(flat + j, _mm256_i32gather_ps(sorted, load(flatSource, j), 4));
+    }
+    for (; j < flatCount; ++j) {
+        flat[j] = sorted[flatSource[j]];
+    }
+    exclusiveScan(sorted, prefix, sortedCount);
+    exclusiveScan(flat, cardPrefix, flatCount);
+
+    const __m256 total = _mm256_set1_ps(prefix[sortedCount]);
+    int h = begin;
+    for (; h + 8 <= end; h += 8) {
+        __m256 win = _mm256_i32gather_ps(prefix, load(less, h), 4);
+        __m256 lose = _mm256_sub_ps(total, _mm256_i32gather_ps(prefix, load(lessEqual, h), 4));
+        __m256 blocked = _mm256_setzero_ps();
+        for (int k = 0; k < 2; ++k) {
+            __m256 start = _mm256_i32gather_ps(cardPrefix, load(cardStart[k], h), 4);
+            __m256 below = _mm256_i32gather_ps(cardPrefix, load(cardLess[k], h), 4);
+            __m256 upTo = _mm256_i32gather_ps(cardPrefix, load(cardLessEqual[k], h), 4);
+            __m256 stop = _mm256_i32gather_ps(cardPrefix, load(cardEnd[k], h), 4);
+            win = _mm256_sub_ps(win, _mm256_sub_ps(below, start));
+            lose = _mm256_sub_ps(lose, _mm256_sub_ps(stop, upTo));
+            blocked = _mm256_add_ps(blocked, _mm256_sub_ps(stop, start));
+        }
+        __m256 mask = _mm256_loadu_ps(valid.data() + h);
+        _mm256_storeu_ps(values + h, _mm256_mul_ps(_mm256_sub_ps(win, lose), mask));
+        if (reachable != nullptr) {
+            __m256 sameReach = _mm256_i32gather_ps(sorted, load(same, h), 4);
+            __m256 open = _mm256_add_ps(_mm256_sub_ps(total, blocked), sameReach);
+            _mm256_storeu_ps(reachable + h, _mm256_mul_ps(open, mask));
+        }
+    }
+    computeScalar(sorted, prefix, cardPrefix, values, reachable, h, end);
+}
+
+#else
+
+void ShowdownKernel::computeAvx2(const float *villainReach, float *values, float *reachable, int begin,
+                                 int end) const {
+    compute(villainReach, values, reachable, begin, end);
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef SHOWDOWN_H
+#define SHOWDOWN_H
+
+#include "../Range/range.h"
+#include <cstdint>
+#include <vector>
+
+// 一副公共牌上，一方全部手牌对另一方全部手牌的摊牌比较
+// 构造时按牌力排序（O(n log n)），并为每手英雄牌预先算好在前缀和数组中的下标；
+// 之后每次计算只需要两次前缀和加若干次 gather，O(n) 且没有分支，
+// 同一副公共牌上可以在每次 CFR 迭代中反复调用。
+// 牌力为 0 表示该手牌与公共牌冲突，不参与比较。
+class ShowdownKernel {
+public:
+    ShowdownKernel() = default;
+    ShowdownKernel(const uint32_t *heroStrengths, const uint64_t *heroMasks, int heroCount,
+                   const uint32_t *villainStrengths, const uint64_t *villainMasks, int villainCount);
+
+    // 对英雄手牌 [begin, end)：
+    //   values[h]    = 牌力比 h 小的对手到达概率之和 - 牌力比 h 大的对手到达概率之和
+    //   reachable[h] = 与 h 不冲突的对手到达概率之和（可以为 nullptr）
+    // 与 h 有共同牌的对手手牌都会被排除
+    void compute(const float *villainReach, float *values, float *reachable, int begin, int end) const;
+
+    // 当前 CPU 和编译选项下是否使用 AVX2 实现
+    static bool usesAvx2();
+
+private:
+    int heroCount = 0;
+    int sortedCount = 0;  // 与公共牌不冲突的对手手牌数
+    int flatCount = 0;    // 按牌分组后的条目数，每手对手牌在它的两张牌下各出现一次
+
+    std::vector<int32_t> order;       // 排序位置 -> 对手手牌下标
+    std::vector<int32_t> flatSource;  // 按牌分组的条目 -> 排序位置
+
+    // 每手英雄牌在前缀和数组中的下标：P 为排序后的前缀和，G 为按牌分组的前缀和
+    std::vector<int32_t> less;        // P 中牌力更小的对手数
+    std::vector<int32_t> lessEqual;   // P 中牌力不大于它的对手数
+    std::vector<int32_t> cardStart[2];
+    std::vector<int32_t> cardLess[2];
+    std::vector<int32_t> cardLessEqual[2];
+    std::vector<int32_t> cardEnd[2];
+    std::vector<int32_t> same;        // 组合相同的对手的排序位置，没有时指向末尾的 0
+    std::vector<float> valid;         // 英雄手牌与公共牌冲突时为 0
+
+    void computeScalar(const float *sorted, const float *prefix, const float *cardPrefix, float *values,
+                       float *reachable, int begin, int end) const;
+    void computeAvx2(const float *villainReach, float *values, float *reachable, int begin, int end) const;
+};
+
+#endif  // SHOWDOWN_H
@@ -0,0 +1,557 @@
+#include "handhistory.h"
+#include "../Concurrency/boundedqueue.h"
+#include "../Concurrency/threads.h"
+#include "../pokerHand/handstate.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../pokerHand/pokerhand.h"
+#include "../Random/rng.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    constexpr char MAGIC[8] = {'A', 'Y', 'H', 'I', 'S', 0, 0, 0};
+    constexpr size_t RELEASE_WINDOW = 64u << 20;  // 每读过这么多字节把之前的页交还给内核
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t handCount;
+        uint64_t seatCount;      // 之后为若干行组，见 HandHistory 的说明
+    };
+    static_assert(sizeof(FileHeader) == 32, "file header layout changed");
+
+    bool startsWith(std::string_view text, std::string_view prefix) {
+        return text.substr(0, prefix.size()) == prefix;
+    }
+
+    bool isBlank(std::string_view line) {
+        return std::all_of(line.begin(), line.end(), [](char c) { return c == ' ' || c == '\t' || c == '\r'; });
+    }
+
+    // 从 start 开始读一个无符号整数，没有数字时返回空
+    std::optional<uint64_t> parseInteger(std::string_view text, size_t start) {
+        uint64_t value = 0;
+        size_t i = start;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+            value = value * 10 + static_cast<uint64_t>(text[i] - '0');
+            ++i;
+        }
+        if (i == start) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    // 跳过货币符号，读 "$1,234.56" 这样的金额
+    double parseAmount(std::string_view text) {
+        size_t i = 0;
+        while (i < text.size() && (text[i] < '0' || text[i] > '9')) {
+            ++i;
+        }
+        double value = 0;
+        for (; i < text.size() && ((text[i] >= '0' && text[i] <= '9') || text[i] == ','); ++i) {
+            if (text[i] != ',') {
+                value = value * 10 + (text[i] - '0');
+            }
+        }
+        if (i < text.size() && text[i] == '.') {
+            double scale = 0.1;
+            for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+                value += (text[i] - '0') * scale;
+                scale *= 0.1;
+            }
+        }
+        return value;
+    }
+
+    // 解析 line 中从 open 开始的 "[As Kd ...]"，最多 max 张；返回张数，格式不对时返回 -1
+    int parseCardList(std::string_view line, size_t open, uint8_t *cards, int max) {
+        if (open == std::string_view::npos || open >= line.size() || line[open] != '[') {
+            return -1;
+        }
+        const size_t close = line.find(']', open);
+        if (close == std::string_view::npos) {
+            return -1;
+        }
+        int count = 0;
+        for (size_t i = open + 1; i < close;) {
+            if (line[i] == ' ') {
+                ++i;
+                continue;
+            }
+            std::optional<Card> card = Card::fromString(line.substr(i, 2));
+            if (!card || count == max) {
+                return -1;
+            }
+            cards[count++] = card->getIndex();
+            i += 2;
+        }
+        return count;
+    }
+
+    // 读取线程交给求值线程的一批手牌
+    struct HandBatch {
+        uint64_t sequence = 0;
+        uint64_t malformed = 0;
+        std::vector<HistoryHand> hands;
+    };
+
+    // 一批手牌的求值结果，按列存放，写出线程直接整列写入
+    struct ResultBatch {
+        uint64_t sequence = 0;
+        uint64_t hands = 0;
+        uint64_t skipped = 0;
+        uint64_t allIns = 0;
+
+        std::vector<uint64_t> id;
+        std::vector<uint64_t> board;
+        std::vector<double> pot;
+        std::vector<uint16_t> winners;
+        std::vector<uint8_t> boardCount;
+        std::vector<uint8_t> allInBoardCards;
+        std::vector<uint8_t> seatCount;
+
+        std::vector<uint64_t> seatHand;   // 批内行号，写出时加上之前的总手数
+        std::vector<uint64_t> hole;
+        std::vector<uint32_t> strength;
+        std::vector<float> share;
+        std::vector<float> equity;
+        std::vector<double> allInEv;
+        std::vector<uint8_t> seat;
+        std::vector<uint8_t> handType;
+    };
+
+    // 全下时的胜率：已知各家手牌和前 allInBoardCards 张公共牌，平分的局按人数分摊
+    // 还差一两张公共牌时精确枚举；翻前全下按 trials 抽样，trials 为 0 时枚举全部 C(n, 5) 种发法
+    void allInEquities(const HistoryHand &hand, uint64_t trials, uint64_t seed, float *equities) {
+        const int players = hand.seatCount;
+        const int known = hand.allInBoardCards;
+        CardSet dead;
+        CardSet prefix;
+        for (int i = 0; i < players; ++i) {
+            dead |= hand.seats[i].hole;
+        }
+        for (int i = 0; i < known; ++i) {
+            prefix.add(Card(hand.board[i]));
+        }
+        dead |= prefix;
+        uint8_t deck[CARD_COUNT];
+        int deckSize = 0;
+        for (Card card: CardSet::full() - dead) {
+            deck[deckSize++] = card.getIndex();
+        }
+
+        // 手牌加已知公共牌的状态只算一次，每种发法只再加上剩下的公共牌
+        HandState states[HistoryHand::MAX_SEATS];
+        for (int i = 0; i < players; ++i) {
+            states[i] = HandState(hand.seats[i].hole | prefix);
+        }
+        double shares[HistoryHand::MAX_SEATS] = {};
+        double total = 0;
+        auto score = [&](uint64_t runout) {
+            uint32_t strengths[HistoryHand::MAX_SEATS];
+            uint32_t best = 0;
+            for (int i = 0; i < players; ++i) {
+                strengths[i] = states[i].add(CardSet(runout)).evaluate();
+                best = std::max(best, strengths[i]);
+            }
+            int winners = 0;
+            for (int i = 0; i < players; ++i) {
+                winners += strengths[i] == best;
+            }
+            for (int i = 0; i < players; ++i) {
+                if (strengths[i] == best) {
+                    shares[i] += 1.0 / winners;
+                }
+            }
+            total += 1;
+        };
+
+        const int needed = 5 - known;
+        if (needed <= 2 || trials == 0) {
+            int index[5];
+            for (int i = 0; i < needed; ++i) {
+                index[i] = i;
+            }
+            while (true) {
+                uint64_t runout = 0;
+                for (int i = 0; i < needed; ++i) {
+                    runout |= 1ull << deck[index[i]];
+                }
+                score(runout);
+                int i = needed - 1;
+                while (i >= 0 && index[i] == deckSize - needed + i) {
+                    --i;
+                }
+                if (i < 0) {
+                    break;
+                }
+                ++index[i];
+                for (int j = i + 1; j < needed; ++j) {
+                    index[j] = index[j - 1] + 1;
+                }
+            }
+        } else {
+            // 种子只取决于手牌编号，结果与线程数和批次划分无关
+            Xoshiro256 rng(seed ^ (hand.id * 0x9E3779B97F4A7C15ull));
+            for (uint64_t t = 0; t < trials; ++t) {
+                uint64_t runout = 0;
+                for (int i = 0; i < needed; ++i) {
+                    const int j = i + static_cast<int>(rng.bounded(static_cast<uint32_t>(deckSize - i)));
+                    std::swap(deck[i], deck[j]);
+                    runout |= 1ull << deck[i];
+                }
+                score(runout);
+            }
+        }
+        for (int i = 0; i < players; ++i) {
+            equities[i] = static_cast<float>(shares[i] / total);
+        }
+    }
+
+    ResultBatch evaluateBatch(const HandBatch &batch, const HistoryConfig &config) {
+        ResultBatch result;
+        result.sequence = batch.sequence;
+        result.hands = batch.hands.size() + batch.malformed;
+        result.skipped = batch.malformed;
+        for (const HistoryHand &hand: batch.hands) {
+            if (hand.boardCount < 5 || hand.seatCount < 2) {
+                ++result.skipped;
+                continue;
+            }
+            CardSet board;
+            for (uint8_t card: hand.board) {
+                board.add(Card(card));
+            }
+            uint32_t strengths[HistoryHand::MAX_SEATS];
+            uint32_t best = 0;
+            for (int i = 0; i < hand.seatCount; ++i) {
+                strengths[i] = PokerHand(hand.seats[i].hole | board).getStrength();
+                best = std::max(best, strengths[i]);
+            }
+            uint16_t winners = 0;
+            int winnerCount = 0;
+            for (int i = 0; i < hand.seatCount; ++i) {
+                if (strengths[i] == best) {
+                    winners |= static_cast<uint16_t>(1u << (hand.seats[i].seat - 1));
+                    ++winnerCount;
+                }
+            }
+            float equities[HistoryHand::MAX_SEATS];
+            const bool allIn = hand.allInBoardCards < HistoryHand::NO_ALL_IN;
+            if (allIn) {
+                allInEquities(hand, config.allInTrials, config.seed, equities);
+                ++result.allIns;
+            }
+
+            const uint64_t row = result.id.size();
+            result.id.push_back(hand.id);
+            result.board.push_back(board.getBits());
+            result.pot.push_back(hand.pot);
+            result.winners.push_back(winners);
+            result.boardCount.push_back(hand.boardCount);
+            result.allInBoardCards.push_back(hand.allInBoardCards);
+            result.seatCount.push_back(hand.seatCount);
+            for (int i = 0; i < hand.seatCount; ++i) {
+                const float equity = allIn ? equities[i] : -1.0f;
+                result.seatHand.push_back(row);
+                result.hole.push_back(hand.seats[i].hole.getBits());
+                result.strength.push_back(strengths[i]);
+                result.share.push_back(strengths[i] == best ? 1.0f / static_cast<float>(winnerCount) : 0.0f);
+                result.equity.push_back(equity);
+                result.allInEv.push_back(allIn ? equity * hand.pot : 0.0);
+                result.seat.push_back(hand.seats[i].seat);
+                result.handType.push_back(static_cast<uint8_t>(LookupEvaluator::handType(strengths[i])));
+            }
+        }
+        return result;
+    }
+
+    template<typename T>
+    void writeColumn(std::ofstream &out, const std::vector<T> &column) {
+        out.write(reinterpret_cast<const char *>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+    }
+
+    void writeRowGroup(std::ofstream &out, ResultBatch &batch, uint64_t firstRow) {
+        const uint32_t counts[2] = {static_cast<uint32_t>(batch.id.size()), static_cast<uint32_t>(batch.hole.size())};
+        for (uint64_t &row: batch.seatHand) {
+            row += firstRow;
+        }
+        out.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+        writeColumn(out, batch.id);
+        writeColumn(out, batch.board);
+        writeColumn(out, batch.pot);
+        writeColumn(out, batch.winners);
+        writeColumn(out, batch.boardCount);
+        writeColumn(out, batch.allInBoardCards);
+        writeColumn(out, batch.seatCount);
+        writeColumn(out, batch.seatHand);
+        writeColumn(out, batch.hole);
+        writeColumn(out, batch.strength);
+        writeColumn(out, batch.share);
+        writeColumn(out, batch.equity);
+        writeColumn(out, batch.allInEv);
+        writeColumn(out, batch.seat);
+        writeColumn(out, batch.handType);
+    }
+
+}
+
+bool HistoryParser::parse(std::string_view text, HistoryHand &hand) {
+    hand = HistoryHand();
+    CardSet used;
+    bool first = true;
+    bool summary = false;
+    uint8_t street = 0;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(start, end - start);
+        start = end + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        if (first) {
+            const size_t mark = line.find("Hand #");
+            std::optional<uint64_t> id = mark == std::string_view::npos ? std::nullopt : parseInteger(line, mark + 6);
+            if (!id) {
+                return false;
+            }
+            hand.id = *id;
+            first = false;
+        } else if (startsWith(line, "*** ")) {
+            if (startsWith(line, "*** FLOP")) {
+                street = 3;
+            } else if (startsWith(line, "*** TURN")) {
+                street = 4;
+            } else if (startsWith(line, "*** RIVER")) {
+                street = 5;
+            } else if (startsWith(line, "*** SUMMARY")) {
+                summary = true;
+            }
+        } else if (!summary) {
+            if (line.find("all-in") != std::string_view::npos) {
+                hand.allInBoardCards = std::min(street, HistoryHand::NO_ALL_IN);
+            }
+        } else if (startsWith(line, "Total pot ")) {
+            hand.pot = parseAmount(line.substr(10));
+        } else if (startsWith(line, "Board ")) {
+            const int count = parseCardList(line, 6, hand.board, 5);
+            if (count < 0) {
+                return false;
+            }
+            hand.boardCount = static_cast<uint8_t>(count);
+            for (int i = 0; i < count; ++i) {
+                if (used.contains(Card(hand.board[i]))) {
+                    return false;
+                }
+                used.add(Card(hand.board[i]));
+            }
+        } else if (startsWith(line, "Seat ")) {
+            size_t mark = line.find("showed [");
+            if (mark == std::string_view::npos) {
+                mark = line.find("mucked [");
+            }
+            if (mark == std::string_view::npos) {
+                continue;
+            }
+            std::optional<uint64_t> seat = parseInteger(line, 5);
+            uint8_t cards[2];
+            if (!seat || *seat < 1 || *seat > HistoryHand::MAX_SEATS || hand.seatCount == HistoryHand::MAX_SEATS ||
+                parseCardList(line, mark + 7, cards, 2) != 2) {
+                return false;
+            }
+            const CardSet hole = CardSet(Card(cards[0])) | CardSet(Card(cards[1]));
+            if (hole.size() != 2 || used.intersects(hole)) {
+                return false;
+            }
+            used |= hole;
+            hand.seats[hand.seatCount++] = {static_cast<uint8_t>(*seat), hole};
+        }
+    }
+    return !first;
+}
+
+HistoryReader::HistoryReader(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open hand history: " + path);
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot read hand history: " + path);
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            ::close(fd);
+            throw std::runtime_error("cannot map hand history: " + path);
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+}
+
+HistoryReader::~HistoryReader() {
+    if (mapping) {
+        munmap(mapping, size);
+    }
+}
+
+std::optional<std::string_view> HistoryReader::next() {
+    const char *data = static_cast<const char *>(mapping);
+    auto lineEnd = [&](size_t from) {
+        const void *found = std::memchr(data + from, '\n', size - from);
+        return found ? static_cast<size_t>(static_cast<const char *>(found) - data) : size;
+    };
+
+    // 上一手牌的文本已经用完，把之前整页的部分交还给内核
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (position - released >= RELEASE_WINDOW) {
+        const size_t until = position / page * page;
+        madvise(const_cast<char *>(data) + released, until - released, MADV_DONTNEED);
+        released = until;
+    }
+
+    while (position < size) {
+        const size_t end = lineEnd(position);
+        if (!isBlank(std::string_view(data + position, end - position))) {
+            break;
+        }
+        position = std::min(size, end + 1);
+    }
+    if (position >= size) {
+        return std::nullopt;
+    }
+    const size_t begin = position;
+    while (position < size) {
+        const size_t end = lineEnd(position);
+        if (isBlank(std::string_view(data + position, end - position))) {
+            break;
+        }
+        position = std::min(size, end + 1);
+    }
+    return std::string_view(data + begin, position - begin);
+}
+
+HistoryStats HandHistory::process(const std::string &input, const std::string &output, const HistoryConfig &config) {
+    LookupEvaluator::initialize();
+    HistoryReader reader(input);
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!out) {
+        throw std::runtime_error("cannot write hand summary: " + output);
+    }
+
+    const int threads = resolveThreadCount(config.threads);
+    const size_t batchSize = std::max<size_t>(1, config.batchSize);
+    const uint64_t maxInFlight = 4 * static_cast<uint64_t>(threads);
+    BoundedQueue<HandBatch> parsed(2 * static_cast<size_t>(threads));
+    BoundedQueue<ResultBatch> results(2 * static_cast<size_t>(threads));
+
+    // 写出线程按序号写行组；在途批次数有上限，乱序到达的结果最多缓存 maxInFlight 批
+    std::mutex flightMutex;
+    std::condition_variable flightDone;
+    uint64_t written = 0;
+
+    HistoryStats stats;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&]() {
+            while (std::optional<HandBatch> batch = parsed.pop()) {
+                results.push(evaluateBatch(*batch, config));
+            }
+        });
+    }
+    std::thread writer([&]() {
+        std::map<uint64_t, ResultBatch> pending;
+        while (std::optional<ResultBatch> batch = results.pop()) {
+            const uint64_t sequence = batch->sequence;
+            pending.emplace(sequence, std::move(*batch));
+            while (!pending.empty() && pending.begin()->first == written) {
+                ResultBatch &next = pending.begin()->second;
+                if (out) {
+                    writeRowGroup(out, next, stats.showdowns);
+                }
+                stats.hands += next.hands;
+                stats.skipped += next.skipped;
+                stats.allIns += next.allIns;
+                stats.showdowns += next.id.size();
+                stats.seats += next.hole.size();
+                pending.erase(pending.begin());
+                {
+                    std::lock_guard<std::mutex> lock(flightMutex);
+                    ++written;
+                }
+                flightDone.notify_one();
+            }
+        }
+    });
+
+    uint64_t sequence = 0;
+    HandBatch batch;
+    auto flush = [&]() {
+        {
+            std::unique_lock<std::mutex> lock(flightMutex);
+            flightDone.wait(lock, [&]() { return sequence - written < maxInFlight; });
+        }
+        batch.sequence = sequence++;
+        parsed.push(std::move(batch));
+        batch = HandBatch();
+        batch.hands.reserve(batchSize);
+    };
+    batch.hands.reserve(batchSize);
+    while (std::optional<std::string_view> text = reader.next()) {
+        batch.hands.emplace_back();
+        if (!HistoryParser::parse(*text, batch.hands.back())) {
+            batch.hands.pop_back();
+            ++batch.malformed;
+        }
+        if (batch.hands.size() + batch.malformed >= batchSize) {
+            flush();
+        }
+    }
+    if (!batch.hands.empty() || batch.malformed > 0) {
+        flush();
+    }
+    parsed.close();
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+    results.close();
+    writer.join();
+
+    header.handCount = stats.showdowns;
+    header.seatCount = stats.seats;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("cannot write hand summary: " + output);
+    }
+    stats.bytes = reader.getSize();
+    return stats;
+}
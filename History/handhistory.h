@@ -0,0 +1,101 @@
+#ifndef HANDHISTORY_H
+#define HANDHISTORY_H
+
+#include "../Card/cardset.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// 一手牌中摊牌时亮出的手牌
+struct HistorySeat {
+    uint8_t seat = 0;       // 座位号，1~10
+    CardSet hole;
+};
+
+// 解析后的一手牌，定长、不含字符串，可以整批在线程之间传递
+struct HistoryHand {
+    static constexpr int MAX_SEATS = 10;
+    static constexpr uint8_t NO_ALL_IN = 5;
+
+    uint64_t id = 0;
+    uint8_t board[5] = {};        // 按发牌顺序的公共牌编号，前 boardCount 张有效
+    uint8_t boardCount = 0;
+    uint8_t allInBoardCards = NO_ALL_IN;  // 最后一次全下时已发出的公共牌张数，河牌前没有全下为 NO_ALL_IN
+    uint8_t seatCount = 0;
+    double pot = 0;
+    HistorySeat seats[MAX_SEATS];
+};
+
+// 手牌记录的文本格式（PokerStars 风格，只读取需要的行）：
+//   第一行含 "Hand #<编号>"
+//   "*** FLOP *** [..]"、"*** TURN ***"、"*** RIVER ***" 标记当前街，含 "all-in" 的行记下全下时的街
+//   "*** SUMMARY ***" 之后读取 "Total pot <金额>"、"Board [..]" 和 "Seat N: ... showed|mucked [..]"
+// 手牌之间以空行分隔。
+class HistoryParser {
+public:
+    // 解析一手牌的文本；缺少编号、牌面不合法或出现重复的牌时返回 false
+    static bool parse(std::string_view text, HistoryHand &hand);
+};
+
+// 用 mmap 顺序读取手牌记录文件，每次返回一手牌的文本，不复制
+// 已读过的部分定期交还给内核，几 GB 的文件常驻内存也只有一个窗口大小。
+class HistoryReader {
+public:
+    // 文件打不开时抛出 std::runtime_error
+    explicit HistoryReader(const std::string &path);
+    HistoryReader(const HistoryReader &) = delete;
+    HistoryReader &operator=(const HistoryReader &) = delete;
+    ~HistoryReader();
+
+    // 下一手牌的文本，在下次调用 next() 之前有效；读完时返回空
+    std::optional<std::string_view> next();
+
+    [[nodiscard]] size_t getSize() const { return size; }
+    [[nodiscard]] size_t getPosition() const { return position; }
+
+private:
+    void *mapping = nullptr;
+    size_t size = 0;
+    size_t position = 0;
+    size_t released = 0;
+};
+
+struct HistoryConfig {
+    int threads = 0;               // 求值线程数，0 表示使用全部核心
+    size_t batchSize = 1024;       // 每批手数，也是输出文件中一个行组的手数
+    uint64_t allInTrials = 10000;  // 翻前全下时蒙特卡洛的局数，0 表示精确枚举；翻牌和转牌全下总是精确枚举
+    uint64_t seed = 0;
+};
+
+struct HistoryStats {
+    uint64_t hands = 0;       // 读到的手数
+    uint64_t showdowns = 0;   // 写入输出文件的摊牌手数
+    uint64_t skipped = 0;     // 格式不对或没有摊牌（公共牌不满 5 张或亮牌不足两人）的手数
+    uint64_t seats = 0;       // 写入的亮牌座位数
+    uint64_t allIns = 0;      // 河牌前全下的摊牌手数
+    uint64_t bytes = 0;
+};
+
+// 批量摊牌求值
+// 三段流水线：读取线程解析成 HistoryHand 批次，多个求值线程按 PokerHand 的牌力比较求出赢家、牌型和全下 EV，
+// 写出线程按原顺序写成列式文件。阶段之间用有界队列连接，在途批次数有上限，内存不随输入增长。
+//
+// 输出文件：32 字节文件头（magic "AYHIS"、版本、总手数、总座位数），之后是若干行组。
+// 每个行组以 uint32 手数 h、uint32 座位数 s 开头，然后依次为各列的连续数组：
+//   手表  id u64[h]  board u64[h]  pot f64[h]  winners u16[h]（赢家座位号的位掩码）
+//         boardCount u8[h]  allInBoardCards u8[h]  seatCount u8[h]
+//   座位表 hand u64[s]（所属手在整个文件中的行号）  hole u64[s]  strength u32[s]  share f32[s]（实际分得底池的比例）
+//         equity f32[s]（全下时的胜率，没有全下为 -1）  allInEv f64[s]（equity × pot）  seat u8[s]  handType u8[s]
+// 边池不单独计算，底池按整体分配。
+class HandHistory {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // 输入打不开或输出写入失败时抛出 std::runtime_error
+    static HistoryStats process(const std::string &input, const std::string &output,
+                                const HistoryConfig &config = HistoryConfig());
+};
+
+#endif  // HANDHISTORY_H
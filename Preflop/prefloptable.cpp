@@ -0,0 +1,414 @@
+#include "prefloptable.h"
+#include "../Card/isomorphism.h"
+#include "../Concurrency/threads.h"
+#include "../Equity/equity.h"
+#include "../pokerHand/handstate.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../Range/range.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    constexpr char MAGIC[8] = {'A', 'Y', 'P', 'F', 'E', 'Q', 0, 0};
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    constexpr int CLASS_COUNT = PreflopTable::CLASS_COUNT;
+    constexpr int RANDOM_ROWS = PreflopTable::MAX_PLAYERS - 1;  // 2~9 人
+    constexpr uint64_t SECTION_ALIGNMENT = 64;
+
+    // 文件头，所有字段为小端定长整数；数据段按 64 字节对齐
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t classCount;
+        uint32_t maxPlayers;
+        uint64_t randomTrials;
+        uint64_t matchupOffset;  // float[169][169]
+        uint64_t randomOffset;   // float[8][169]，第 i 行为 i + 2 人
+        uint64_t fileSize;
+        uint64_t checksum;       // 头之后全部内容的 FNV-1a
+    };
+    static_assert(sizeof(FileHeader) == 64, "file header layout changed");
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+    uint64_t fnv1a(const unsigned char *data, size_t size) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    // 每个具体组合所属的起手牌编号
+    struct ComboClasses {
+        uint8_t classes[COMBO_COUNT];
+
+        ComboClasses() : classes() {
+            for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+                classes[combo] = static_cast<uint8_t>(PreflopTable::classOf(CardSet(COMBO_MASKS[combo])));
+            }
+        }
+    };
+
+    // 一个线程在一部分公共牌上的累计结果，单位为半个底池：赢记 2，平记 1
+    struct MatchupTally {
+        std::vector<int64_t> halves = std::vector<int64_t>(CLASS_COUNT * CLASS_COUNT, 0);
+    };
+
+    // 在一副公共牌上，对所有不冲突的 (英雄组合, 对手组合) 累加输赢，结果乘以公共牌的重数
+    // 按牌力等价类做计数排序后从小到大扫描：run 为牌力更小的各起手牌组合数，
+    // 同一组牌力相同的组合互相记平；与英雄共享牌的组合最后单独减掉。
+    class BoardScorer {
+    public:
+        explicit BoardScorer(const ComboClasses &comboClasses) : comboClasses(comboClasses) {
+            for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+                uint64_t mask = COMBO_MASKS[combo];
+                cardCombos[__builtin_ctzll(mask)].push_back(combo);
+                cardCombos[63 - __builtin_clzll(mask)].push_back(combo);
+            }
+            bucketStart.resize(LookupEvaluator::HAND_CLASS_COUNT + 1);
+        }
+
+        void score(uint64_t board, int64_t multiplicity, MatchupTally &tally) {
+            liveCount = 0;
+            std::fill(bucketStart.begin(), bucketStart.end(), 0);
+            const HandState boardState(CardSet{board});
+            for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+                if (COMBO_MASKS[combo] & board) {
+                    handClass[combo] = -1;
+                    continue;
+                }
+                handClass[combo] = boardState.add(CardSet(COMBO_MASKS[combo])).evaluateClass();
+                ++bucketStart[handClass[combo] + 1];
+                live[liveCount++] = combo;
+            }
+            for (int i = 1; i <= LookupEvaluator::HAND_CLASS_COUNT; ++i) {
+                bucketStart[i] += bucketStart[i - 1];
+            }
+            for (int i = 0; i < liveCount; ++i) {
+                sorted[bucketStart[handClass[live[i]]]++] = live[i];
+            }
+
+            int64_t run[CLASS_COUNT] = {};
+            int64_t group[CLASS_COUNT] = {};
+            int64_t row[CLASS_COUNT];
+            for (int begin = 0; begin < liveCount;) {
+                int end = begin;
+                while (end < liveCount && handClass[sorted[end]] == handClass[sorted[begin]]) {
+                    ++group[comboClasses.classes[sorted[end]]];
+                    ++end;
+                }
+                for (int c = 0; c < CLASS_COUNT; ++c) {
+                    row[c] = multiplicity * (2 * run[c] + group[c]);
+                }
+                for (int i = begin; i < end; ++i) {
+                    int64_t *target = tally.halves.data() + comboClasses.classes[sorted[i]] * CLASS_COUNT;
+                    for (int c = 0; c < CLASS_COUNT; ++c) {
+                        target[c] += row[c];
+                    }
+                }
+                for (int i = begin; i < end; ++i) {
+                    int c = comboClasses.classes[sorted[i]];
+                    run[c] += group[c];
+                    group[c] = 0;
+                }
+                begin = end;
+            }
+
+            // 减去与英雄共享牌的组合（包括英雄自己）被多算的部分
+            for (int i = 0; i < liveCount; ++i) {
+                const int hero = live[i];
+                const uint64_t heroMask = COMBO_MASKS[hero];
+                const int heroStrength = handClass[hero];
+                int64_t *target = tally.halves.data() + comboClasses.classes[hero] * CLASS_COUNT;
+                const int first = __builtin_ctzll(heroMask);
+                const int second = 63 - __builtin_clzll(heroMask);
+                for (int card: {first, second}) {
+                    for (int villain: cardCombos[card]) {
+                        const int strength = handClass[villain];
+                        // 同时含有两张牌的只有英雄自己，在第二张牌时跳过
+                        if (strength < 0 || (card == second && (COMBO_MASKS[villain] >> first & 1))) {
+                            continue;
+                        }
+                        target[comboClasses.classes[villain]] -=
+                                multiplicity * ((strength < heroStrength) * 2 + (strength == heroStrength));
+                    }
+                }
+            }
+        }
+
+    private:
+        const ComboClasses &comboClasses;
+        std::vector<int> cardCombos[CARD_COUNT];
+        std::vector<int> bucketStart;
+        int handClass[COMBO_COUNT] = {};
+        int live[COMBO_COUNT] = {};
+        int sorted[COMBO_COUNT] = {};
+        int liveCount = 0;
+    };
+
+    // 两种起手牌之间不冲突的具体组合对数
+    std::vector<int64_t> matchupPairs(const ComboClasses &comboClasses) {
+        std::vector<int64_t> pairs(CLASS_COUNT * CLASS_COUNT, 0);
+        for (int hero = 0; hero < COMBO_COUNT; ++hero) {
+            for (int villain = 0; villain < COMBO_COUNT; ++villain) {
+                if ((COMBO_MASKS[hero] & COMBO_MASKS[villain]) == 0) {
+                    ++pairs[comboClasses.classes[hero] * CLASS_COUNT + comboClasses.classes[villain]];
+                }
+            }
+        }
+        return pairs;
+    }
+
+}
+
+void PreflopTable::generate(const std::string &path, const PreflopGenerateConfig &config) {
+    LookupEvaluator::initialize();
+    const ComboClasses comboClasses;
+
+    // 起手牌对起手牌：按花色同构只枚举规范的五张公共牌，再乘以重数
+    const std::vector<WeightedCards> boards = SuitIsomorphism::canonicalSets(5);
+    const int threadCount = resolveThreadCount(config.threads);
+    std::vector<MatchupTally> tallies(threadCount);
+    std::atomic<size_t> next{0};
+    constexpr size_t CHUNK = 256;
+    auto worker = [&](int threadIndex) {
+        BoardScorer scorer(comboClasses);
+        for (size_t begin = next.fetch_add(CHUNK); begin < boards.size(); begin = next.fetch_add(CHUNK)) {
+            const size_t end = std::min(boards.size(), begin + CHUNK);
+            for (size_t i = begin; i < end; ++i) {
+                scorer.score(boards[i].cards.getBits(), boards[i].multiplicity, tallies[threadIndex]);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threadCount; ++i) {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread &thread: pool) {
+        thread.join();
+    }
+
+    // 整数累加，与线程数和调度无关
+    std::vector<int64_t> halves(CLASS_COUNT * CLASS_COUNT, 0);
+    for (const MatchupTally &tally: tallies) {
+        for (size_t i = 0; i < halves.size(); ++i) {
+            halves[i] += tally.halves[i];
+        }
+    }
+    // 每对不冲突的组合都有 C(48, 5) 种公共牌
+    constexpr int64_t BOARDS_PER_PAIR = 1712304;
+    const std::vector<int64_t> pairs = matchupPairs(comboClasses);
+    std::vector<float> matchups(CLASS_COUNT * CLASS_COUNT);
+    for (size_t i = 0; i < matchups.size(); ++i) {
+        matchups[i] = static_cast<float>(static_cast<double>(halves[i]) / (2.0 * BOARDS_PER_PAIR * pairs[i]));
+    }
+
+    std::vector<float> vsRandom(RANDOM_ROWS * CLASS_COUNT);
+    for (int hand = 0; hand < CLASS_COUNT; ++hand) {
+        int64_t handHalves = 0;
+        int64_t handPairs = 0;
+        for (int villain = 0; villain < CLASS_COUNT; ++villain) {
+            handHalves += halves[hand * CLASS_COUNT + villain];
+            handPairs += pairs[hand * CLASS_COUNT + villain];
+        }
+        vsRandom[hand] = static_cast<float>(static_cast<double>(handHalves) / (2.0 * BOARDS_PER_PAIR * handPairs));
+    }
+    for (int players = 3; players <= MAX_PLAYERS; ++players) {
+        for (int hand = 0; hand < CLASS_COUNT; ++hand) {
+            EquityCalculator calculator(representative(hand));
+            calculator.addRandomOpponents(players - 1);
+            EquityConfig equityConfig;
+            equityConfig.threads = config.threads;
+            equityConfig.maxTrials = config.randomTrials;
+            equityConfig.minTrials = config.randomTrials;
+            equityConfig.seed = config.seed + static_cast<uint64_t>(players) * CLASS_COUNT + hand;
+            vsRandom[(players - 2) * CLASS_COUNT + hand] = static_cast<float>(calculator.monteCarlo(equityConfig).equity);
+        }
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.classCount = CLASS_COUNT;
+    header.maxPlayers = MAX_PLAYERS;
+    header.randomTrials = config.randomTrials;
+    header.matchupOffset = alignUp(sizeof(FileHeader));
+    header.randomOffset = alignUp(header.matchupOffset + matchups.size() * sizeof(float));
+    header.fileSize = header.randomOffset + vsRandom.size() * sizeof(float);
+
+    std::vector<unsigned char> body(header.fileSize - sizeof(FileHeader), 0);
+    std::memcpy(body.data() + header.matchupOffset - sizeof(FileHeader), matchups.data(), matchups.size() * sizeof(float));
+    std::memcpy(body.data() + header.randomOffset - sizeof(FileHeader), vsRandom.data(), vsRandom.size() * sizeof(float));
+    header.checksum = fnv1a(body.data(), body.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(body.data()), static_cast<std::streamsize>(body.size()));
+    if (!out) {
+        throw std::runtime_error("cannot write preflop table: " + path);
+    }
+}
+
+std::optional<PreflopTable> PreflopTable::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    const auto *header = static_cast<const FileHeader *>(mapping);
+    const bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION &&
+                       header->byteOrder == BYTE_ORDER_MARK && header->classCount == CLASS_COUNT &&
+                       header->maxPlayers == MAX_PLAYERS && header->fileSize == size &&
+                       header->matchupOffset + CLASS_COUNT * CLASS_COUNT * sizeof(float) <= size &&
+                       header->randomOffset + RANDOM_ROWS * CLASS_COUNT * sizeof(float) <= size;
+    if (!valid) {
+        munmap(mapping, size);
+        return std::nullopt;
+    }
+    return PreflopTable(mapping, size);
+}
+
+PreflopTable::PreflopTable(void *mapping, size_t size) : mapping(mapping), mappingSize(size) {
+    const auto *bytes = static_cast<const unsigned char *>(mapping);
+    const auto *header = static_cast<const FileHeader *>(mapping);
+    matchups = reinterpret_cast<const float *>(bytes + header->matchupOffset);
+    vsRandom = reinterpret_cast<const float *>(bytes + header->randomOffset);
+}
+
+PreflopTable::PreflopTable(PreflopTable &&other) noexcept
+        : mapping(other.mapping), mappingSize(other.mappingSize), matchups(other.matchups), vsRandom(other.vsRandom) {
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+}
+
+PreflopTable &PreflopTable::operator=(PreflopTable &&other) noexcept {
+    if (this != &other) {
+        if (mapping != nullptr) {
+            munmap(mapping, mappingSize);
+        }
+        mapping = other.mapping;
+        mappingSize = other.mappingSize;
+        matchups = other.matchups;
+        vsRandom = other.vsRandom;
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+    }
+    return *this;
+}
+
+PreflopTable::~PreflopTable() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+}
+
+uint64_t PreflopTable::getRandomTrials() const {
+    return static_cast<const FileHeader *>(mapping)->randomTrials;
+}
+
+bool PreflopTable::verify() const {
+    const auto *header = static_cast<const FileHeader *>(mapping);
+    const auto *bytes = static_cast<const unsigned char *>(mapping);
+    return fnv1a(bytes + sizeof(FileHeader), mappingSize - sizeof(FileHeader)) == header->checksum;
+}
+
+int PreflopTable::classOf(CardSet hole) {
+    const uint64_t bits = hole.getBits();
+    const int low = __builtin_ctzll(bits);
+    const int high = 63 - __builtin_clzll(bits);
+    // 行列编号中 A 为 0，2 为 12
+    int first = RANK_COUNT - 1 - high % RANK_COUNT;
+    int second = RANK_COUNT - 1 - low % RANK_COUNT;
+    if (first > second) {
+        std::swap(first, second);
+    }
+    if (first == second) {
+        return first * RANK_COUNT + first;
+    }
+    const bool suited = high / RANK_COUNT == low / RANK_COUNT;
+    return suited ? first * RANK_COUNT + second : second * RANK_COUNT + first;
+}
+
+std::optional<int> PreflopTable::parseClass(std::string_view text) {
+    if (text.size() == 4) {
+        std::optional<CardSet> hole = CardSet::fromString(text);
+        if (!hole || hole->size() != 2) {
+            return std::nullopt;
+        }
+        return classOf(*hole);
+    }
+    if (text.size() < 2 || text.size() > 3) {
+        return std::nullopt;
+    }
+    const int high = charToRankStrength(text[0]);
+    const int low = charToRankStrength(text[1]);
+    if (high < 0 || low < 0) {
+        return std::nullopt;
+    }
+    const int first = RANK_COUNT - 1 - std::max(high, low);
+    const int second = RANK_COUNT - 1 - std::min(high, low);
+    if (first == second) {
+        return text.size() == 2 ? std::optional<int>(first * RANK_COUNT + first) : std::nullopt;
+    }
+    if (text.size() != 3 || (text[2] != 's' && text[2] != 'o')) {
+        return std::nullopt;
+    }
+    return text[2] == 's' ? first * RANK_COUNT + second : second * RANK_COUNT + first;
+}
+
+std::string PreflopTable::className(int hand) {
+    const int row = hand / RANK_COUNT;
+    const int column = hand % RANK_COUNT;
+    std::string name;
+    name += rankStrengthToChar(RANK_COUNT - 1 - std::min(row, column));
+    name += rankStrengthToChar(RANK_COUNT - 1 - std::max(row, column));
+    if (row < column) {
+        name += 's';
+    } else if (row > column) {
+        name += 'o';
+    }
+    return name;
+}
+
+int PreflopTable::comboCount(int hand) {
+    const int row = hand / RANK_COUNT;
+    const int column = hand % RANK_COUNT;
+    return row == column ? 6 : (row < column ? 4 : 12);
+}
+
+CardSet PreflopTable::representative(int hand) {
+    const int row = hand / RANK_COUNT;
+    const int column = hand % RANK_COUNT;
+    const int high = RANK_COUNT - 1 - std::min(row, column);
+    const int low = RANK_COUNT - 1 - std::max(row, column);
+    // 同花都用梅花，其余第二张用方块
+    const int secondSuit = row < column ? 0 : 1;
+    return CardSet((1ull << high) | (1ull << (secondSuit * RANK_COUNT + low)));
+}
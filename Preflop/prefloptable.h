@@ -0,0 +1,70 @@
+#ifndef PREFLOPTABLE_H
+#define PREFLOPTABLE_H
+
+#include "../Card/cardset.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+struct PreflopGenerateConfig {
+    int threads = 0;                 // 0 表示使用全部核心
+    uint64_t randomTrials = 200000;  // 3~9 人时每种起手牌对随机手牌的模拟局数
+    uint64_t seed = 0;
+};
+
+// 预先计算的翻前全下胜率表
+// 169 种起手牌按 13x13 网格编号：行、列为点数（A 在前），对角线为对子，
+// 右上三角为同花（行为大牌），左下三角为不同花（列为大牌），例如 AKs = 1，AKo = 13。
+//   matchup     起手牌对起手牌的胜率，对两种起手牌所有不冲突的具体组合取平均，精确枚举全部公共牌
+//   vs random   起手牌对 1~8 个随机手牌的胜率；2 人时由上表精确求得，3~9 人为固定种子的蒙特卡洛
+// generate() 写出带版本号的二进制文件，open() 用 mmap 映射，不解析、不复制，查询只是一次内存读取。
+class PreflopTable {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int CLASS_COUNT = 169;
+    static constexpr int MAX_PLAYERS = 9;
+
+    // 计算全部表并写入文件，写入失败时抛出 std::runtime_error
+    static void generate(const std::string &path, const PreflopGenerateConfig &config = PreflopGenerateConfig());
+    // 映射已生成的文件；文件不存在、格式或版本不符时返回空
+    static std::optional<PreflopTable> open(const std::string &path);
+
+    PreflopTable(PreflopTable &&other) noexcept;
+    PreflopTable &operator=(PreflopTable &&other) noexcept;
+    PreflopTable(const PreflopTable &) = delete;
+    PreflopTable &operator=(const PreflopTable &) = delete;
+    ~PreflopTable();
+
+    [[nodiscard]] float equity(int hero, int villain) const {
+        return matchups[hero * CLASS_COUNT + villain];
+    }
+    // players 为包括英雄在内的人数，2~9
+    [[nodiscard]] float equityVsRandom(int hand, int players) const {
+        return vsRandom[(players - 2) * CLASS_COUNT + hand];
+    }
+    [[nodiscard]] uint64_t getRandomTrials() const;
+    // 重新计算校验和，检查文件内容是否完整
+    [[nodiscard]] bool verify() const;
+
+    // 起手牌编号，hole 必须正好两张牌
+    static int classOf(CardSet hole);
+    // 解析 "AKs"、"AKo"、"TT"，也接受具体的两张牌，例如 "AsKs"
+    static std::optional<int> parseClass(std::string_view text);
+    static std::string className(int hand);
+    // 这种起手牌的具体组合数：对子 6，同花 4，不同花 12
+    static int comboCount(int hand);
+    // 这种起手牌的一个具体组合
+    static CardSet representative(int hand);
+
+private:
+    PreflopTable(void *mapping, size_t size);
+
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+    const float *matchups = nullptr;
+    const float *vsRandom = nullptr;
+};
+
+#endif  // PREFLOPTABLE_H
@@ -0,0 +1,145 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** 随机数生成器
+// 种子固定时结果可复现；jump() 相当于前进 2^128 步，用来给每个线程分出互不重叠的随机数流
+// 满足 UniformRandomBitGenerator，可以直接交给 std::shuffle 等标准算法使用
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) {
+        this->seed(seed);
+    }
+
+    void seed(uint64_t seed) {
+        // 用 splitmix64 把一个 64 位种子扩展成 256 位状态
+        for (uint64_t &word: state) {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // [0, bound) 内的均匀整数，用乘法代替取模
+    uint32_t bounded(uint32_t bound) {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+
+    void jump() {
+        static constexpr uint64_t JUMP[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                            0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+        uint64_t next[4] = {0, 0, 0, 0};
+        for (uint64_t jump: JUMP) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (jump & (1ull << bit)) {
+                    for (int i = 0; i < 4; ++i) {
+                        next[i] ^= state[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            state[i] = next[i];
+        }
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state[4];
+};
+
+// PCG32（XSH RR），状态只有 128 位，输出 32 位
+// 不同的 stream 产生互不相同的序列；advance() 可以前进任意步
+// jump() 不是前进固定步数（周期只有 2^64，跳半个周期两次就回到原处），而是切换到下一个 stream 并打散状态，
+// 给每个线程一个独立的随机数流
+class Pcg32 {
+public:
+    using result_type = uint32_t;
+
+    explicit Pcg32(uint64_t seed = 0, uint64_t stream = 0) {
+        this->seed(seed, stream);
+    }
+
+    void seed(uint64_t seed, uint64_t stream = 0) {
+        state = 0;
+        increment = (stream << 1) | 1;
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t old = state;
+        state = old * MULTIPLIER + increment;
+        const auto shifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        const auto rotation = static_cast<uint32_t>(old >> 59);
+        return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+    }
+
+    uint32_t bounded(uint32_t bound) {
+        return static_cast<uint32_t>(static_cast<uint64_t>((*this)()) * bound >> 32);
+    }
+
+    // 前进 delta 步，O(log delta)
+    void advance(uint64_t delta) {
+        uint64_t multiplier = MULTIPLIER;
+        uint64_t add = increment;
+        uint64_t accumulatedMultiplier = 1;
+        uint64_t accumulatedAdd = 0;
+        while (delta > 0) {
+            if (delta & 1) {
+                accumulatedMultiplier *= multiplier;
+                accumulatedAdd = accumulatedAdd * multiplier + add;
+            }
+            add = (multiplier + 1) * add;
+            multiplier *= multiplier;
+            delta >>= 1;
+        }
+        state = accumulatedMultiplier * state + accumulatedAdd;
+    }
+
+    // 只换 increment 而状态相同的两个 stream 输出高度相关，所以状态也用 splitmix64 重新混合
+    void jump() {
+        increment += 2;
+        uint64_t z = state + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        state = z ^ (z >> 31);
+    }
+
+private:
+    static constexpr uint64_t MULTIPLIER = 6364136223846793005ull;
+
+    uint64_t state = 0;
+    uint64_t increment = 1;
+};
+
+#endif  // RNG_H
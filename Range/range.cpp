@@ -0,0 +1,206 @@
+#include "range.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+Range::Range() : weights() {}
+
+Range Range::full() {
+    Range range;
+    range.weights.fill(1.0f);
+    return range;
+}
+
+std::optional<Range> Range::fromString(std::string_view text) {
+    Range range;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find_first_of(", ", start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view token = text.substr(start, end - start);
+        if (!token.empty() && !range.addToken(token)) {
+            return std::nullopt;
+        }
+        start = end + 1;
+    }
+    return range;
+}
+
+int Range::comboCount() const {
+    int count = 0;
+    for (float weight: weights) {
+        if (weight > 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+double Range::totalWeight() const {
+    double total = 0;
+    for (float weight: weights) {
+        total += weight;
+    }
+    return total;
+}
+
+Range Range::withoutBlocked(CardSet dead) const {
+    Range range = *this;
+    for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+        if (COMBO_MASKS[combo] & dead.getBits()) {
+            range.weights[combo] = 0;
+        }
+    }
+    return range;
+}
+
+void Range::addPair(int rank, float weight) {
+    for (int s1 = 0; s1 < SUIT_COUNT; ++s1) {
+        for (int s2 = s1 + 1; s2 < SUIT_COUNT; ++s2) {
+            weights[comboIndex(s1 * RANK_COUNT + rank, s2 * RANK_COUNT + rank)] = weight;
+        }
+    }
+}
+
+void Range::addNonPair(int high, int low, bool suited, bool offsuit, float weight) {
+    for (int s1 = 0; s1 < SUIT_COUNT; ++s1) {
+        for (int s2 = 0; s2 < SUIT_COUNT; ++s2) {
+            if ((s1 == s2 && suited) || (s1 != s2 && offsuit)) {
+                weights[comboIndex(s1 * RANK_COUNT + high, s2 * RANK_COUNT + low)] = weight;
+            }
+        }
+    }
+}
+
+// 一个范围片段：具体组合 "AhKh"、对子 "TT"、"TT+"、"TT-77"，
+// 非对子 "AK"、"AKs"、"AKo"、"A5s+"、"K9s-K6s"、"76s-54s"，都可以带 ":权重"
+bool Range::addToken(std::string_view token) {
+    float weight = 1.0f;
+    size_t colon = token.find(':');
+    if (colon != std::string_view::npos) {
+        std::string weightText(token.substr(colon + 1));
+        char *end = nullptr;
+        weight = std::strtof(weightText.c_str(), &end);
+        if (end == weightText.c_str() || *end != '\0' || weight < 0) {
+            return false;
+        }
+        token = token.substr(0, colon);
+    }
+
+    // 全部组合
+    if (token == "random" || token == "any") {
+        for (float &value: weights) {
+            value = weight;
+        }
+        return true;
+    }
+
+    // 具体组合
+    if (token.size() == 4 && charToRankStrength(token[1]) < 0) {
+        std::optional<Card> first = Card::fromString(token.substr(0, 2));
+        std::optional<Card> second = Card::fromString(token.substr(2, 2));
+        if (!first || !second || *first == *second) {
+            return false;
+        }
+        weights[comboIndex(first->getIndex(), second->getIndex())] = weight;
+        return true;
+    }
+
+    // 解析 "XY[s|o]" 形式的一段，返回读取的字符数
+    struct Hand {
+        int high = -1;
+        int low = -1;
+        bool suited = true;
+        bool offsuit = true;
+    };
+    auto parseHand = [](std::string_view text, Hand &hand) -> size_t {
+        if (text.size() < 2) {
+            return 0;
+        }
+        int first = charToRankStrength(text[0]);
+        int second = charToRankStrength(text[1]);
+        if (first < 0 || second < 0) {
+            return 0;
+        }
+        hand.high = std::max(first, second);
+        hand.low = std::min(first, second);
+        if (text.size() > 2 && (text[2] == 's' || text[2] == 'o')) {
+            if (hand.high == hand.low) {
+                return 0;
+            }
+            hand.suited = text[2] == 's';
+            hand.offsuit = text[2] == 'o';
+            return 3;
+        }
+        return 2;
+    };
+
+    Hand from;
+    size_t used = parseHand(token, from);
+    if (used == 0) {
+        return false;
+    }
+    std::string_view rest = token.substr(used);
+    const bool pair = from.high == from.low;
+
+    if (rest.empty()) {
+        if (pair) {
+            addPair(from.high, weight);
+        } else {
+            addNonPair(from.high, from.low, from.suited, from.offsuit, weight);
+        }
+        return true;
+    }
+
+    if (rest == "+") {
+        if (pair) {
+            for (int rank = from.high; rank < RANK_COUNT; ++rank) {
+                addPair(rank, weight);
+            }
+        } else {
+            // 高牌不变，踢脚一直升到比高牌小一级
+            for (int low = from.low; low < from.high; ++low) {
+                addNonPair(from.high, low, from.suited, from.offsuit, weight);
+            }
+        }
+        return true;
+    }
+
+    if (rest[0] != '-') {
+        return false;
+    }
+    Hand to;
+    if (parseHand(rest.substr(1), to) != rest.size() - 1) {
+        return false;
+    }
+    if (pair) {
+        if (to.high != to.low) {
+            return false;
+        }
+        for (int rank = std::min(from.high, to.high); rank <= std::max(from.high, to.high); ++rank) {
+            addPair(rank, weight);
+        }
+        return true;
+    }
+    if (to.high == to.low || to.suited != from.suited || to.offsuit != from.offsuit) {
+        return false;
+    }
+    if (to.high == from.high) {
+        // 高牌相同，踢脚连续，例如 K9s-K6s
+        for (int low = std::min(from.low, to.low); low <= std::max(from.low, to.low); ++low) {
+            addNonPair(from.high, low, from.suited, from.offsuit, weight);
+        }
+        return true;
+    }
+    if (to.high - to.low == from.high - from.low) {
+        // 间隔相同，两张牌一起变化，例如 76s-54s
+        int gap = from.high - from.low;
+        for (int high = std::min(from.high, to.high); high <= std::max(from.high, to.high); ++high) {
+            addNonPair(high, high - gap, from.suited, from.offsuit, weight);
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,63 @@
+#ifndef RANGE_H
+#define RANGE_H
+
+#include "../Card/cardset.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// 两张底牌的组合编号：两张牌编号 a < b 时 combo = b * (b - 1) / 2 + a，共 1326 种
+constexpr int COMBO_COUNT = CARD_COUNT * (CARD_COUNT - 1) / 2;
+
+constexpr int comboIndex(CardIndex a, CardIndex b) {
+    return a < b ? b * (b - 1) / 2 + a : a * (a - 1) / 2 + b;
+}
+
+constexpr std::array<uint64_t, COMBO_COUNT> makeComboMasks() {
+    std::array<uint64_t, COMBO_COUNT> masks{};
+    for (int b = 1; b < CARD_COUNT; ++b) {
+        for (int a = 0; a < b; ++a) {
+            masks[comboIndex(a, b)] = (1ull << a) | (1ull << b);
+        }
+    }
+    return masks;
+}
+
+// 每个组合对应的两张牌的位掩码
+inline constexpr std::array<uint64_t, COMBO_COUNT> COMBO_MASKS = makeComboMasks();
+
+// 范围：1326 种底牌组合，每种带一个权重
+// 支持常见写法，例如 "AKs, TT+, 76s-54s, A5s+, KQo, AhKh, QQ:0.5"，"random" 表示全部组合
+class Range {
+public:
+    Range();
+
+    // 解析范围字符串，格式不对时返回空
+    static std::optional<Range> fromString(std::string_view text);
+    static Range full();
+
+    [[nodiscard]] static CardSet comboCards(int combo) {
+        return CardSet(COMBO_MASKS[combo]);
+    }
+
+    [[nodiscard]] float getWeight(int combo) const { return weights[combo]; }
+    void setWeight(int combo, float weight) { weights[combo] = weight; }
+    [[nodiscard]] const float *data() const { return weights.data(); }
+
+    // 权重大于 0 的组合数
+    [[nodiscard]] int comboCount() const;
+    [[nodiscard]] double totalWeight() const;
+
+    // 去掉与死牌冲突的组合
+    [[nodiscard]] Range withoutBlocked(CardSet dead) const;
+
+private:
+    std::array<float, COMBO_COUNT> weights;
+
+    bool addToken(std::string_view token);
+    void addPair(int rank, float weight);
+    void addNonPair(int high, int low, bool suited, bool offsuit, float weight);
+};
+
+#endif  // RANGE_H
@@ -0,0 +1,298 @@
+#include "boardreport.h"
+#include "../Card/isomorphism.h"
+#include "../Concurrency/boundedqueue.h"
+#include "../Concurrency/threads.h"
+#include "../Equity/rangeequity.h"
+#include "../pokerHand/lookupevaluator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr char MAGIC[8] = {'A', 'Y', 'R', 'P', 'T', 0, 0, 0};
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t rowCount;
+        uint64_t board;          // 给定的公共牌，之后为 rowCount 条 Record
+    };
+    static_assert(sizeof(FileHeader) == 32, "file header layout changed");
+
+    struct Record {
+        uint64_t board;
+        uint32_t multiplicity;
+        uint16_t heroCombos;
+        uint16_t villainCombos;
+        double weight;
+        double equity;
+        double ev;
+        float handTypes[HAND_TYPE_COUNT];
+        float heroWeight;
+    };
+    static_assert(sizeof(Record) == 80, "record layout changed");
+
+    // 规范化阶段交给求值阶段的一副公共牌
+    struct BoardTask {
+        uint64_t sequence = 0;
+        CardSet board;
+        int multiplicity = 1;
+    };
+
+    struct BoardResult {
+        uint64_t sequence = 0;
+        BoardReportRow row;
+    };
+
+    const char *handTypeName(HandType type) {
+        switch (type) {
+            case HandType::HIGH_CARD:
+                return "high_card";
+            case HandType::PAIR:
+                return "pair";
+            case HandType::TWO_PAIR:
+                return "two_pair";
+            case HandType::THREE_OF_A_KIND:
+                return "three_of_a_kind";
+            case HandType::STRAIGHT:
+                return "straight";
+            case HandType::FLUSH:
+                return "flush";
+            case HandType::FULL_HOUSE:
+                return "full_house";
+            case HandType::FOUR_OF_A_KIND:
+                return "four_of_a_kind";
+            case HandType::STRAIGHT_FLUSH:
+                return "straight_flush";
+        }
+        return "?";
+    }
+
+    int lowestCard(uint64_t mask) {
+        return __builtin_ctzll(mask);
+    }
+
+    // 交换两种花色后范围不变
+    bool swapInvariant(const Range &range, int a, int b) {
+        SuitPermutation swap = {0, 1, 2, 3};
+        std::swap(swap[a], swap[b]);
+        for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+            const uint64_t mask = SuitIsomorphism::apply(Range::comboCards(combo), swap).getBits();
+            const int image = comboIndex(lowestCard(mask), lowestCard(mask & (mask - 1)));
+            if (range.getWeight(combo) != range.getWeight(image)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 两个范围都允许互换的花色给相同的标号
+    // 两个对换都保持范围不变时它们的复合也保持，所以"可以对换"是等价关系，每类内任意置换都保持范围不变
+    std::array<uint8_t, SUIT_COUNT> suitLabels(const Range &hero, const Range &villain) {
+        std::array<uint8_t, SUIT_COUNT> labels = {0, 1, 2, 3};
+        for (int suit = 1; suit < SUIT_COUNT; ++suit) {
+            for (int earlier = 0; earlier < suit; ++earlier) {
+                if (labels[earlier] == earlier && swapInvariant(hero, earlier, suit) &&
+                    swapInvariant(villain, earlier, suit)) {
+                    labels[suit] = static_cast<uint8_t>(earlier);
+                    break;
+                }
+            }
+        }
+        return labels;
+    }
+
+    BoardReportRow evaluateBoard(const Range &hero, const Range &villain, const BoardTask &task,
+                                 const BoardReportConfig &config) {
+        BoardReportRow row;
+        row.board = task.board;
+        row.multiplicity = task.multiplicity;
+
+        RangeEquityConfig equityConfig;
+        equityConfig.threads = 1;
+        equityConfig.exactRunouts = config.runoutSamples == 0;
+        equityConfig.boardSamples = config.runoutSamples;
+        equityConfig.seed = config.seed + task.sequence * 0x9E3779B97F4A7C15ull;
+        const RangeEquityResult result = RangeEquity::compute(hero, villain, task.board, equityConfig);
+        row.weight = result.matchupWeight;
+        row.equity = result.equity;
+        row.ev = result.equity * (config.pot + 2 * config.stake) - config.stake;
+
+        const uint64_t board = task.board.getBits();
+        for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+            if ((COMBO_MASKS[combo] & board) != 0) {
+                continue;
+            }
+            row.villainCombos += villain.getWeight(combo) > 0;
+            const float weight = hero.getWeight(combo);
+            if (weight > 0) {
+                ++row.heroCombos;
+                row.heroWeight += weight;
+                const HandType type = LookupEvaluator::handType(LookupEvaluator::evaluate(COMBO_MASKS[combo] | board));
+                row.handTypes[static_cast<int>(type)] += weight;
+            }
+        }
+        if (row.heroWeight > 0) {
+            for (double &share: row.handTypes) {
+                share /= row.heroWeight;
+            }
+        }
+        return row;
+    }
+
+    void writeCsvHeader(std::ofstream &out) {
+        out << "board,multiplicity,hero_combos,villain_combos,hero_weight,weight,equity,ev";
+        for (int type = 0; type < HAND_TYPE_COUNT; ++type) {
+            out << ',' << handTypeName(static_cast<HandType>(type));
+        }
+        out << '\n';
+    }
+
+    void writeCsvRow(std::ofstream &out, const BoardReportRow &row) {
+        out << row.board.toString() << ',' << row.multiplicity << ',' << row.heroCombos << ',' << row.villainCombos
+            << ',' << row.heroWeight << ',' << row.weight << ',' << row.equity << ',' << row.ev;
+        for (double share: row.handTypes) {
+            out << ',' << share;
+        }
+        out << '\n';
+    }
+
+    void writeRecord(std::ofstream &out, const BoardReportRow &row) {
+        Record record{};
+        record.board = row.board.getBits();
+        record.multiplicity = static_cast<uint32_t>(row.multiplicity);
+        record.heroCombos = static_cast<uint16_t>(row.heroCombos);
+        record.villainCombos = static_cast<uint16_t>(row.villainCombos);
+        record.weight = row.weight;
+        record.equity = row.equity;
+        record.ev = row.ev;
+        for (int type = 0; type < HAND_TYPE_COUNT; ++type) {
+            record.handTypes[type] = static_cast<float>(row.handTypes[type]);
+        }
+        record.heroWeight = static_cast<float>(row.heroWeight);
+        out.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+
+}
+
+BoardReportStats BoardReport::generate(const Range &hero, const Range &villain, CardSet board,
+                                       const std::string &output, const BoardReportConfig &config) {
+    const int boardCards = config.boardCards > 0 ? config.boardCards : (board.size() == 0 ? 3 : board.size() + 1);
+    if (board.size() > 4 || (board.size() > 0 && board.size() < 3) || boardCards < 3 || boardCards > 5 ||
+        boardCards <= board.size()) {
+        throw std::invalid_argument("report needs 0, 3 or 4 board cards and a larger board size of 3 to 5");
+    }
+    const auto start = std::chrono::steady_clock::now();
+    LookupEvaluator::initialize();
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    FileHeader header{};
+    if (config.format == ReportFormat::BINARY) {
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.recordSize = sizeof(Record);
+        header.board = board.getBits();
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    } else {
+        out.precision(6);
+        writeCsvHeader(out);
+    }
+    if (!out) {
+        throw std::runtime_error("cannot write report: " + output);
+    }
+
+    const int threads = resolveThreadCount(config.threads);
+    BoundedQueue<BoardTask> tasks(2 * static_cast<size_t>(threads));
+    BoundedQueue<BoardResult> results(2 * static_cast<size_t>(threads));
+
+    // 规范化：只在范围和给定公共牌都区分不开的花色之间合并
+    std::thread canonicalizer([&]() {
+        const SuitSymmetry symmetry({board}, suitLabels(hero, villain));
+        uint64_t sequence = 0;
+        for (const WeightedCards &cards: SuitIsomorphism::canonicalSets(boardCards - board.size(), symmetry, board)) {
+            tasks.push({sequence++, board | cards.cards, cards.multiplicity});
+        }
+        tasks.close();
+    });
+
+    // 求值：最后一个退出的线程关闭结果队列
+    std::atomic<int> running{threads};
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&]() {
+            while (std::optional<BoardTask> task = tasks.pop()) {
+                results.push({task->sequence, evaluateBoard(hero, villain, *task, config)});
+            }
+            if (running.fetch_sub(1) == 1) {
+                results.close();
+            }
+        });
+    }
+
+    // 汇总与写出：乱序到达的结果按序号排好再写，每行只有几十字节，缓存不会很大
+    BoardReportStats stats;
+    double weightSum = 0;
+    double equitySum = 0;
+    double evSum = 0;
+    double heroWeightSum = 0;
+    std::map<uint64_t, BoardReportRow> pending;
+    while (std::optional<BoardResult> result = results.pop()) {
+        pending.emplace(result->sequence, result->row);
+        while (!pending.empty() && pending.begin()->first == stats.rows) {
+            const BoardReportRow &row = pending.begin()->second;
+            if (out) {
+                if (config.format == ReportFormat::BINARY) {
+                    writeRecord(out, row);
+                } else {
+                    writeCsvRow(out, row);
+                }
+            }
+            const double weight = row.multiplicity * row.weight;
+            weightSum += weight;
+            equitySum += weight * row.equity;
+            evSum += weight * row.ev;
+            const double heroWeight = row.multiplicity * row.heroWeight;
+            heroWeightSum += heroWeight;
+            for (int type = 0; type < HAND_TYPE_COUNT; ++type) {
+                stats.handTypes[type] += heroWeight * row.handTypes[type];
+            }
+            stats.boards += row.multiplicity;
+            ++stats.rows;
+            pending.erase(pending.begin());
+        }
+    }
+    canonicalizer.join();
+    for (std::thread &worker: workers) {
+        worker.join();
+    }
+
+    if (config.format == ReportFormat::BINARY) {
+        header.rowCount = stats.rows;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    out.close();
+    if (!out) {
+        throw std::runtime_error("cannot write report: " + output);
+    }
+
+    if (weightSum > 0) {
+        stats.equity = equitySum / weightSum;
+        stats.ev = evSum / weightSum;
+    }
+    if (heroWeightSum > 0) {
+        for (double &share: stats.handTypes) {
+            share /= heroWeightSum;
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
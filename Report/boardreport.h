@@ -0,0 +1,68 @@
+#ifndef BOARDREPORT_H
+#define BOARDREPORT_H
+
+#include "../Card/cardset.h"
+#include "../Range/range.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+constexpr int HAND_TYPE_COUNT = 9;
+
+enum class ReportFormat {
+    CSV,     // 每副公共牌一行文本，第一行为列名
+    BINARY   // 定长记录，见 BoardReport 的说明
+};
+
+struct BoardReportConfig {
+    int threads = 0;               // 求值线程数，0 表示使用全部核心
+    int boardCards = 0;            // 报告的公共牌张数（3~5），0 表示给定公共牌的下一条街
+    uint64_t runoutSamples = 0;    // 每副公共牌随机抽取的剩余发法数，0 表示精确枚举
+    double pot = 1;                // 当前底池
+    double stake = 0;              // 双方各自再投入的筹码（例如全下时的有效筹码）
+    ReportFormat format = ReportFormat::CSV;
+    uint64_t seed = 0;
+};
+
+// 一副公共牌的结果
+struct BoardReportRow {
+    CardSet board;
+    int multiplicity = 1;     // 与它同构、结果相同的公共牌个数（含自身）
+    int heroCombos = 0;       // 与公共牌不冲突的组合数
+    int villainCombos = 0;
+    double heroWeight = 0;    // 与公共牌不冲突的英雄组合权重之和
+    double weight = 0;        // 组合对与剩余发法的权重总和，跨公共牌汇总胜率时按它加权
+    double equity = 0;        // 英雄范围的胜率（平局算一半）
+    double ev = 0;            // 英雄的期望收益：equity × (pot + 2 × stake) - stake
+    std::array<double, HAND_TYPE_COUNT> handTypes{};  // 英雄范围在这副公共牌上各牌型的权重比例
+};
+
+struct BoardReportStats {
+    uint64_t rows = 0;        // 写出的行数（规范公共牌数）
+    uint64_t boards = 0;      // 覆盖的公共牌数（重数之和）
+    double equity = 0;        // 按重数 × 权重汇总的整体结果
+    double ev = 0;
+    std::array<double, HAND_TYPE_COUNT> handTypes{};  // 按重数 × 英雄范围权重汇总
+    double seconds = 0;
+};
+
+// 逐公共牌报告：给定公共牌（0~4 张）之后每一种发法的英雄胜率、EV 和牌型分布
+// 例如不给公共牌时报告全部翻牌，给翻牌时报告每张转牌，boardCards = 5 时报告每种转牌加河牌。
+// 三段流水线：规范化线程按花色同构列出公共牌代表，多个求值线程各自用 RangeEquity 计算一副公共牌，
+// 调用线程按原顺序汇总并写出；阶段之间用有界队列连接。
+// 同构只在两个范围和给定公共牌都不区分的花色之间进行，范围对花色不对称时照样正确，只是行数更多。
+// 结果与线程数无关。
+//
+// 二进制文件：32 字节文件头（magic "AYRPT"、版本、记录大小、行数、给定的公共牌），
+// 之后每行一条 80 字节的记录：board u64  multiplicity u32  heroCombos u16  villainCombos u16
+//   weight f64  equity f64  ev f64  handTypes f32[9]（按 HandType 顺序）  heroWeight f32
+class BoardReport {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // 公共牌张数不对时抛出 std::invalid_argument，输出写入失败时抛出 std::runtime_error
+    static BoardReportStats generate(const Range &hero, const Range &villain, CardSet board,
+                                     const std::string &output, const BoardReportConfig &config = BoardReportConfig());
+};
+
+#endif  // BOARDREPORT_H
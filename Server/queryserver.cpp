@@ -0,0 +1,421 @@
+#include "queryserver.h"
+#include "../Equity/equity.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../pokerHand/pokerhand.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    // 一次并行处理的最多请求数
+    constexpr size_t STREAM_BATCH = 1024;
+    constexpr uint64_t EQUITY_SEED = 0x5EED;
+
+    std::vector<std::string_view> splitWords(std::string_view text) {
+        std::vector<std::string_view> words;
+        size_t start = 0;
+        while (start < text.size()) {
+            while (start < text.size() && (text[start] == ' ' || text[start] == '\t' || text[start] == '\r')) {
+                ++start;
+            }
+            size_t end = start;
+            while (end < text.size() && text[end] != ' ' && text[end] != '\t' && text[end] != '\r') {
+                ++end;
+            }
+            if (end > start) {
+                words.push_back(text.substr(start, end - start));
+            }
+            start = end;
+        }
+        return words;
+    }
+
+    const char *handTypeName(HandType type) {
+        switch (type) {
+            case HandType::HIGH_CARD:
+                return "high_card";
+            case HandType::PAIR:
+                return "pair";
+            case HandType::TWO_PAIR:
+                return "two_pair";
+            case HandType::THREE_OF_A_KIND:
+                return "three_of_a_kind";
+            case HandType::STRAIGHT:
+                return "straight";
+            case HandType::FLUSH:
+                return "flush";
+            case HandType::FULL_HOUSE:
+                return "full_house";
+            case HandType::FOUR_OF_A_KIND:
+                return "four_of_a_kind";
+            case HandType::STRAIGHT_FLUSH:
+                return "straight_flush";
+        }
+        return "?";
+    }
+
+    // 查询中的行动写法：下注和加注带上金额，例如 bet33
+    std::string actionLabel(const Action &action) {
+        std::ostringstream label;
+        label << actionName(action.type);
+        if (action.type == ActionType::BET || action.type == ActionType::RAISE) {
+            label << action.amount;
+        }
+        return label.str();
+    }
+
+    SuitPermutation inverse(const SuitPermutation &permutation) {
+        SuitPermutation result{};
+        for (int s = 0; s < SUIT_COUNT; ++s) {
+            result[permutation[s]] = static_cast<uint8_t>(s);
+        }
+        return result;
+    }
+
+    std::optional<CardSet> parseCards(std::string_view text, int minCount, int maxCount) {
+        std::optional<CardSet> cards = CardSet::fromString(text);
+        if (!cards || cards->size() < minCount || cards->size() > maxCount) {
+            return std::nullopt;
+        }
+        return cards;
+    }
+
+}
+
+QueryServer::QueryServer(const ServerConfig &config)
+        : config(config), scheduler(config.threads), cache(config.cacheSize) {
+    LookupEvaluator::initialize();
+    if (!config.preflopPath.empty()) {
+        preflop = PreflopTable::open(config.preflopPath);
+        if (!preflop) {
+            throw std::runtime_error("invalid preflop table: " + config.preflopPath);
+        }
+    }
+    for (const std::string &path: config.strategyPaths) {
+        std::optional<Checkpoint> checkpoint = Checkpoint::open(path);
+        if (!checkpoint || !checkpoint->hasSection(CheckpointSection::STRATEGY_SUMS)) {
+            throw std::runtime_error("invalid strategy file: " + path);
+        }
+        const CardSet board = checkpoint->getTree().getBoard();
+        const SuitPermutation permutation = SuitIsomorphism::canonicalPermutation({board});
+        const CardSet canonicalBoard = SuitIsomorphism::apply(board, permutation);
+        spots.push_back({std::move(*checkpoint), canonicalBoard, inverse(permutation)});
+    }
+}
+
+std::string QueryServer::answer(std::string_view request) {
+    const std::vector<std::string_view> words = splitWords(request);
+    if (words.empty()) {
+        return "error empty request";
+    }
+    try {
+        if (words[0] == "eval") {
+            return evaluate(words);
+        }
+        if (words[0] == "equity") {
+            return equity(words);
+        }
+        if (words[0] == "strategy") {
+            return strategy(words);
+        }
+        if (words[0] == "stats") {
+            const auto stats = cache.stats();
+            return "ok hits " + std::to_string(stats.hits) + " misses " + std::to_string(stats.misses) +
+                   " coalesced " + std::to_string(stats.coalesced);
+        }
+        return "error unknown command: " + std::string(words[0]);
+    } catch (const std::exception &error) {
+        return std::string("error ") + error.what();
+    }
+}
+
+// 单次求值只要几十纳秒，比查缓存还快，不经过缓存
+std::string QueryServer::evaluate(const std::vector<std::string_view> &words) const {
+    if (words.size() < 2 || words.size() > 3) {
+        return "error usage: eval <hand> [board]";
+    }
+    const std::optional<CardSet> hole = parseCards(words[1], 1, 7);
+    const std::optional<CardSet> board = words.size() == 3 ? parseCards(words[2], 0, 5) : CardSet();
+    if (!hole || !board || hole->intersects(*board) || (*hole | *board).size() < 5 || (*hole | *board).size() > 7) {
+        return "error need 5 to 7 distinct cards";
+    }
+    const uint32_t strength = LookupEvaluator::evaluate(*hole | *board);
+    return std::string("ok ") + handTypeName(LookupEvaluator::handType(strength)) + " " + std::to_string(strength) +
+           " " + PokerHand::getBestHand(*hole, *board).toString();
+}
+
+std::string QueryServer::equity(const std::vector<std::string_view> &words) {
+    std::vector<std::string_view> opponents;
+    CardSet board;
+    for (size_t i = 2; i < words.size(); ++i) {
+        if (words[i] == "board" && i + 1 < words.size()) {
+            std::optional<CardSet> parsed = parseCards(words[++i], 0, 5);
+            if (!parsed) {
+                return "error invalid board";
+            }
+            board = *parsed;
+        } else {
+            opponents.push_back(words[i]);
+        }
+    }
+    const std::optional<CardSet> hero = words.size() > 1 ? parseCards(words[1], 2, 2) : std::nullopt;
+    if (!hero || opponents.empty() || static_cast<int>(opponents.size()) > EquityCalculator::MAX_OPPONENTS) {
+        return "error usage: equity <hand> <opponent|random|class>... [board <cards>]";
+    }
+
+    // 具体手牌按花色同构规范化，同构的查询得到同一个键
+    std::vector<CardSet> rounds = {*hero};
+    std::vector<CardSet> hands;
+    std::vector<int> classes;
+    int randoms = 0;
+    for (std::string_view opponent: opponents) {
+        if (opponent == "random") {
+            ++randoms;
+        } else if (std::optional<CardSet> hand = parseCards(opponent, 2, 2)) {
+            hands.push_back(*hand);
+            rounds.push_back(*hand);
+        } else if (std::optional<int> handClass = PreflopTable::parseClass(opponent)) {
+            classes.push_back(*handClass);
+        } else {
+            return "error invalid opponent: " + std::string(opponent);
+        }
+    }
+    if (!classes.empty() && (!preflop || !board.empty() || opponents.size() != 1)) {
+        return "error hand classes need a preflop table, an empty board and one opponent";
+    }
+    rounds.push_back(board);
+    const SuitPermutation permutation = SuitIsomorphism::canonicalPermutation(rounds);
+    std::string key = "equity " + SuitIsomorphism::apply(*hero, permutation).toString();
+    for (CardSet &hand: hands) {
+        hand = SuitIsomorphism::apply(hand, permutation);
+        key += " " + hand.toString();
+    }
+    for (int handClass: classes) {
+        key += " " + PreflopTable::className(handClass);
+    }
+    key += " random" + std::to_string(randoms) + " board " + SuitIsomorphism::apply(board, permutation).toString();
+
+    return cache.getOrCompute(key, [&]() {
+        const CardSet canonicalHero = SuitIsomorphism::apply(*hero, permutation);
+        const CardSet canonicalBoard = SuitIsomorphism::apply(board, permutation);
+        double value;
+        if (preflop && board.empty() && hands.empty()) {
+            const int heroClass = PreflopTable::classOf(canonicalHero);
+            value = classes.empty() ? preflop->equityVsRandom(heroClass, randoms + 1)
+                                    : preflop->equity(heroClass, classes[0]);
+        } else {
+            EquityCalculator calculator(canonicalHero, canonicalBoard);
+            for (CardSet hand: hands) {
+                calculator.addOpponent(hand);
+            }
+            // 每个查询只用一个线程，服务的并行来自同时处理的多个查询
+            if (randoms == 0) {
+                value = calculator.enumerate(1).equity;
+            } else {
+                calculator.addRandomOpponents(randoms);
+                EquityConfig equityConfig;
+                equityConfig.threads = 1;
+                equityConfig.maxTrials = config.trials;
+                equityConfig.minTrials = config.trials;
+                equityConfig.seed = EQUITY_SEED;
+                value = calculator.monteCarlo(equityConfig).equity;
+            }
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), "ok %.6f", value);
+        return std::string(text);
+    });
+}
+
+std::string QueryServer::strategy(const std::vector<std::string_view> &words) {
+    if (words.size() < 3 || words.size() > 4) {
+        return "error usage: strategy <board> <hand> [actions]";
+    }
+    const std::optional<CardSet> board = parseCards(words[1], 4, 5);
+    const std::optional<CardSet> hole = parseCards(words[2], 2, 2);
+    if (!board || !hole || board->intersects(*hole)) {
+        return "error invalid board or hand";
+    }
+    const SuitPermutation permutation = SuitIsomorphism::canonicalPermutation({*board});
+    const CardSet canonicalBoard = SuitIsomorphism::apply(*board, permutation);
+    size_t index = 0;
+    while (index < spots.size() && spots[index].canonicalBoard != canonicalBoard) {
+        ++index;
+    }
+    if (index == spots.size()) {
+        return "error no strategy for this board";
+    }
+    const Spot &spot = spots[index];
+    auto toSpot = [&](CardSet cards) {
+        return SuitIsomorphism::apply(SuitIsomorphism::apply(cards, permutation), spot.fromCanonical);
+    };
+
+    // 沿行动序列走到查询的节点
+    const GameTree &tree = spot.checkpoint.getTree();
+    int node = tree.getRoot();
+    std::string_view path = words.size() == 4 ? words[3] : std::string_view();
+    while (!path.empty()) {
+        const size_t comma = path.find(',');
+        const std::string_view step = path.substr(0, comma);
+        path = comma == std::string_view::npos ? std::string_view() : path.substr(comma + 1);
+        int next = -1;
+        if (tree.getType(node) == NodeType::CHANCE) {
+            const std::optional<CardSet> card = parseCards(step, 1, 1);
+            const CardSet mapped = card ? toSpot(*card) : CardSet();
+            for (int i = 0; i < tree.getChildCount(node) && card; ++i) {
+                if (mapped.contains(Card(tree.getCard(node, i)))) {
+                    next = tree.getChild(node, i);
+                }
+            }
+        } else if (tree.getType(node) == NodeType::ACTION) {
+            for (int i = 0; i < tree.getChildCount(node); ++i) {
+                if (actionLabel(tree.getAction(node, i)) == step) {
+                    next = tree.getChild(node, i);
+                }
+            }
+        }
+        if (next < 0) {
+            return "error no such action: " + std::string(step);
+        }
+        node = next;
+    }
+    if (tree.getType(node) != NodeType::ACTION) {
+        return "error the hand is over";
+    }
+
+    const CardSet mappedHole = toSpot(*hole);
+    const int player = tree.getPlayer(node);
+    const uint64_t bits = mappedHole.getBits();
+    const int hand = spot.checkpoint.findHand(
+            player, comboIndex(static_cast<CardIndex>(__builtin_ctzll(bits)), static_cast<CardIndex>(63 - __builtin_clzll(bits))));
+    if (hand < 0) {
+        return "error hand is not in the player's range";
+    }
+    const std::string key = "strategy " + std::to_string(index) + " " + std::to_string(node) + " " + std::to_string(hand);
+    return cache.getOrCompute(key, [&]() {
+        const std::vector<float> frequencies = spot.checkpoint.getAverageStrategy(node);
+        const int count = spot.checkpoint.getHandCount(player);
+        std::string result = "ok";
+        for (int a = 0; a < tree.getChildCount(node); ++a) {
+            char frequency[32];
+            std::snprintf(frequency, sizeof(frequency), ":%.4f", frequencies[a * count + hand]);
+            result += " " + actionLabel(tree.getAction(node, a)) + frequency;
+        }
+        return result;
+    });
+}
+
+void QueryServer::serveStream(std::istream &in, std::ostream &out) {
+    std::vector<std::string> lines;
+    std::vector<std::string> answers;
+    std::string line;
+    while (std::getline(in, line)) {
+        // 阻塞等到第一行，再把已经到达的行一起取走
+        lines.assign(1, line);
+        while (lines.size() < STREAM_BATCH && in.rdbuf()->in_avail() > 0 && std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        answers.assign(lines.size(), std::string());
+        const int count = static_cast<int>(lines.size());
+        const int grain = std::max(1, count / (scheduler.getThreadCount() * 4));
+        scheduler.parallelFor(count, grain, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                answers[i] = answer(lines[i]);
+            }
+        });
+        for (const std::string &text: answers) {
+            out << text << '\n';
+        }
+        out.flush();
+    }
+}
+
+void QueryServer::serveConnection(int client) {
+    std::string buffer;
+    std::string replies;
+    char chunk[65536];
+    bool open = true;
+    while (open) {
+        const ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(received));
+        // 一次收到的完整请求一起回答、一起发送，客户端可以流水线式地连续发送
+        size_t start = 0;
+        size_t end;
+        replies.clear();
+        while ((end = buffer.find('\n', start)) != std::string::npos) {
+            const std::string_view request(buffer.data() + start, end - start);
+            start = end + 1;
+            if (request == "quit" || request == "quit\r") {
+                open = false;
+                break;
+            }
+            replies += answer(request);
+            replies += '\n';
+        }
+        buffer.erase(0, start);
+        size_t sent = 0;
+        while (sent < replies.size()) {
+            const ssize_t written = send(client, replies.data() + sent, replies.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                open = false;
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+    }
+    close(client);
+}
+
+void QueryServer::serveSocket(const std::string &path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path is too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (listener < 0 || bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        if (listener >= 0) {
+            close(listener);
+        }
+        throw std::runtime_error("cannot listen on " + path + ": " + std::strerror(errno));
+    }
+
+    while (true) {
+        const int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            ++connections;
+        }
+        std::thread([this, client]() {
+            serveConnection(client);
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            if (--connections == 0) {
+                connectionsDone.notify_all();
+            }
+        }).detach();
+    }
+    close(listener);
+    unlink(path.c_str());
+    std::unique_lock<std::mutex> lock(connectionMutex);
+    connectionsDone.wait(lock, [&]() { return connections == 0; });
+}
@@ -0,0 +1,72 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include "../Card/isomorphism.h"
+#include "../Concurrency/lrucache.h"
+#include "../Concurrency/scheduler.h"
+#include "../Preflop/prefloptable.h"
+#include "../Solver/checkpoint.h"
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ServerConfig {
+    int threads = 0;                       // 0 表示使用全部核心
+    size_t cacheSize = 1 << 16;            // 缓存的回答条数
+    uint64_t trials = 200000;              // 对随机手牌的蒙特卡洛局数
+    std::string preflopPath;               // PreflopTable::generate() 生成的翻前胜率表，可以不指定
+    std::vector<std::string> strategyPaths;  // 求解器保存的检查点或导出的策略
+};
+
+// 常驻的查询服务：启动时加载一次胜率表和策略，之后按行回答查询
+// 请求和回答都是一行文本，回答以 "ok " 或 "error " 开头：
+//   eval <手牌> [公共牌]                  -> ok <牌型> <牌力> <最好的五张牌>
+//   equity <手牌> <对手>... [board <公共牌>] -> ok <胜率>
+//       对手为具体手牌、random，或有翻前表时的起手牌类别（例如 QQ、AKs）
+//   strategy <公共牌> <手牌> [行动,...]     -> ok <行动>:<频率> ...
+//       行动写作 check、call、fold、allin、bet33、raise75，发河牌写作那张牌，例如 check,check,3s,bet50
+//   stats                                 -> ok hits <n> misses <n> coalesced <n>
+// 胜率和策略的回答按花色同构后的规范形式缓存，同构的查询共用一条；同一个查询同时到达时只计算一次。
+class QueryServer {
+public:
+    // 文件打不开时抛出 std::runtime_error
+    explicit QueryServer(const ServerConfig &config);
+
+    // 回答一行请求，不抛出异常
+    std::string answer(std::string_view request);
+    // 从 in 读请求，按顺序把回答写到 out，直到输入结束；已经到达的一批请求并行计算
+    void serveStream(std::istream &in, std::ostream &out);
+    // 在 Unix socket 上接受连接，每个连接一个线程，按顺序回答该连接上的请求；监听失败时抛出 std::runtime_error
+    void serveSocket(const std::string &path);
+
+private:
+    // 已加载的策略，按公共牌的规范形式查找
+    struct Spot {
+        Checkpoint checkpoint;
+        CardSet canonicalBoard;
+        SuitPermutation fromCanonical{};  // 规范花色到检查点中的花色
+    };
+
+    ServerConfig config;
+    std::optional<PreflopTable> preflop;
+    std::vector<Spot> spots;
+    TaskScheduler scheduler;
+    LruCache<std::string, std::string> cache;
+
+    // 连接线程分离运行，serveSocket() 返回前等它们全部结束
+    std::mutex connectionMutex;
+    std::condition_variable connectionsDone;
+    int connections = 0;
+
+    std::string evaluate(const std::vector<std::string_view> &words) const;
+    std::string equity(const std::vector<std::string_view> &words);
+    std::string strategy(const std::vector<std::string_view> &words);
+    void serveConnection(int client);
+};
+
+#endif  // QUERYSERVER_H
@@ -0,0 +1,87 @@
+#include "bot.h"
+#include "../pokerHand/handstate.h"
+#include <algorithm>
+
+namespace {
+
+    class CallingBot : public BotPolicy {
+    public:
+        BotDecision act(const BotView &, Xoshiro256 &) const override {
+            return {BotAction::CALL, 0};
+        }
+    };
+
+    class RandomBot : public BotPolicy {
+    public:
+        BotDecision act(const BotView &view, Xoshiro256 &rng) const override {
+            const uint32_t roll = rng.bounded(100);
+            const int64_t currentBet = view.streetBet + view.toCall;
+            if (view.toCall > 0 && roll < 20) {
+                return {BotAction::FOLD, 0};
+            }
+            if (roll >= 70) {
+                return {BotAction::RAISE, currentBet + view.pot + view.toCall};
+            }
+            return {BotAction::CALL, 0};
+        }
+    };
+
+    class TightBot : public BotPolicy {
+    public:
+        BotDecision act(const BotView &view, Xoshiro256 &) const override {
+            return view.street == 0 ? preflop(view) : postflop(view);
+        }
+
+    private:
+        static BotDecision preflop(const BotView &view) {
+            const int first = view.hole.first().getIndex();
+            const int second = (view.hole - CardSet(view.hole.first())).first().getIndex();
+            const int high = std::max(first % RANK_COUNT, second % RANK_COUNT);
+            const int low = std::min(first % RANK_COUNT, second % RANK_COUNT);
+            const bool suited = first / RANK_COUNT == second / RANK_COUNT;
+            const bool pair = high == low;
+            const int64_t currentBet = view.streetBet + view.toCall;
+
+            // 点数强度 2 为 0，A 为 12：99+、AQ+ 加注，其他对子、大牌、同花 A 和同花连张跟注
+            if ((pair && high >= 7) || (high == 12 && low >= 10)) {
+                return {BotAction::RAISE, std::max(3 * view.bigBlind, 3 * currentBet)};
+            }
+            const bool playable = pair || (high >= 10 && low >= 8) || (suited && high == 12) ||
+                                  (suited && high - low == 1 && low >= 3);
+            if (playable && view.toCall <= std::max(4 * view.bigBlind, view.stack / 10)) {
+                return {BotAction::CALL, 0};
+            }
+            return {BotAction::FOLD, 0};
+        }
+
+        static BotDecision postflop(const BotView &view) {
+            HandType type = HandState(view.hole | view.board).handType();
+            // 牌型全部来自公共牌时不算自己的牌
+            if (view.board.size() == 5 && type == HandState(view.board).handType()) {
+                type = HandType::HIGH_CARD;
+            }
+            const int64_t currentBet = view.streetBet + view.toCall;
+            if (type >= HandType::TWO_PAIR) {
+                return {BotAction::RAISE, currentBet + (view.pot + view.toCall) * 3 / 4};
+            }
+            if (type == HandType::PAIR && view.toCall * 2 <= view.pot) {
+                return {BotAction::CALL, 0};
+            }
+            return {BotAction::FOLD, 0};
+        }
+    };
+
+}
+
+std::unique_ptr<BotPolicy> BotPolicy::create(const std::string &name) {
+    if (name == "calling") {
+        return std::make_unique<CallingBot>();
+    }
+    if (name == "random") {
+        return std::make_unique<RandomBot>();
+    }
+    if (name == "tight") {
+        return std::make_unique<TightBot>();
+    }
+    return nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "../Card/cardset.h"
+#include "../Random/rng.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+enum class BotAction : uint8_t {
+    FOLD,   // 不需要跟注时按过牌处理
+    CALL,   // 过牌或跟注，筹码不够时全下
+    RAISE   // 下注或加注到 raiseTo
+};
+
+struct BotDecision {
+    BotAction action = BotAction::CALL;
+    int64_t raiseTo = 0;  // 本街加注到的总额，会被限制在最小加注额和全下之间
+};
+
+// 轮到行动时看到的局面，金额都是筹码数
+struct BotView {
+    int seat = 0;
+    int seats = 0;              // 本手牌还有筹码的人数
+    int street = 0;             // 0 翻前，1 翻牌，2 转牌，3 河牌
+    int livePlayers = 0;        // 还没有弃牌的人数
+    CardSet hole;
+    CardSet board;              // 已发出的公共牌
+    int64_t pot = 0;            // 包括本街已下注的筹码
+    int64_t toCall = 0;
+    int64_t minRaiseTo = 0;
+    // 无限注规则：不足最小加注额的全下不重新开放加注，之前已经行动过的玩家只能跟注或弃牌；为 false 时 RAISE 按跟注处理
+    bool canRaise = true;
+    int64_t stack = 0;          // 剩余筹码
+    int64_t streetBet = 0;      // 本街已经下注的筹码
+    int64_t bigBlind = 0;
+};
+
+// 可替换的机器人策略
+// 模拟时所有桌共用同一个对象，act() 会被多个线程同时调用，不能修改成员；需要随机数时用传入的 rng。
+class BotPolicy {
+public:
+    virtual ~BotPolicy() = default;
+
+    virtual BotDecision act(const BotView &view, Xoshiro256 &rng) const = 0;
+
+    // 内置策略：
+    //   calling  总是过牌或跟注
+    //   random   随机弃牌、跟注或按底池加注
+    //   tight    翻前只玩大对子和大牌，翻后按牌型下注
+    // 名字不认识时返回空
+    static std::unique_ptr<BotPolicy> create(const std::string &name);
+};
+
+#endif  // BOT_H
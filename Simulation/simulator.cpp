@@ -0,0 +1,623 @@
+#include "simulator.h"
+#include "../Concurrency/threads.h"
+#include "../Deck/deck.h"
+#include "../pokerHand/lookupevaluator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+    constexpr int MAX_SEATS = Simulator::MAX_SEATS;
+    constexpr int MAX_LEVEL = 30;       // 盲注最多翻倍的次数，防止溢出
+    constexpr double Z_95 = 1.959964;   // 95% 置信区间的正态分位数
+
+    // 由种子和批次编号得到这一批的随机数种子（splitmix64），与哪个线程领取无关
+    uint64_t batchSeed(uint64_t seed, uint64_t batch) {
+        uint64_t z = seed + (batch + 1) * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // 一批桌子，每桌的量连续存放，每个座位的量按 [座位][桌] 排列
+    struct TableBatch {
+        int tables = 0;
+        int seats = 0;
+
+        std::vector<uint8_t> playing;         // 本轮要打一手牌的桌子
+        std::vector<uint8_t> showdown;        // 本手进入摊牌的桌子
+        std::vector<uint8_t> buttons;
+        std::vector<int64_t> smallBlinds;
+        std::vector<int64_t> bigBlinds;
+        std::vector<uint64_t> boards;         // 五张公共牌，开局时一次发好
+        std::vector<uint64_t> flops;          // 按发牌顺序的前三张和前四张，翻后各街只能看到这些
+        std::vector<uint64_t> turns;
+
+        std::vector<uint64_t> holes;
+        std::vector<int64_t> stacks;          // 本手开始时的筹码，0 表示已出局
+        std::vector<int64_t> contributions;   // 本手投入底池的筹码
+        std::vector<int64_t> payouts;         // 本手分到的筹码
+        std::vector<uint8_t> live;            // 还没有弃牌
+        std::vector<uint32_t> strengths;
+
+        TableBatch(int tables, int seats)
+                : tables(tables), seats(seats), playing(tables), showdown(tables), buttons(tables),
+                  smallBlinds(tables), bigBlinds(tables), boards(tables), flops(tables), turns(tables),
+                  holes(tables * seats), stacks(tables * seats), contributions(tables * seats), payouts(tables * seats),
+                  live(tables * seats), strengths(tables * seats) {}
+
+        [[nodiscard]] size_t at(int seat, int table) const {
+            return static_cast<size_t>(seat) * tables + table;
+        }
+    };
+
+    // 一批或全部结果的累计，按机器人（座位顺序）统计
+    struct Totals {
+        uint64_t hands = 0;
+        uint64_t tournaments = 0;
+        uint64_t showdowns = 0;
+        std::vector<uint64_t> samples;
+        std::vector<uint64_t> wins;
+        std::vector<uint64_t> botShowdowns;
+        std::vector<int64_t> sums;        // 现金局每个样本的盈亏之和（筹码）
+        std::vector<double> squares;      // 盈亏平方和；整数平方和在 2^53 以内精确
+        std::vector<uint64_t> places;     // 锦标赛名次计数，按 [机器人][名次] 排列
+
+        explicit Totals(int bots)
+                : samples(bots), wins(bots), botShowdowns(bots), sums(bots), squares(bots), places(bots * bots) {}
+
+        void merge(const Totals &other) {
+            hands += other.hands;
+            tournaments += other.tournaments;
+            showdowns += other.showdowns;
+            for (size_t i = 0; i < samples.size(); ++i) {
+                samples[i] += other.samples[i];
+                wins[i] += other.wins[i];
+                botShowdowns[i] += other.botShowdowns[i];
+                sums[i] += other.sums[i];
+                squares[i] += other.squares[i];
+            }
+            for (size_t i = 0; i < places.size(); ++i) {
+                places[i] += other.places[i];
+            }
+        }
+    };
+
+    // 给所有要打的桌子发牌：每个还有筹码的座位两张手牌，再加五张公共牌
+    void deal(TableBatch &batch, Deck &deck) {
+        for (int t = 0; t < batch.tables; ++t) {
+            if (!batch.playing[t]) {
+                continue;
+            }
+            deck.reset();
+            for (int seat = 0; seat < batch.seats; ++seat) {
+                const size_t i = batch.at(seat, t);
+                batch.holes[i] = batch.stacks[i] > 0 ? deck.deal(2).getBits() : 0;
+            }
+            batch.flops[t] = deck.deal(3).getBits();
+            batch.turns[t] = batch.flops[t] | CardSet(deck.dealCard()).getBits();
+            batch.boards[t] = batch.turns[t] | CardSet(deck.dealCard()).getBits();
+        }
+    }
+
+    // 一桌打完一手牌的下注（无限注），seatBots 为每个座位上的机器人编号
+    // 只剩一人时他拿走底池；否则标记进入摊牌，由 settleShowdowns() 分配
+    void playHand(TableBatch &batch, int t, const int *seatBots,
+                  const std::vector<std::shared_ptr<const BotPolicy>> &bots, Xoshiro256 &rng) {
+        const int seats = batch.seats;
+        int64_t stack[MAX_SEATS];
+        int64_t streetBet[MAX_SEATS];
+        bool inHand[MAX_SEATS];
+        bool folded[MAX_SEATS];
+        int players = 0;
+        for (int seat = 0; seat < seats; ++seat) {
+            const size_t i = batch.at(seat, t);
+            stack[seat] = batch.stacks[i];
+            inHand[seat] = stack[seat] > 0;
+            folded[seat] = !inHand[seat];
+            streetBet[seat] = 0;
+            batch.contributions[i] = 0;
+            batch.payouts[i] = 0;
+            players += inHand[seat];
+        }
+        auto next = [&](int seat) {
+            do {
+                seat = (seat + 1) % seats;
+            } while (!inHand[seat]);
+            return seat;
+        };
+        int64_t pot = 0;
+        auto pay = [&](int seat, int64_t amount) {
+            stack[seat] -= amount;
+            streetBet[seat] += amount;
+            batch.contributions[batch.at(seat, t)] += amount;
+            pot += amount;
+        };
+        auto canAct = [&](int seat) { return inHand[seat] && !folded[seat] && stack[seat] > 0; };
+
+        const int button = batch.buttons[t];
+        const int64_t bigBlind = batch.bigBlinds[t];
+        // 单挑时按钮位是小盲
+        const int smallBlindSeat = players == 2 ? button : next(button);
+        const int bigBlindSeat = next(smallBlindSeat);
+        pay(smallBlindSeat, std::min(batch.smallBlinds[t], stack[smallBlindSeat]));
+        pay(bigBlindSeat, std::min(bigBlind, stack[bigBlindSeat]));
+
+        int live = players;
+        int64_t currentBet = bigBlind;
+        int first = next(bigBlindSeat);
+        const uint64_t boards[4] = {0, batch.flops[t], batch.turns[t], batch.boards[t]};
+        for (int street = 0; street < 4 && live > 1; ++street) {
+            if (street > 0) {
+                std::fill(streetBet, streetBet + seats, 0);
+                currentBet = 0;
+                first = next(button);
+            }
+            int pending = 0;
+            for (int seat = 0; seat < seats; ++seat) {
+                pending += canAct(seat);
+            }
+            // 翻牌后能行动的不到两人时不再下注，直接发完公共牌
+            if (street > 0 && pending < 2) {
+                continue;
+            }
+            int64_t minRaise = bigBlind;
+            // 本街行动过的玩家及其行动后的下注额；之后只有累计达到一次完整加注，他们才能再加注
+            bool acted[MAX_SEATS] = {};
+            int64_t actedAt[MAX_SEATS] = {};
+            int seat = first;
+            while (pending > 0 && live > 1) {
+                if (!canAct(seat)) {
+                    seat = next(seat);
+                    continue;
+                }
+                const int64_t toCall = std::max<int64_t>(0, currentBet - streetBet[seat]);
+                BotView view;
+                view.seat = seat;
+                view.seats = players;
+                view.street = street;
+                view.livePlayers = live;
+                view.hole = CardSet(batch.holes[batch.at(seat, t)]);
+                view.board = CardSet(boards[street]);
+                view.pot = pot;
+                view.toCall = toCall;
+                view.minRaiseTo = currentBet + minRaise;
+                view.canRaise = !acted[seat] || currentBet - actedAt[seat] >= minRaise;
+                view.stack = stack[seat];
+                view.streetBet = streetBet[seat];
+                view.bigBlind = bigBlind;
+                const BotDecision decision = bots[seatBots[seat]]->act(view, rng);
+
+                if (decision.action == BotAction::FOLD && toCall > 0) {
+                    folded[seat] = true;
+                    --live;
+                    --pending;
+                } else if (decision.action == BotAction::RAISE && view.canRaise && stack[seat] > toCall) {
+                    const int64_t allIn = streetBet[seat] + stack[seat];
+                    const int64_t raiseTo = std::clamp(decision.raiseTo, std::min(currentBet + minRaise, allIn), allIn);
+                    pay(seat, raiseTo - streetBet[seat]);
+                    // 不足最小加注额的全下不改变之后的最小加注额，也不给已经行动过的玩家重新加注的权利（见 canRaise），
+                    // 但他们仍要对多出的筹码跟注或弃牌，所以所有还能行动的玩家都要再行动一次
+                    minRaise = std::max(minRaise, raiseTo - currentBet);
+                    currentBet = raiseTo;
+                    pending = 0;
+                    for (int other = 0; other < seats; ++other) {
+                        pending += other != seat && canAct(other);
+                    }
+                } else {
+                    // 不能加注时的加注按跟注处理
+                    pay(seat, std::min(toCall, stack[seat]));
+                    --pending;
+                }
+                acted[seat] = true;
+                actedAt[seat] = currentBet;
+                seat = next(seat);
+            }
+        }
+
+        for (int seat = 0; seat < seats; ++seat) {
+            batch.live[batch.at(seat, t)] = inHand[seat] && !folded[seat];
+        }
+        batch.showdown[t] = live > 1;
+        if (live == 1) {
+            for (int seat = 0; seat < seats; ++seat) {
+                if (inHand[seat] && !folded[seat]) {
+                    batch.payouts[batch.at(seat, t)] = pot;
+                }
+            }
+        }
+    }
+
+    // 按边池分配一桌的底池：每个还在牌局中的玩家的投入额是一层，每层由投入不少于该层的玩家中牌力最大者平分，
+    // 除不尽的筹码从按钮左边开始依次多分一个
+    void awardPots(TableBatch &batch, int t) {
+        const int seats = batch.seats;
+        // 不同的投入额按升序插入；最多 MAX_SEATS 个，直接插入排序比 std::sort 简单，下标范围编译器也看得出来
+        int64_t levels[MAX_SEATS];
+        int levelCount = 0;
+        int64_t total = 0;
+        for (int seat = 0; seat < seats; ++seat) {
+            const size_t i = batch.at(seat, t);
+            total += batch.contributions[i];
+            const int64_t contribution = batch.contributions[i];
+            if (!batch.live[i] || levelCount == MAX_SEATS ||
+                std::find(levels, levels + levelCount, contribution) != levels + levelCount) {
+                continue;
+            }
+            int k = levelCount++;
+            for (; k > 0 && levels[k - 1] > contribution; --k) {
+                levels[k] = levels[k - 1];
+            }
+            levels[k] = contribution;
+        }
+
+        int64_t previous = 0;
+        int64_t distributed = 0;
+        for (int l = 0; l < levelCount; ++l) {
+            const int64_t level = levels[l];
+            int64_t amount = 0;
+            for (int seat = 0; seat < seats; ++seat) {
+                const int64_t contribution = batch.contributions[batch.at(seat, t)];
+                amount += std::min(contribution, level) - std::min(contribution, previous);
+            }
+            // 弃牌者的投入不会超过最高一层，保险起见最后一层拿走剩下的全部
+            if (l == levelCount - 1) {
+                amount = total - distributed;
+            }
+            uint32_t best = 0;
+            int winners = 0;
+            for (int seat = 0; seat < seats; ++seat) {
+                const size_t i = batch.at(seat, t);
+                if (batch.live[i] && batch.contributions[i] >= level) {
+                    if (batch.strengths[i] > best) {
+                        best = batch.strengths[i];
+                        winners = 1;
+                    } else if (batch.strengths[i] == best) {
+                        ++winners;
+                    }
+                }
+            }
+            int64_t remainder = amount % winners;
+            for (int k = 1; k <= seats; ++k) {
+                const int seat = (batch.buttons[t] + k) % seats;
+                const size_t i = batch.at(seat, t);
+                if (batch.live[i] && batch.contributions[i] >= level && batch.strengths[i] == best) {
+                    batch.payouts[i] += amount / winners + (remainder > 0 ? 1 : 0);
+                    remainder -= remainder > 0;
+                }
+            }
+            distributed += amount;
+            previous = level;
+        }
+    }
+
+    // 整批一起摊牌：先按座位连续地给所有摊牌的手牌求值，再逐桌分配边池
+    void settleShowdowns(TableBatch &batch) {
+        for (int seat = 0; seat < batch.seats; ++seat) {
+            for (int t = 0; t < batch.tables; ++t) {
+                const size_t i = batch.at(seat, t);
+                batch.strengths[i] = batch.playing[t] && batch.showdown[t] && batch.live[i]
+                                     ? LookupEvaluator::evaluate(batch.holes[i] | batch.boards[t]) : 0;
+            }
+        }
+        for (int t = 0; t < batch.tables; ++t) {
+            if (batch.playing[t] && batch.showdown[t]) {
+                awardPots(batch, t);
+            }
+        }
+    }
+
+    // 所有桌子打一手：发牌、逐桌下注、整批摊牌
+    void playRound(TableBatch &batch, const int *seatBots, const std::vector<std::shared_ptr<const BotPolicy>> &bots,
+                   Xoshiro256 &rng) {
+        for (int t = 0; t < batch.tables; ++t) {
+            if (batch.playing[t]) {
+                playHand(batch, t, seatBots, bots, rng);
+            }
+        }
+        settleShowdowns(batch);
+    }
+
+    // 现金局的一个批次：每桌打一圈（每个座位当一次按钮），复式时同一副牌按座位轮换再打 seats - 1 遍
+    void runCashBatch(const SimulationConfig &config, const std::vector<std::shared_ptr<const BotPolicy>> &bots,
+                      int tables, uint64_t seed, Totals &totals) {
+        const int seats = static_cast<int>(bots.size());
+        TableBatch batch(tables, seats);
+        Deck deck(seed);
+        Xoshiro256 rng(seed);
+        rng.jump();
+        std::fill(batch.playing.begin(), batch.playing.end(), 1);
+        std::fill(batch.smallBlinds.begin(), batch.smallBlinds.end(), config.smallBlind);
+        std::fill(batch.bigBlinds.begin(), batch.bigBlinds.end(), config.bigBlind);
+
+        const int rotations = config.duplicate ? seats : 1;
+        std::vector<int64_t> dealNet(static_cast<size_t>(tables) * seats);
+        for (int round = 0; round < seats; ++round) {
+            for (int t = 0; t < tables; ++t) {
+                batch.buttons[t] = static_cast<uint8_t>((round + t) % seats);
+            }
+            std::fill(batch.stacks.begin(), batch.stacks.end(), config.stack);
+            deal(batch, deck);
+            std::fill(dealNet.begin(), dealNet.end(), 0);
+
+            for (int rotation = 0; rotation < rotations; ++rotation) {
+                int seatBots[MAX_SEATS];
+                for (int seat = 0; seat < seats; ++seat) {
+                    seatBots[seat] = (seat + rotation) % seats;
+                }
+                playRound(batch, seatBots, bots, rng);
+
+                totals.hands += tables;
+                for (int t = 0; t < tables; ++t) {
+                    totals.showdowns += batch.showdown[t];
+                }
+                for (int seat = 0; seat < seats; ++seat) {
+                    const int bot = seatBots[seat];
+                    for (int t = 0; t < tables; ++t) {
+                        const size_t i = batch.at(seat, t);
+                        const int64_t net = batch.payouts[i] - batch.contributions[i];
+                        dealNet[static_cast<size_t>(bot) * tables + t] += net;
+                        totals.wins[bot] += net > 0;
+                        totals.botShowdowns[bot] += batch.showdown[t] && batch.live[i];
+                    }
+                }
+            }
+
+            for (int bot = 0; bot < seats; ++bot) {
+                for (int t = 0; t < tables; ++t) {
+                    const int64_t net = dealNet[static_cast<size_t>(bot) * tables + t];
+                    totals.samples[bot] += 1;
+                    totals.sums[bot] += net;
+                    totals.squares[bot] += static_cast<double>(net) * static_cast<double>(net);
+                }
+            }
+        }
+    }
+
+    // 锦标赛的一个批次：每桌一场，所有桌子一起一手一手地打，直到每桌只剩一人
+    void runTournamentBatch(const SimulationConfig &config,
+                            const std::vector<std::shared_ptr<const BotPolicy>> &bots, int tables, uint64_t seed,
+                            Totals &totals) {
+        const int seats = static_cast<int>(bots.size());
+        TableBatch batch(tables, seats);
+        Deck deck(seed);
+        Xoshiro256 rng(seed);
+        rng.jump();
+        std::fill(batch.playing.begin(), batch.playing.end(), 1);
+        std::fill(batch.stacks.begin(), batch.stacks.end(), config.stack);
+        std::vector<int> remaining(tables, seats);
+        std::vector<int> handCount(tables, 0);
+        std::vector<int> places(static_cast<size_t>(tables) * seats, -1);
+        int seatBots[MAX_SEATS];
+        std::iota(seatBots, seatBots + seats, 0);
+        for (int t = 0; t < tables; ++t) {
+            batch.buttons[t] = static_cast<uint8_t>(t % seats);
+        }
+
+        int running = tables;
+        while (running > 0) {
+            for (int t = 0; t < tables; ++t) {
+                if (batch.playing[t]) {
+                    const int level = std::min(handCount[t] / std::max(1, config.levelHands), MAX_LEVEL);
+                    batch.smallBlinds[t] = config.smallBlind << level;
+                    batch.bigBlinds[t] = config.bigBlind << level;
+                }
+            }
+            deal(batch, deck);
+            playRound(batch, seatBots, bots, rng);
+
+            for (int t = 0; t < tables; ++t) {
+                if (!batch.playing[t]) {
+                    continue;
+                }
+                ++totals.hands;
+                totals.showdowns += batch.showdown[t];
+                ++handCount[t];
+
+                // 同一手出局的玩家，开始时筹码多的名次靠前，一样多时按座位顺序
+                int busted[MAX_SEATS];
+                int bustedCount = 0;
+                for (int seat = 0; seat < seats; ++seat) {
+                    const size_t i = batch.at(seat, t);
+                    const int64_t after = batch.stacks[i] - batch.contributions[i] + batch.payouts[i];
+                    if (batch.stacks[i] > 0 && after == 0) {
+                        busted[bustedCount++] = seat;
+                    }
+                }
+                std::stable_sort(busted, busted + bustedCount, [&](int a, int b) {
+                    return batch.stacks[batch.at(a, t)] > batch.stacks[batch.at(b, t)];
+                });
+                for (int k = 0; k < bustedCount; ++k) {
+                    places[static_cast<size_t>(busted[k]) * tables + t] = remaining[t] - bustedCount + k;
+                }
+                remaining[t] -= bustedCount;
+                for (int seat = 0; seat < seats; ++seat) {
+                    const size_t i = batch.at(seat, t);
+                    batch.stacks[i] += batch.payouts[i] - batch.contributions[i];
+                }
+
+                if (remaining[t] <= 1) {
+                    for (int seat = 0; seat < seats; ++seat) {
+                        if (batch.stacks[batch.at(seat, t)] > 0) {
+                            places[static_cast<size_t>(seat) * tables + t] = 0;
+                        }
+                        const int place = places[static_cast<size_t>(seat) * tables + t];
+                        totals.places[static_cast<size_t>(seat) * seats + place] += 1;
+                        totals.samples[seat] += 1;
+                        totals.wins[seat] += place == 0;
+                    }
+                    ++totals.tournaments;
+                    batch.playing[t] = 0;
+                    --running;
+                    continue;
+                }
+                // 按钮移到下一个还有筹码的座位
+                int button = batch.buttons[t];
+                do {
+                    button = (button + 1) % seats;
+                } while (batch.stacks[batch.at(button, t)] == 0);
+                batch.buttons[t] = static_cast<uint8_t>(button);
+            }
+        }
+    }
+
+    // 由累计结果算出均值和置信区间
+    SimulationStats summarize(const SimulationConfig &config, const std::vector<double> &prizes, int seats,
+                              const Totals &totals) {
+        SimulationStats stats;
+        stats.hands = totals.hands;
+        stats.tournaments = totals.tournaments;
+        stats.showdowns = totals.showdowns;
+        for (int bot = 0; bot < seats; ++bot) {
+            BotStats &result = stats.bots.emplace_back();
+            result.samples = totals.samples[bot];
+            result.wins = totals.wins[bot];
+            result.showdowns = totals.botShowdowns[bot];
+            const double n = static_cast<double>(result.samples);
+            if (result.samples == 0) {
+                continue;
+            }
+            double mean = 0;
+            double meanSquare = 0;
+            double scale = 0;
+            if (config.format == GameFormat::CASH) {
+                mean = static_cast<double>(totals.sums[bot]) / n;
+                meanSquare = totals.squares[bot] / n;
+                // 每个样本是一手牌（复式为 seats 手），换算为大盲/百手
+                const int handsPerSample = config.duplicate ? seats : 1;
+                scale = 100.0 / (static_cast<double>(config.bigBlind) * handsPerSample);
+            } else {
+                // 买入为奖池的 1/seats，名次 p 的回报率为 prizes[p] * seats - 1
+                for (int place = 0; place < seats; ++place) {
+                    const double count = static_cast<double>(totals.places[static_cast<size_t>(bot) * seats + place]);
+                    const double value = prizes[place] * seats - 1;
+                    mean += count * value / n;
+                    meanSquare += count * value * value / n;
+                }
+                scale = 100;
+            }
+            const double variance = std::max(0.0, meanSquare - mean * mean);
+            result.mean = mean * scale;
+            result.interval = result.samples > 1 ? Z_95 * std::sqrt(variance / (n - 1)) * scale : INFINITY;
+        }
+        return stats;
+    }
+
+}
+
+Simulator::Simulator(std::vector<std::shared_ptr<const BotPolicy>> bots) : bots(std::move(bots)) {
+    if (this->bots.size() < MIN_SEATS || this->bots.size() > MAX_SEATS) {
+        throw std::invalid_argument("a table needs 2 to 9 seats");
+    }
+    for (const std::shared_ptr<const BotPolicy> &bot: this->bots) {
+        if (!bot) {
+            throw std::invalid_argument("missing bot policy");
+        }
+    }
+}
+
+SimulationStats Simulator::run(const SimulationConfig &config,
+                               const std::function<void(const SimulationStats &)> &progress) const {
+    if (config.smallBlind <= 0 || config.bigBlind < config.smallBlind || config.stack <= 0 || config.tables <= 0) {
+        throw std::invalid_argument("invalid blinds, stack or table count");
+    }
+    LookupEvaluator::initialize();
+    const int seats = static_cast<int>(bots.size());
+    const bool tournament = config.format == GameFormat::TOURNAMENT;
+
+    // 只取前 seats 个名次的奖金比例并归一化
+    std::vector<double> prizes(seats, 0.0);
+    for (int place = 0; place < seats && place < static_cast<int>(config.payouts.size()); ++place) {
+        prizes[place] = std::max(0.0, config.payouts[place]);
+    }
+    const double prizeTotal = std::accumulate(prizes.begin(), prizes.end(), 0.0);
+    if (tournament && prizeTotal <= 0) {
+        throw std::invalid_argument("payouts must be positive");
+    }
+    for (double &prize: prizes) {
+        prize /= prizeTotal > 0 ? prizeTotal : 1;
+    }
+
+    // 每桌每批的样本数：现金局一圈 seats 手（复式再乘 seats），锦标赛一场
+    const uint64_t handsPerTable = tournament ? 1 : static_cast<uint64_t>(seats) * (config.duplicate ? seats : 1);
+    const uint64_t tablesNeeded = (config.hands + handsPerTable - 1) / handsPerTable;
+    const uint64_t batchCount = (tablesNeeded + config.tables - 1) / config.tables;
+
+    Totals totals(seats);
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::atomic<uint64_t> claimed{0};
+    std::atomic<bool> done{false};
+    int running = std::min<int>(resolveThreadCount(config.threads), static_cast<int>(std::max<uint64_t>(1, batchCount)));
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto converged = [&](const SimulationStats &stats) {
+        if (config.targetInterval <= 0) {
+            return false;
+        }
+        return std::all_of(stats.bots.begin(), stats.bots.end(), [&](const BotStats &bot) {
+            return bot.samples >= config.minSamples && bot.interval <= config.targetInterval;
+        });
+    };
+
+    auto worker = [&]() {
+        while (!done.load(std::memory_order_relaxed)) {
+            const uint64_t index = claimed.fetch_add(1, std::memory_order_relaxed);
+            if (index >= batchCount) {
+                break;
+            }
+            const int tables = static_cast<int>(std::min<uint64_t>(config.tables, tablesNeeded - index * config.tables));
+            Totals local(seats);
+            if (tournament) {
+                runTournamentBatch(config, bots, tables, batchSeed(config.seed, index), local);
+            } else {
+                runCashBatch(config, bots, tables, batchSeed(config.seed, index), local);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            totals.merge(local);
+            if (converged(summarize(config, prizes, seats, totals))) {
+                done.store(true, std::memory_order_relaxed);
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0) {
+            finished.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0, count = running; i < count; ++i) {
+        threads.emplace_back(worker);
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto interval = std::chrono::duration<double>(std::max(0.01, config.reportSeconds));
+        while (!finished.wait_for(lock, interval, [&]() { return running == 0; })) {
+            if (progress) {
+                SimulationStats snapshot = summarize(config, prizes, seats, totals);
+                snapshot.seconds = elapsed();
+                lock.unlock();
+                progress(snapshot);
+                lock.lock();
+            }
+        }
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    SimulationStats stats = summarize(config, prizes, seats, totals);
+    stats.seconds = elapsed();
+    return stats;
+}
@@ -0,0 +1,71 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "bot.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+enum class GameFormat {
+    CASH,        // 每手牌开始时筹码恢复为 stack，按大盲/百手统计
+    TOURNAMENT   // 单桌锦标赛：筹码延续，盲注逐级翻倍，打到只剩一人，按奖金统计投资回报率
+};
+
+struct SimulationConfig {
+    GameFormat format = GameFormat::CASH;
+    int threads = 0;                 // 0 表示使用全部核心
+    uint64_t hands = 1000000;        // 现金局的手数，锦标赛为比赛场数
+    int tables = 256;                // 每批同时模拟的桌数，同一批的发牌和摊牌一起计算
+    int64_t smallBlind = 1;
+    int64_t bigBlind = 2;
+    int64_t stack = 200;
+    int levelHands = 10;             // 锦标赛每打这么多手牌盲注翻倍
+    std::vector<double> payouts{1};  // 锦标赛各名次分得奖池的比例，从第一名开始
+    // 复式发牌（仅现金局）：同一副牌按座位轮换让每个机器人各打一遍，同一副牌上的结果合成一个样本，
+    // 去掉牌运带来的大部分方差
+    bool duplicate = false;
+    double targetInterval = 0;       // 所有机器人的 95% 置信区间半宽都不超过这个值时提前停止，0 表示跑满
+    uint64_t minSamples = 10000;     // 提前停止前每个机器人至少的样本数
+    double reportSeconds = 1;        // 进度回调的间隔
+    uint64_t seed = 0;
+};
+
+// 一个座位上的机器人的统计结果
+struct BotStats {
+    uint64_t samples = 0;   // 现金局为手数（复式为牌副数），锦标赛为场数
+    double mean = 0;        // 现金局为大盲/百手，锦标赛为投资回报率（%）
+    double interval = 0;    // 95% 置信区间的半宽，单位同 mean
+    uint64_t wins = 0;      // 现金局赢得底池的手数，锦标赛第一名的场数
+    uint64_t showdowns = 0; // 现金局参加摊牌的手数，锦标赛为 0
+};
+
+struct SimulationStats {
+    uint64_t hands = 0;          // 实际打过的手数
+    uint64_t tournaments = 0;
+    uint64_t showdowns = 0;      // 进入摊牌的手数
+    double seconds = 0;
+    std::vector<BotStats> bots;  // 按座位顺序
+};
+
+// 多桌模拟
+// 每个任务领取一批桌子，每一轮先在 SoA 数组中给全部桌子发好手牌和五张公共牌，再逐桌打完下注，
+// 最后把所有进入摊牌的座位一起求值并按边池分配；桌子之间互相独立，多个线程各自领取批次。
+// 每批的随机数由种子和批次编号决定，盈亏用整数筹码累加，跑满时结果与线程数无关。
+class Simulator {
+public:
+    static constexpr int MIN_SEATS = 2;
+    static constexpr int MAX_SEATS = 9;
+
+    // 每个座位一个机器人，2~9 个，否则抛出 std::invalid_argument；可以多个座位共用同一个机器人
+    explicit Simulator(std::vector<std::shared_ptr<const BotPolicy>> bots);
+
+    // 运行期间每隔 reportSeconds 在调用线程上回调一次当前的统计，返回最终结果
+    SimulationStats run(const SimulationConfig &config,
+                        const std::function<void(const SimulationStats &)> &progress = nullptr) const;
+
+private:
+    std::vector<std::shared_ptr<const BotPolicy>> bots;
+};
+
+#endif  // SIMULATOR_H
@@ -0,0 +1,136 @@
+#include "bestresponse.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+CheckpointProfile::CheckpointProfile(const Checkpoint &checkpoint, const Subgame &subgame) : checkpoint(checkpoint) {
+    for (int player = 0; player < 2; ++player) {
+        const Subgame::PlayerHands &hands = subgame.getHands(player);
+        bool same = checkpoint.getHandCount(player) == static_cast<int>(hands.combos.size());
+        for (size_t h = 0; same && h < hands.combos.size(); ++h) {
+            same = checkpoint.getHandCombo(player, static_cast<int>(h)) == hands.combos[h];
+        }
+        if (!same) {
+            throw std::invalid_argument("checkpoint hands do not match the subgame");
+        }
+    }
+    if (!checkpoint.hasSection(CheckpointSection::STRATEGY_SUMS)) {
+        throw std::invalid_argument("checkpoint has no average strategy");
+    }
+    // strategy() 按树的偏移直接索引，长度必须与树和手牌数算出的布局一致
+    if (checkpoint.sectionSize(CheckpointSection::STRATEGY_SUMS) != checkpoint.getStrategySize()) {
+        throw std::invalid_argument("checkpoint strategy does not match its tree");
+    }
+    sums.resize(checkpoint.getStrategySize());
+    checkpoint.read(CheckpointSection::STRATEGY_SUMS, 0, sums.size(), sums.data());
+}
+
+void CheckpointProfile::strategy(int node, float *strategy, int stride) const {
+    const GameTree &tree = checkpoint.getTree();
+    const int actions = tree.getChildCount(node);
+    const int count = checkpoint.getHandCount(tree.getPlayer(node));
+    const int alignment = checkpoint.getAlignment();
+    const int sumStride = (count + alignment - 1) / alignment * alignment;
+    const float *nodeSums = sums.data() + tree.getStrategyOffset(node);
+    for (int h = 0; h < count; ++h) {
+        float total = 0;
+        for (int a = 0; a < actions; ++a) {
+            total += nodeSums[a * sumStride + h];
+        }
+        for (int a = 0; a < actions; ++a) {
+            strategy[a * stride + h] = total > 0 ? nodeSums[a * sumStride + h] / total : 1.0f / actions;
+        }
+    }
+}
+
+void BestResponse::traverse(const StrategyProfile &profile, int node, int traverser, int begin, int end,
+                            const float *reachOpp, float *values, int board, Subgame::Workspace &workspace) const {
+    const GameTree &tree = subgame.getTree();
+    switch (tree.getType(node)) {
+        case NodeType::FOLD:
+            subgame.foldValues(node, traverser, begin, end, reachOpp, values);
+            return;
+        case NodeType::SHOWDOWN:
+            subgame.showdownValues(node, traverser, begin, end, reachOpp, values, board);
+            return;
+        case NodeType::CHANCE:
+            subgame.chance(node, traverser, begin, end, nullptr, reachOpp, values, workspace,
+                           [&](int child, int childBoard, const float *, const float *childReachOpp,
+                               float *childValues, Subgame::Workspace &childWorkspace) {
+                               traverse(profile, child, traverser, begin, end, childReachOpp, childValues,
+                                        childBoard, childWorkspace);
+                           });
+            return;
+        case NodeType::ACTION:
+            break;
+    }
+
+    const int actions = tree.getChildCount(node);
+    const int player = tree.getPlayer(node);
+    const size_t mark = workspace.top;
+    float *childValues = workspace.allocate(subgame.getHands(traverser).stride);
+
+    if (player != traverser) {
+        // 对手按给定策略行动
+        const Subgame::PlayerHands &other = subgame.getHands(player);
+        const int otherCount = static_cast<int>(other.combos.size());
+        float *strategy = workspace.allocate(actions * other.stride);
+        float *childReachOpp = workspace.allocate(other.stride);
+        profile.strategy(node, strategy, other.stride);
+        std::fill(values + begin, values + end, 0.0f);
+        for (int a = 0; a < actions; ++a) {
+            for (int v = 0; v < otherCount; ++v) {
+                childReachOpp[v] = reachOpp[v] * strategy[a * other.stride + v];
+            }
+            traverse(profile, tree.getChild(node, a), traverser, begin, end, childReachOpp, childValues, board,
+                     workspace);
+            for (int h = begin; h < end; ++h) {
+                values[h] += childValues[h];
+            }
+        }
+    } else {
+        // 遍历方对每手牌选择价值最大的动作
+        std::fill(values + begin, values + end, -INFINITY);
+        for (int a = 0; a < actions; ++a) {
+            traverse(profile, tree.getChild(node, a), traverser, begin, end, reachOpp, childValues, board, workspace);
+            for (int h = begin; h < end; ++h) {
+                values[h] = std::max(values[h], childValues[h]);
+            }
+        }
+    }
+    workspace.top = mark;
+}
+
+std::vector<float> BestResponse::handValues(const StrategyProfile &profile, int traverser, int threads) const {
+    const Subgame::PlayerHands &self = subgame.getHands(traverser);
+    const int count = static_cast<int>(self.combos.size());
+    std::vector<float> values(self.stride, 0.0f);
+
+    TaskScheduler &pool = subgame.useScheduler(threads);
+    pool.parallelFor(count, subgame.rootGrain(count), [&](int begin, int end) {
+        std::unique_ptr<Subgame::Workspace> workspace = subgame.getWorkspaces().acquire();
+        traverse(profile, subgame.getTree().getRoot(), traverser, begin, end,
+                 subgame.getHands(1 - traverser).weights.data(), values.data(), subgame.getRootBoard(), *workspace);
+        subgame.getWorkspaces().release(std::move(workspace));
+    });
+    values.resize(count);
+    return values;
+}
+
+double BestResponse::value(const StrategyProfile &profile, int traverser, int threads) const {
+    const Subgame::PlayerHands &self = subgame.getHands(traverser);
+    const std::vector<float> values = handValues(profile, traverser, threads);
+    double total = 0;
+    for (size_t h = 0; h < values.size(); ++h) {
+        total += static_cast<double>(self.weights[h]) * values[h];
+    }
+    return total / subgame.getMatchupWeight();
+}
+
+BestResponseResult BestResponse::compute(const StrategyProfile &profile, int threads) const {
+    BestResponseResult result;
+    result.values[0] = value(profile, 0, threads);
+    result.values[1] = value(profile, 1, threads);
+    result.exploitability = (result.values[0] + result.values[1]) / 2;
+    return result;
+}
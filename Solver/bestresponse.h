@@ -0,0 +1,61 @@
+#ifndef BESTRESPONSE_H
+#define BESTRESPONSE_H
+
+#include "checkpoint.h"
+#include "subgame.h"
+#include <vector>
+
+// 一组策略：给出每个行动节点上行动玩家每手牌的动作概率
+class StrategyProfile {
+public:
+    virtual ~StrategyProfile() = default;
+
+    // 行动节点 node 的策略写入 strategy，按 [动作][手牌] 排列，每个动作占 stride 个 float，
+    // 手牌顺序与 Subgame::getHands() 相同；可能被多个线程同时调用
+    virtual void strategy(int node, float *strategy, int stride) const = 0;
+};
+
+// 检查点（或导出的策略文件）中的平均策略
+// 最佳应对要访问每个行动节点，构造时把整段策略累加值一次解码到内存，每个节点只做归一化；
+// 逐节点调用 Checkpoint::getAverageStrategy() 会让每次访问都解码一整块。
+class CheckpointProfile : public StrategyProfile {
+public:
+    // 检查点的手牌必须与 subgame 相同、且含有长度与树相符的策略累加值，否则抛出 std::invalid_argument
+    CheckpointProfile(const Checkpoint &checkpoint, const Subgame &subgame);
+
+    void strategy(int node, float *strategy, int stride) const override;
+
+private:
+    const Checkpoint &checkpoint;
+    std::vector<float> sums;  // 策略累加值，布局同检查点（按 getStrategyOffset() 和对齐后的手牌数）
+};
+
+struct BestResponseResult {
+    double values[2] = {};      // 每名玩家对另一方策略的最佳应对价值，按每对不冲突的手牌组合平均（筹码）
+    double exploitability = 0;  // 两者的平均值，纳什均衡时为 0（筹码）
+
+    // 换算为千分之一大盲每手
+    [[nodiscard]] double mbbPerHand(double bigBlind) const { return exploitability / bigBlind * 1000; }
+};
+
+// 最佳应对和可利用度
+// 对方按给定策略行动时，一次遍历整棵树对遍历方全部手牌同时取每个节点价值最大的动作，
+// 得到精确的反事实最佳应对；弃牌、摊牌和发牌节点的计算及并行方式与求解器相同（见 Subgame）。
+class BestResponse {
+public:
+    explicit BestResponse(const Subgame &subgame) : subgame(subgame) {}
+
+    // 对方按 profile 行动时遍历方每手牌的最佳应对反事实价值，按 Subgame::getHands() 的顺序
+    [[nodiscard]] std::vector<float> handValues(const StrategyProfile &profile, int traverser, int threads = 0) const;
+    // 按手牌权重平均后的最佳应对价值
+    [[nodiscard]] double value(const StrategyProfile &profile, int traverser, int threads = 0) const;
+    [[nodiscard]] BestResponseResult compute(const StrategyProfile &profile, int threads = 0) const;
+
+private:
+    const Subgame &subgame;
+
+    void traverse(const StrategyProfile &profile, int node, int traverser, int begin, int end, const float *reachOpp,
+                  float *values, int board, Subgame::Workspace &workspace) const;
+};
+
+#endif  // BESTRESPONSE_H
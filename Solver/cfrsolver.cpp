@@ -0,0 +1,265 @@
+#include "cfrsolver.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+class CfrSolver::AverageProfile : public StrategyProfile {
+public:
+    explicit AverageProfile(const CfrSolver &solver) : solver(solver) {}
+
+    void strategy(int node, float *strategy, int) const override {
+        const int player = solver.tree.getPlayer(node);
+        solver.averageStrategy(node, 0, solver.getHandCount(player), strategy);
+    }
+
+private:
+    const CfrSolver &solver;
+};
+
+CfrSolver::CfrSolver(GameTree gameTree, const Range &oop, const Range &ip)
+        : tree(std::move(gameTree)), subgame(tree, oop, ip), average(std::make_unique<AverageProfile>(*this)) {
+    const int strides[2] = {subgame.getHands(0).stride, subgame.getHands(1).stride};
+    uint32_t size = tree.assignStrategyOffsets(strides, ALIGNMENT);
+    regrets.assign(size, 0.0f);
+    strategySums.assign(size, 0.0f);
+}
+
+CfrSolver::~CfrSolver() = default;
+
+const StrategyProfile &CfrSolver::averageProfile() const {
+    return *average;
+}
+
+void CfrSolver::currentStrategy(int node, int begin, int end, float *strategy) const {
+    const int actions = tree.getChildCount(node);
+    const int stride = subgame.getHands(tree.getPlayer(node)).stride;
+    const float *regret = regrets.data() + tree.getStrategyOffset(node);
+    for (int h = begin; h < end; ++h) {
+        float total = 0;
+        for (int a = 0; a < actions; ++a) {
+            total += std::max(regret[a * stride + h], 0.0f);
+        }
+        for (int a = 0; a < actions; ++a) {
+            strategy[a * stride + h] = total > 0 ? std::max(regret[a * stride + h], 0.0f) / total : 1.0f / actions;
+        }
+    }
+}
+
+void CfrSolver::averageStrategy(int node, int begin, int end, float *strategy) const {
+    const int actions = tree.getChildCount(node);
+    const int stride = subgame.getHands(tree.getPlayer(node)).stride;
+    const float *sums = strategySums.data() + tree.getStrategyOffset(node);
+    for (int h = begin; h < end; ++h) {
+        float total = 0;
+        for (int a = 0; a < actions; ++a) {
+            total += sums[a * stride + h];
+        }
+        for (int a = 0; a < actions; ++a) {
+            strategy[a * stride + h] = total > 0 ? sums[a * stride + h] / total : 1.0f / actions;
+        }
+    }
+}
+
+std::vector<float> CfrSolver::getAverageStrategy(int node) const {
+    if (tree.getType(node) != NodeType::ACTION) {
+        return {};
+    }
+    const size_t actions = tree.getChildCount(node);
+    const int count = getHandCount(tree.getPlayer(node));
+    const int stride = subgame.getHands(tree.getPlayer(node)).stride;
+    std::vector<float> padded(actions * stride);
+    averageStrategy(node, 0, count, padded.data());
+    std::vector<float> strategy(actions * count);
+    for (size_t a = 0; a < actions; ++a) {
+        std::copy(padded.begin() + a * stride, padded.begin() + a * stride + count, strategy.begin() + a * count);
+    }
+    return strategy;
+}
+
+void CfrSolver::saveCheckpoint(const std::string &path, const CheckpointOptions &options) const {
+    Checkpoint::Writer writer(path, options);
+    const std::vector<int> combos[2] = {subgame.getHands(0).combos, subgame.getHands(1).combos};
+    const std::vector<float> weights[2] = {subgame.getHands(0).weights, subgame.getHands(1).weights};
+    writer.writeTree(tree);
+    writer.writeHands(combos, weights);
+    writer.beginSection(CheckpointSection::REGRETS, regrets.size());
+    writer.append(regrets.data(), regrets.size());
+    writer.beginSection(CheckpointSection::STRATEGY_SUMS, strategySums.size());
+    writer.append(strategySums.data(), strategySums.size());
+    writer.finish(iterations, ALIGNMENT);
+}
+
+void CfrSolver::exportStrategy(const std::string &path, const CheckpointOptions &options) const {
+    Checkpoint::Writer writer(path, options);
+    const std::vector<int> combos[2] = {subgame.getHands(0).combos, subgame.getHands(1).combos};
+    const std::vector<float> weights[2] = {subgame.getHands(0).weights, subgame.getHands(1).weights};
+    writer.writeTree(tree);
+    writer.writeHands(combos, weights);
+    // 行动节点的策略位置按节点编号依次排列，逐个节点归一化后追加，不需要整份数组的额外内存
+    writer.beginSection(CheckpointSection::STRATEGY_SUMS, strategySums.size());
+    std::vector<float> strategy;
+    for (int node = 0; node < tree.getNodeCount(); ++node) {
+        if (tree.getType(node) != NodeType::ACTION) {
+            continue;
+        }
+        const Subgame::PlayerHands &list = subgame.getHands(tree.getPlayer(node));
+        strategy.assign(static_cast<size_t>(tree.getChildCount(node)) * list.stride, 0.0f);
+        averageStrategy(node, 0, static_cast<int>(list.combos.size()), strategy.data());
+        writer.append(strategy.data(), strategy.size());
+    }
+    writer.finish(iterations, ALIGNMENT);
+}
+
+void CfrSolver::restore(const Checkpoint &checkpoint) {
+    for (int player = 0; player < 2; ++player) {
+        bool same = checkpoint.getHandCount(player) == getHandCount(player);
+        for (int h = 0; same && h < getHandCount(player); ++h) {
+            same = checkpoint.getHandCombo(player, h) == subgame.getHands(player).combos[h];
+        }
+        if (!same) {
+            throw std::invalid_argument("checkpoint hands do not match the solver");
+        }
+    }
+    if (checkpoint.getAlignment() != ALIGNMENT || checkpoint.getTree().getNodeCount() != tree.getNodeCount() ||
+        checkpoint.sectionSize(CheckpointSection::REGRETS) != regrets.size() ||
+        checkpoint.sectionSize(CheckpointSection::STRATEGY_SUMS) != strategySums.size()) {
+        throw std::invalid_argument("checkpoint cannot resume this solve");
+    }
+    // 逐块解码直接写入求解器的数组
+    checkpoint.read(CheckpointSection::REGRETS, 0, regrets.size(), regrets.data());
+    checkpoint.read(CheckpointSection::STRATEGY_SUMS, 0, strategySums.size(), strategySums.data());
+    iterations = checkpoint.getIterations();
+}
+
+void CfrSolver::cfr(int node, int traverser, int begin, int end, const float *reachSelf, const float *reachOpp,
+                    float *values, int board, Subgame::Workspace &workspace, const SolverConfig &config) {
+    switch (tree.getType(node)) {
+        case NodeType::FOLD:
+            subgame.foldValues(node, traverser, begin, end, reachOpp, values);
+            return;
+        case NodeType::SHOWDOWN:
+            subgame.showdownValues(node, traverser, begin, end, reachOpp, values, board);
+            return;
+        case NodeType::CHANCE:
+            subgame.chance(node, traverser, begin, end, reachSelf, reachOpp, values, workspace,
+                           [&](int child, int childBoard, const float *childReachSelf, const float *childReachOpp,
+                               float *childValues, Subgame::Workspace &childWorkspace) {
+                               cfr(child, traverser, begin, end, childReachSelf, childReachOpp, childValues,
+                                   childBoard, childWorkspace, config);
+                           });
+            return;
+        case NodeType::ACTION:
+            break;
+    }
+
+    const int actions = tree.getChildCount(node);
+    const int player = tree.getPlayer(node);
+    const size_t mark = workspace.top;
+
+    if (player != traverser) {
+        // 对手行动：按对手当前策略拆分到达概率，子节点价值直接相加
+        const Subgame::PlayerHands &other = subgame.getHands(player);
+        const int otherCount = static_cast<int>(other.combos.size());
+        float *strategy = workspace.allocate(actions * other.stride);
+        float *childReachOpp = workspace.allocate(other.stride);
+        float *childValues = workspace.allocate(subgame.getHands(traverser).stride);
+        currentStrategy(node, 0, otherCount, strategy);
+        std::fill(values + begin, values + end, 0.0f);
+        for (int a = 0; a < actions; ++a) {
+            for (int v = 0; v < otherCount; ++v) {
+                childReachOpp[v] = reachOpp[v] * strategy[a * other.stride + v];
+            }
+            cfr(tree.getChild(node, a), traverser, begin, end, reachSelf, childReachOpp, childValues, board, workspace, config);
+            for (int h = begin; h < end; ++h) {
+                values[h] += childValues[h];
+            }
+        }
+        workspace.top = mark;
+        return;
+    }
+
+    // 遍历方行动：计算每个动作的价值，再更新遗憾和平均策略
+    const int stride = subgame.getHands(traverser).stride;
+    float *strategy = workspace.allocate(actions * stride);
+    float *childValues = workspace.allocate(actions * stride);
+    float *childReachSelf = workspace.allocate(stride);
+    currentStrategy(node, begin, end, strategy);
+    for (int a = 0; a < actions; ++a) {
+        for (int h = begin; h < end; ++h) {
+            childReachSelf[h] = reachSelf[h] * strategy[a * stride + h];
+        }
+        cfr(tree.getChild(node, a), traverser, begin, end, childReachSelf, reachOpp, childValues + a * stride, board,
+            workspace, config);
+    }
+    for (int h = begin; h < end; ++h) {
+        float value = 0;
+        for (int a = 0; a < actions; ++a) {
+            value += strategy[a * stride + h] * childValues[a * stride + h];
+        }
+        values[h] = value;
+    }
+
+    const float t = static_cast<float>(iterations + 1);
+    float *regret = regrets.data() + tree.getStrategyOffset(node);
+    float *sums = strategySums.data() + tree.getStrategyOffset(node);
+    if (config.algorithm == CfrAlgorithm::DISCOUNTED) {
+        const float positive = std::pow(t, config.alpha) / (std::pow(t, config.alpha) + 1);
+        const float negative = std::pow(t, config.beta) / (std::pow(t, config.beta) + 1);
+        const float average = std::pow(t / (t + 1), config.gamma);
+        for (int a = 0; a < actions; ++a) {
+            for (int h = begin; h < end; ++h) {
+                const int i = a * stride + h;
+                regret[i] = regret[i] * (regret[i] > 0 ? positive : negative) + childValues[i] - values[h];
+                sums[i] = sums[i] * average + reachSelf[h] * strategy[i];
+            }
+        }
+    } else {
+        for (int a = 0; a < actions; ++a) {
+            for (int h = begin; h < end; ++h) {
+                const int i = a * stride + h;
+                regret[i] = std::max(regret[i] + childValues[i] - values[h], 0.0f);
+                sums[i] += t * reachSelf[h] * strategy[i];
+            }
+        }
+    }
+    workspace.top = mark;
+}
+
+float CfrSolver::getExploitability(int threads) const {
+    const BestResponseResult result = BestResponse(subgame).compute(*average, threads);
+    return static_cast<float>(result.exploitability / tree.getConfig().pot);
+}
+
+void CfrSolver::iterate(const SolverConfig &config) {
+    const int rootBoard = subgame.getRootBoard();
+    TaskScheduler &pool = subgame.useScheduler(config.threads);
+    for (int traverser = 0; traverser < 2; ++traverser) {
+        const Subgame::PlayerHands &self = subgame.getHands(traverser);
+        const Subgame::PlayerHands &other = subgame.getHands(1 - traverser);
+        const int count = static_cast<int>(self.combos.size());
+        std::vector<float> values(self.stride, 0.0f);
+        pool.parallelFor(count, subgame.rootGrain(count), [&](int begin, int end) {
+            std::unique_ptr<Subgame::Workspace> workspace = subgame.getWorkspaces().acquire();
+            cfr(tree.getRoot(), traverser, begin, end, self.weights.data(), other.weights.data(), values.data(),
+                rootBoard, *workspace, config);
+            subgame.getWorkspaces().release(std::move(workspace));
+        });
+    }
+    ++iterations;
+}
+
+float CfrSolver::solve(const SolverConfig &config) {
+    float exploitability = getExploitability(config.threads);
+    while (iterations < config.iterations && exploitability > config.targetExploitability) {
+        iterate(config);
+        if (!config.checkpointPath.empty() && config.checkpointInterval > 0 &&
+            iterations % config.checkpointInterval == 0) {
+            saveCheckpoint(config.checkpointPath);
+        }
+        if (iterations % config.checkInterval == 0 || iterations == config.iterations) {
+            exploitability = getExploitability(config.threads);
+        }
+    }
+    return exploitability;
+}
@@ -0,0 +1,89 @@
+#ifndef CFRSOLVER_H
+#define CFRSOLVER_H
+
+#include "alignedallocator.h"
+#include "bestresponse.h"
+#include "checkpoint.h"
+#include "gametree.h"
+#include "subgame.h"
+#include "../Range/range.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class CfrAlgorithm {
+    CFR_PLUS,
+    DISCOUNTED
+};
+
+struct SolverConfig {
+    int iterations = 1000;
+    float targetExploitability = 0.005f;  // 可利用度达到底池的这个比例就停止
+    int checkInterval = 25;               // 每隔多少次迭代计算一次可利用度（一次最佳应对遍历）
+    int threads = 0;                      // 0 表示使用全部核心
+    CfrAlgorithm algorithm = CfrAlgorithm::DISCOUNTED;
+    float alpha = 1.5f;                   // DCFR 正遗憾的折扣指数
+    float beta = 0.0f;                    // DCFR 负遗憾的折扣指数
+    float gamma = 2.0f;                   // DCFR 平均策略的折扣指数
+    std::string checkpointPath;           // 非空时每隔 checkpointInterval 次迭代保存一次检查点
+    int checkpointInterval = 0;
+};
+
+// 单挑翻后子博弈的 CFR+ / Discounted CFR 求解器
+// 每次遍历对行动方的全部手牌做向量化计算；遗憾和策略累加值存放在按缓存行对齐的扁平数组中，
+// 行动节点 n 的动作 a、手牌 h 位于 strategyOffset(n) + a * stride(player) + h。
+// 终局节点的计算和并行方式见 Subgame：每个任务只写自己子树的节点或自己那段手牌的行，
+// 遗憾和策略累加不需要加锁；河牌的价值按固定顺序相加，结果与线程数无关。
+class CfrSolver {
+public:
+    CfrSolver(GameTree tree, const Range &oop, const Range &ip);
+    ~CfrSolver();
+
+    // 迭代到达到目标可利用度或迭代次数上限，返回最终可利用度（占底池比例）
+    float solve(const SolverConfig &config);
+    // 完成一次迭代（两名玩家各更新一次）
+    void iterate(const SolverConfig &config);
+
+    // 当前平均策略的可利用度（占底池比例），见 BestResponse
+    [[nodiscard]] float getExploitability(int threads = 0) const;
+
+    [[nodiscard]] const GameTree &getTree() const { return tree; }
+    [[nodiscard]] const Subgame &getSubgame() const { return subgame; }
+    [[nodiscard]] int getIterations() const { return iterations; }
+    [[nodiscard]] int getHandCount(int player) const { return static_cast<int>(subgame.getHands(player).combos.size()); }
+    [[nodiscard]] int getHandCombo(int player, int hand) const { return subgame.getHands(player).combos[hand]; }
+    // 行动节点的平均策略，按 [动作][手牌] 排列
+    [[nodiscard]] std::vector<float> getAverageStrategy(int node) const;
+    // 平均策略，作为 BestResponse 的输入；与求解器共存亡
+    [[nodiscard]] const StrategyProfile &averageProfile() const;
+
+    // 保存树、手牌、遗憾、策略累加值和迭代次数；FLOAT32 编码恢复后继续迭代与不中断完全一致
+    void saveCheckpoint(const std::string &path, const CheckpointOptions &options = CheckpointOptions()) const;
+    // 只保存归一化后的平均策略，用于查询；适合有损编码，不能用来继续求解
+    void exportStrategy(const std::string &path, const CheckpointOptions &options) const;
+    // 读入检查点的遗憾、策略累加值和迭代次数，求解器必须由检查点中的树和范围构造
+    // 检查点不匹配或没有遗憾时抛出 std::invalid_argument
+    void restore(const Checkpoint &checkpoint);
+
+private:
+    static constexpr int ALIGNMENT = Subgame::ALIGNMENT;
+
+    class AverageProfile;
+
+    GameTree tree;
+    Subgame subgame;
+    int iterations = 0;
+
+    AlignedVector<float> regrets;
+    AlignedVector<float> strategySums;
+    std::unique_ptr<AverageProfile> average;
+
+    // 遍历方手牌 [begin, end) 的反事实价值写入 values
+    void cfr(int node, int traverser, int begin, int end, const float *reachSelf, const float *reachOpp,
+             float *values, int board, Subgame::Workspace &workspace, const SolverConfig &config);
+    void currentStrategy(int node, int begin, int end, float *strategy) const;
+    void averageStrategy(int node, int begin, int end, float *strategy) const;
+};
+
+#endif  // CFRSOLVER_H
@@ -0,0 +1,664 @@
+#include "checkpoint.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+
+    constexpr char MAGIC[8] = {'A', 'Y', 'C', 'K', 'P', 'T', 0, 0};
+    // 树和手牌这类原始字节的段，不属于公开的 float 编码
+    constexpr uint8_t ENCODING_BYTES = 0xFF;
+    constexpr size_t FLOAT_BLOCK = 1 << 16;  // 每块 256KB 的 float
+    constexpr size_t BYTE_BLOCK = 1 << 20;
+    constexpr size_t SECTION_ALIGNMENT = 64;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t sectionCount;
+        uint64_t directoryOffset;
+        uint32_t iterations;
+        uint32_t alignment;
+        uint32_t directoryChecksum;  // 段目录的 CRC32
+        uint32_t reserved[7];
+    };
+    static_assert(sizeof(FileHeader) == 64, "file header layout changed");
+
+    struct BlockEntry {
+        uint64_t offset;
+        uint32_t size;      // 文件中的字节数
+        uint32_t checksum;  // 文件中字节的 CRC32
+    };
+    static_assert(sizeof(BlockEntry) == 16, "block entry layout changed");
+
+    struct SectionEntry {
+        uint32_t kind;
+        uint8_t encoding;
+        uint8_t compressed;
+        uint16_t reserved;
+        uint64_t count;          // 元素个数：原始字节段为字节数，其他为 float 个数
+        uint64_t blockElements;  // 每块的元素个数，最后一块可以不满
+        uint64_t blockCount;
+        uint64_t indexOffset;    // BlockEntry[blockCount] 的位置
+        uint64_t storedBytes;
+    };
+    static_assert(sizeof(SectionEntry) == 48, "section entry layout changed");
+
+    uint32_t crc(const unsigned char *data, size_t size) {
+        return static_cast<uint32_t>(crc32(0, data, static_cast<uInt>(size)));
+    }
+
+    // 单精度转半精度，就近舍入到偶数；输入已缩放到 [-1, 1]，不会溢出
+    uint16_t toHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        const int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+        if (exponent >= 31) {
+            return static_cast<uint16_t>(sign | 0x7C00u);
+        }
+        if (exponent <= 0) {
+            // 非规格化数，太小的直接为 0
+            if (exponent < -10) {
+                return static_cast<uint16_t>(sign);
+            }
+            mantissa |= 0x800000u;
+            const int shift = 14 - exponent;
+            uint32_t half = mantissa >> shift;
+            const uint32_t rest = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (half & 1))) {
+                ++half;
+            }
+            return static_cast<uint16_t>(sign | half);
+        }
+        uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        const uint32_t rest = mantissa & 0x1FFFu;
+        if (rest > 0x1000u || (rest == 0x1000u && (half & 1))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    float fromHalf(uint16_t half) {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+        const uint32_t exponent = (half >> 10) & 0x1F;
+        const uint32_t mantissa = half & 0x3FFu;
+        if (exponent == 0) {
+            const float value = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign ? -value : value;
+        }
+        const uint32_t bits = exponent == 31 ? sign | 0x7F800000u | (mantissa << 13)
+                                             : sign | ((exponent + 112) << 23) | (mantissa << 13);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // 按字节重排：把 count 个 width 字节的数的第 k 字节放在一起
+    void shuffle(const unsigned char *in, unsigned char *out, size_t count, size_t width) {
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t k = 0; k < width; ++k) {
+                out[k * count + i] = in[i * width + k];
+            }
+        }
+    }
+
+    void unshuffle(const unsigned char *in, unsigned char *out, size_t count, size_t width) {
+        for (size_t k = 0; k < width; ++k) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i * width + k] = in[k * count + i];
+            }
+        }
+    }
+
+    // 一块编码后（压缩前）的字节数；有损编码在数据前有一个 float 缩放系数
+    size_t encodedSize(uint8_t encoding, size_t count) {
+        switch (encoding) {
+            case static_cast<uint8_t>(CheckpointEncoding::FLOAT32):
+                return count * sizeof(float);
+            case static_cast<uint8_t>(CheckpointEncoding::FLOAT16):
+                return sizeof(float) + count * sizeof(uint16_t);
+            case static_cast<uint8_t>(CheckpointEncoding::QUANTIZED8):
+                return sizeof(float) + count;
+            default:
+                return count;
+        }
+    }
+
+    void encode(CheckpointEncoding encoding, bool shuffled, const float *values, size_t count,
+                std::vector<unsigned char> &out, std::vector<unsigned char> &scratch) {
+        out.resize(encodedSize(static_cast<uint8_t>(encoding), count));
+        if (encoding == CheckpointEncoding::FLOAT32) {
+            if (shuffled) {
+                shuffle(reinterpret_cast<const unsigned char *>(values), out.data(), count, sizeof(float));
+            } else {
+                std::memcpy(out.data(), values, count * sizeof(float));
+            }
+            return;
+        }
+        float scale = 0;
+        for (size_t i = 0; i < count; ++i) {
+            scale = std::max(scale, std::fabs(values[i]));
+        }
+        std::memcpy(out.data(), &scale, sizeof(scale));
+        const float inverse = scale > 0 ? 1.0f / scale : 0.0f;
+        unsigned char *payload = out.data() + sizeof(float);
+        if (encoding == CheckpointEncoding::FLOAT16) {
+            scratch.resize(count * sizeof(uint16_t));
+            auto *halves = reinterpret_cast<uint16_t *>(shuffled ? scratch.data() : payload);
+            for (size_t i = 0; i < count; ++i) {
+                const uint16_t half = toHalf(values[i] * inverse);
+                std::memcpy(halves + i, &half, sizeof(half));
+            }
+            if (shuffled) {
+                shuffle(scratch.data(), payload, count, sizeof(uint16_t));
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                payload[i] = static_cast<unsigned char>(static_cast<int8_t>(std::lround(values[i] * inverse * 127)));
+            }
+        }
+    }
+
+    void decode(uint8_t encoding, bool shuffled, const unsigned char *in, size_t count, float *values,
+                std::vector<unsigned char> &scratch) {
+        if (encoding == static_cast<uint8_t>(CheckpointEncoding::FLOAT32)) {
+            if (shuffled) {
+                unshuffle(in, reinterpret_cast<unsigned char *>(values), count, sizeof(float));
+            } else {
+                std::memcpy(values, in, count * sizeof(float));
+            }
+            return;
+        }
+        float scale;
+        std::memcpy(&scale, in, sizeof(scale));
+        const unsigned char *payload = in + sizeof(float);
+        if (encoding == static_cast<uint8_t>(CheckpointEncoding::FLOAT16)) {
+            if (shuffled) {
+                scratch.resize(count * sizeof(uint16_t));
+                unshuffle(payload, scratch.data(), count, sizeof(uint16_t));
+                payload = scratch.data();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                uint16_t half;
+                std::memcpy(&half, payload + i * sizeof(half), sizeof(half));
+                values[i] = fromHalf(half) * scale;
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = static_cast<float>(static_cast<int8_t>(payload[i])) / 127 * scale;
+            }
+        }
+    }
+
+}
+
+struct Checkpoint::Entry : SectionEntry {
+    const BlockEntry *blocks = nullptr;  // 指向映射中的块索引
+    // 不压缩的 FLOAT32 段各块首尾相接、大小正确时为 true，read() 可以直接从映射复制
+    bool contiguous = false;
+    // contiguous 时每块的 CRC 是否已经检查过，每块只在第一次读到时检查一次
+    std::shared_ptr<std::atomic<bool>[]> verified;
+};
+
+struct Checkpoint::Writer::Section : SectionEntry {
+    std::vector<BlockEntry> blocks;
+};
+
+Checkpoint::Writer::Writer(const std::string &path, const CheckpointOptions &options)
+        : path(path), temporaryPath(path + ".tmp"), options(options),
+          out(temporaryPath, std::ios::binary | std::ios::trunc) {
+    const FileHeader header{};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!out) {
+        throw std::runtime_error("cannot write checkpoint: " + temporaryPath);
+    }
+}
+
+Checkpoint::Writer::~Writer() {
+    if (!finished) {
+        out.close();
+        std::remove(temporaryPath.c_str());
+    }
+}
+
+void Checkpoint::Writer::writeTree(const GameTree &tree) {
+    std::ostringstream buffer;
+    tree.write(buffer);
+    const std::string bytes = buffer.str();
+    writeBlob(CheckpointSection::TREE, std::vector<unsigned char>(bytes.begin(), bytes.end()));
+}
+
+// 手牌段：u32 手牌数[2]，之后每名玩家依次为 i32 组合编号[n] 和 f32 权重[n]
+void Checkpoint::Writer::writeHands(const std::vector<int> combos[2], const std::vector<float> weights[2]) {
+    std::vector<unsigned char> bytes;
+    auto put = [&](const void *data, size_t size) {
+        const auto *begin = static_cast<const unsigned char *>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+    };
+    for (int player = 0; player < 2; ++player) {
+        const auto count = static_cast<uint32_t>(combos[player].size());
+        put(&count, sizeof(count));
+    }
+    for (int player = 0; player < 2; ++player) {
+        std::vector<int32_t> list(combos[player].begin(), combos[player].end());
+        put(list.data(), list.size() * sizeof(int32_t));
+        put(weights[player].data(), weights[player].size() * sizeof(float));
+    }
+    writeBlob(CheckpointSection::HANDS, bytes);
+}
+
+void Checkpoint::Writer::writeBlob(CheckpointSection kind, const std::vector<unsigned char> &bytes) {
+    if (inSection) {
+        endSection();
+    }
+    Section section{};
+    section.kind = static_cast<uint32_t>(kind);
+    section.encoding = ENCODING_BYTES;
+    section.compressed = options.compression > 0;
+    section.count = bytes.size();
+    section.blockElements = BYTE_BLOCK;
+    sections.push_back(std::move(section));
+    for (size_t offset = 0; offset < bytes.size(); offset += BYTE_BLOCK) {
+        store(bytes.data() + offset, std::min(BYTE_BLOCK, bytes.size() - offset));
+    }
+}
+
+void Checkpoint::Writer::beginSection(CheckpointSection kind, size_t count) {
+    if (inSection) {
+        endSection();
+    }
+    // 段从 64 字节边界开始，不压缩的 FLOAT32 段映射后可以直接当数组用
+    const auto position = static_cast<size_t>(out.tellp());
+    const size_t padding = (SECTION_ALIGNMENT - position % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+    const char zeros[SECTION_ALIGNMENT] = {};
+    out.write(zeros, static_cast<std::streamsize>(padding));
+
+    Section section{};
+    section.kind = static_cast<uint32_t>(kind);
+    section.encoding = static_cast<uint8_t>(options.encoding);
+    section.compressed = options.compression > 0;
+    section.count = count;
+    section.blockElements = FLOAT_BLOCK;
+    sections.push_back(std::move(section));
+    block.clear();
+    block.reserve(FLOAT_BLOCK);
+    remaining = count;
+    inSection = true;
+}
+
+void Checkpoint::Writer::append(const float *data, size_t count) {
+    if (!inSection || count > remaining) {
+        throw std::logic_error("checkpoint section overflow");
+    }
+    remaining -= count;
+    while (count > 0) {
+        const size_t take = std::min(count, FLOAT_BLOCK - block.size());
+        block.insert(block.end(), data, data + take);
+        data += take;
+        count -= take;
+        if (block.size() == FLOAT_BLOCK) {
+            flushBlock();
+        }
+    }
+}
+
+void Checkpoint::Writer::flushBlock() {
+    // 只在压缩时重排字节，不压缩的 FLOAT32 段保持原始数组的样子
+    std::vector<unsigned char> scratch;
+    encode(options.encoding, options.compression > 0, block.data(), block.size(), encoded, scratch);
+    store(encoded.data(), encoded.size());
+    block.clear();
+}
+
+void Checkpoint::Writer::store(const unsigned char *data, size_t size) {
+    if (options.compression > 0) {
+        uLongf length = compressBound(static_cast<uLong>(size));
+        compressed.resize(length);
+        if (compress2(compressed.data(), &length, data, static_cast<uLong>(size), options.compression) != Z_OK) {
+            throw std::runtime_error("cannot compress checkpoint block");
+        }
+        data = compressed.data();
+        size = length;
+    }
+    Section &section = sections.back();
+    section.blocks.push_back({static_cast<uint64_t>(out.tellp()), static_cast<uint32_t>(size), crc(data, size)});
+    section.storedBytes += size;
+    out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+    if (!out) {
+        throw std::runtime_error("cannot write checkpoint: " + temporaryPath);
+    }
+}
+
+void Checkpoint::Writer::endSection() {
+    if (!block.empty()) {
+        flushBlock();
+    }
+    inSection = false;
+    if (remaining != 0) {
+        throw std::logic_error("checkpoint section is incomplete");
+    }
+}
+
+void Checkpoint::Writer::finish(int iterations, int alignment) {
+    if (inSection) {
+        endSection();
+    }
+    std::vector<SectionEntry> directory;
+    for (Section &section: sections) {
+        section.blockCount = section.blocks.size();
+        section.indexOffset = static_cast<uint64_t>(out.tellp());
+        out.write(reinterpret_cast<const char *>(section.blocks.data()),
+                  static_cast<std::streamsize>(section.blocks.size() * sizeof(BlockEntry)));
+        directory.push_back(section);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.sectionCount = static_cast<uint32_t>(directory.size());
+    header.directoryOffset = static_cast<uint64_t>(out.tellp());
+    header.iterations = static_cast<uint32_t>(iterations);
+    header.alignment = static_cast<uint32_t>(alignment);
+    header.directoryChecksum = crc(reinterpret_cast<const unsigned char *>(directory.data()),
+                                   directory.size() * sizeof(SectionEntry));
+    out.write(reinterpret_cast<const char *>(directory.data()),
+              static_cast<std::streamsize>(directory.size() * sizeof(SectionEntry)));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.close();
+    if (!out || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("cannot write checkpoint: " + path);
+    }
+    finished = true;
+}
+
+Checkpoint::Checkpoint() = default;
+
+std::optional<Checkpoint> Checkpoint::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    Checkpoint checkpoint;
+    checkpoint.mapping = mapping;
+    checkpoint.mappingSize = size;
+    const unsigned char *bytes = static_cast<const unsigned char *>(mapping);
+    const auto *header = reinterpret_cast<const FileHeader *>(bytes);
+    const size_t directoryBytes = static_cast<size_t>(header->sectionCount) * sizeof(SectionEntry);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->directoryOffset > size || directoryBytes > size - header->directoryOffset ||
+        crc(bytes + header->directoryOffset, directoryBytes) != header->directoryChecksum || header->alignment == 0) {
+        return std::nullopt;
+    }
+    checkpoint.iterations = static_cast<int>(header->iterations);
+    checkpoint.alignment = static_cast<int>(header->alignment);
+
+    for (uint32_t i = 0; i < header->sectionCount; ++i) {
+        Entry entry;
+        std::memcpy(static_cast<SectionEntry *>(&entry), bytes + header->directoryOffset + i * sizeof(SectionEntry),
+                    sizeof(SectionEntry));
+        if (entry.blockElements == 0 ||
+            entry.blockCount != (entry.count + entry.blockElements - 1) / entry.blockElements ||
+            entry.indexOffset > size || entry.blockCount > (size - entry.indexOffset) / sizeof(BlockEntry)) {
+            return std::nullopt;
+        }
+        entry.blocks = reinterpret_cast<const BlockEntry *>(bytes + entry.indexOffset);
+        for (uint64_t b = 0; b < entry.blockCount; ++b) {
+            if (entry.blocks[b].offset > size || entry.blocks[b].size > size - entry.blocks[b].offset) {
+                return std::nullopt;
+            }
+        }
+        if (!entry.compressed && entry.encoding == static_cast<uint8_t>(CheckpointEncoding::FLOAT32)) {
+            entry.contiguous = true;
+            for (uint64_t b = 0; b < entry.blockCount && entry.contiguous; ++b) {
+                const uint64_t elements = std::min<uint64_t>(entry.blockElements, entry.count - b * entry.blockElements);
+                entry.contiguous = entry.blocks[b].offset == entry.blocks[0].offset + b * entry.blockElements * sizeof(float) &&
+                                   entry.blocks[b].size == elements * sizeof(float);
+            }
+            if (entry.contiguous) {
+                entry.verified.reset(new std::atomic<bool>[entry.blockCount]());
+            }
+        }
+        checkpoint.entries.push_back(entry);
+    }
+
+    const Entry *hands = checkpoint.find(CheckpointSection::HANDS);
+    const Entry *treeEntry = checkpoint.find(CheckpointSection::TREE);
+    if (hands == nullptr || treeEntry == nullptr) {
+        return std::nullopt;
+    }
+    try {
+        const std::vector<unsigned char> handBytes = checkpoint.readBlob(*hands);
+        uint32_t counts[2] = {};
+        if (handBytes.size() < sizeof(counts)) {
+            return std::nullopt;
+        }
+        std::memcpy(counts, handBytes.data(), sizeof(counts));
+        if (handBytes.size() != sizeof(counts) + (static_cast<size_t>(counts[0]) + counts[1]) * 8) {
+            return std::nullopt;
+        }
+        const unsigned char *cursor = handBytes.data() + sizeof(counts);
+        for (int player = 0; player < 2; ++player) {
+            std::vector<int32_t> list(counts[player]);
+            checkpoint.weights[player].resize(counts[player]);
+            std::memcpy(list.data(), cursor, list.size() * sizeof(int32_t));
+            cursor += list.size() * sizeof(int32_t);
+            std::memcpy(checkpoint.weights[player].data(), cursor, list.size() * sizeof(float));
+            cursor += list.size() * sizeof(float);
+            // getRange() 按组合编号写入，findHand() 二分查找，编号必须合法且严格递增
+            for (size_t h = 0; h < list.size(); ++h) {
+                if (list[h] < 0 || list[h] >= COMBO_COUNT || (h > 0 && list[h] <= list[h - 1])) {
+                    return std::nullopt;
+                }
+            }
+            checkpoint.combos[player].assign(list.begin(), list.end());
+        }
+        const std::vector<unsigned char> treeBytes = checkpoint.readBlob(*treeEntry);
+        checkpoint.tree = GameTree::fromBytes(treeBytes.data(), treeBytes.size());
+    } catch (const std::runtime_error &) {
+        return std::nullopt;
+    }
+    if (!checkpoint.tree) {
+        return std::nullopt;
+    }
+    const int counts[2] = {checkpoint.getHandCount(0), checkpoint.getHandCount(1)};
+    checkpoint.strategySize = checkpoint.tree->assignStrategyOffsets(counts, checkpoint.alignment);
+    // 遗憾和策略累加值按树的偏移访问，长度必须与树和手牌数算出的布局一致
+    for (CheckpointSection kind: {CheckpointSection::REGRETS, CheckpointSection::STRATEGY_SUMS}) {
+        const Entry *entry = checkpoint.find(kind);
+        if (entry != nullptr && (entry->encoding == ENCODING_BYTES || entry->count != checkpoint.strategySize)) {
+            return std::nullopt;
+        }
+    }
+    return checkpoint;
+}
+
+Checkpoint::Checkpoint(Checkpoint &&other) noexcept {
+    *this = std::move(other);
+}
+
+Checkpoint &Checkpoint::operator=(Checkpoint &&other) noexcept {
+    if (this != &other) {
+        if (mapping) {
+            munmap(mapping, mappingSize);
+        }
+        mapping = other.mapping;
+        mappingSize = other.mappingSize;
+        iterations = other.iterations;
+        alignment = other.alignment;
+        strategySize = other.strategySize;
+        // 块索引指向映射，映射随之转移，指针仍然有效
+        entries = std::move(other.entries);
+        tree = std::move(other.tree);
+        for (int player = 0; player < 2; ++player) {
+            combos[player] = std::move(other.combos[player]);
+            weights[player] = std::move(other.weights[player]);
+        }
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+    }
+    return *this;
+}
+
+Checkpoint::~Checkpoint() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+}
+
+const Checkpoint::Entry *Checkpoint::find(CheckpointSection kind) const {
+    for (const Entry &entry: entries) {
+        if (entry.kind == static_cast<uint32_t>(kind)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void Checkpoint::decodeBlock(const Entry &entry, size_t index, unsigned char *out,
+                             std::vector<unsigned char> &scratch) const {
+    const BlockEntry &block = entry.blocks[index];
+    const unsigned char *stored = static_cast<const unsigned char *>(mapping) + block.offset;
+    if (crc(stored, block.size) != block.checksum) {
+        throw std::runtime_error("checkpoint block is corrupt");
+    }
+    const size_t count = std::min<uint64_t>(entry.blockElements, entry.count - index * entry.blockElements);
+    const size_t expected = encodedSize(entry.encoding, count);
+    const unsigned char *raw = stored;
+    std::vector<unsigned char> inflated;
+    if (entry.compressed) {
+        inflated.resize(expected);
+        uLongf length = static_cast<uLongf>(expected);
+        if (uncompress(inflated.data(), &length, stored, block.size) != Z_OK || length != expected) {
+            throw std::runtime_error("checkpoint block is corrupt");
+        }
+        raw = inflated.data();
+    } else if (block.size != expected) {
+        throw std::runtime_error("checkpoint block is corrupt");
+    }
+    if (entry.encoding == ENCODING_BYTES) {
+        std::memcpy(out, raw, count);
+    } else {
+        decode(entry.encoding, entry.compressed != 0, raw, count, reinterpret_cast<float *>(out), scratch);
+    }
+}
+
+std::vector<unsigned char> Checkpoint::readBlob(const Entry &entry) const {
+    std::vector<unsigned char> bytes(entry.count);
+    std::vector<unsigned char> scratch;
+    for (size_t b = 0; b < entry.blockCount; ++b) {
+        decodeBlock(entry, b, bytes.data() + b * entry.blockElements, scratch);
+    }
+    return bytes;
+}
+
+GameTree Checkpoint::readTree() const {
+    const std::vector<unsigned char> bytes = readBlob(*find(CheckpointSection::TREE));
+    return std::move(*GameTree::fromBytes(bytes.data(), bytes.size()));
+}
+
+Range Checkpoint::getRange(int player) const {
+    Range range;
+    for (size_t h = 0; h < combos[player].size(); ++h) {
+        range.setWeight(combos[player][h], weights[player][h]);
+    }
+    return range;
+}
+
+int Checkpoint::findHand(int player, int combo) const {
+    auto found = std::lower_bound(combos[player].begin(), combos[player].end(), combo);
+    return found != combos[player].end() && *found == combo ? static_cast<int>(found - combos[player].begin()) : -1;
+}
+
+bool Checkpoint::hasSection(CheckpointSection kind) const {
+    return find(kind) != nullptr;
+}
+
+size_t Checkpoint::sectionSize(CheckpointSection kind) const {
+    const Entry *entry = find(kind);
+    return entry != nullptr && entry->encoding != ENCODING_BYTES ? entry->count : 0;
+}
+
+void Checkpoint::read(CheckpointSection kind, size_t first, size_t count, float *out) const {
+    const Entry *entry = find(kind);
+    if (entry == nullptr || entry->encoding == ENCODING_BYTES || first > entry->count || count > entry->count - first) {
+        throw std::out_of_range("checkpoint section has no such range");
+    }
+    if (count == 0) {
+        return;
+    }
+    const size_t last = first + count;
+    // 不压缩的 FLOAT32 段各块首尾相接，检查过用到的块的 CRC 后直接从映射中复制，只会读入用到的页；
+    // 有块校验不过时走下面逐块解码的路径，由 decodeBlock() 报告损坏
+    if (entry->contiguous) {
+        bool intact = true;
+        for (size_t b = first / entry->blockElements; b * entry->blockElements < last && intact; ++b) {
+            if (!entry->verified[b].load(std::memory_order_acquire)) {
+                const BlockEntry &block = entry->blocks[b];
+                intact = crc(static_cast<const unsigned char *>(mapping) + block.offset, block.size) == block.checksum;
+                entry->verified[b].store(intact, std::memory_order_release);
+            }
+        }
+        if (intact) {
+            const unsigned char *base = static_cast<const unsigned char *>(mapping) + entry->blocks[0].offset;
+            std::memcpy(out, base + first * sizeof(float), count * sizeof(float));
+            return;
+        }
+    }
+    std::vector<float> values(entry->blockElements);
+    std::vector<unsigned char> scratch;
+    for (size_t b = first / entry->blockElements; b * entry->blockElements < last; ++b) {
+        const size_t blockStart = b * entry->blockElements;
+        decodeBlock(*entry, b, reinterpret_cast<unsigned char *>(values.data()), scratch);
+        const size_t begin = std::max(first, blockStart);
+        const size_t end = std::min<size_t>(last, blockStart + entry->blockElements);
+        std::copy(values.begin() + (begin - blockStart), values.begin() + (end - blockStart), out + (begin - first));
+    }
+}
+
+std::vector<float> Checkpoint::getAverageStrategy(int node) const {
+    if (tree->getType(node) != NodeType::ACTION || !hasSection(CheckpointSection::STRATEGY_SUMS)) {
+        return {};
+    }
+    const int actions = tree->getChildCount(node);
+    const int count = getHandCount(tree->getPlayer(node));
+    const int stride = (count + alignment - 1) / alignment * alignment;
+    std::vector<float> sums(static_cast<size_t>(actions) * stride);
+    read(CheckpointSection::STRATEGY_SUMS, tree->getStrategyOffset(node), sums.size(), sums.data());
+    std::vector<float> strategy(static_cast<size_t>(actions) * count);
+    for (int h = 0; h < count; ++h) {
+        float total = 0;
+        for (int a = 0; a < actions; ++a) {
+            total += sums[a * stride + h];
+        }
+        for (int a = 0; a < actions; ++a) {
+            strategy[a * count + h] = total > 0 ? sums[a * stride + h] / total : 1.0f / actions;
+        }
+    }
+    return strategy;
+}
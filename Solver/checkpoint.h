@@ -0,0 +1,134 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "gametree.h"
+#include "../Range/range.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// 浮点数据段的存储方式；有损方式每块按块内最大绝对值缩放到 [-1, 1] 再编码
+enum class CheckpointEncoding : uint8_t {
+    FLOAT32,     // 原样保存，恢复后继续迭代与不中断完全一致
+    FLOAT16,     // 半精度，体积减半
+    QUANTIZED8   // 8 位量化，约为原来的四分之一，只适合保存用于查询的策略
+};
+
+struct CheckpointOptions {
+    CheckpointEncoding encoding = CheckpointEncoding::FLOAT32;
+    int compression = 1;  // zlib 压缩级别，0 表示不压缩
+};
+
+enum class CheckpointSection : uint32_t {
+    TREE = 1,           // GameTree::save() 写出的完整树文件
+    HANDS = 2,          // 每名玩家的手牌组合和权重
+    REGRETS = 3,        // 累计遗憾，只有可以继续求解的检查点才有
+    STRATEGY_SUMS = 4   // 策略累加值；只保存策略时为归一化后的平均策略
+};
+
+// 求解器检查点文件
+//   文件头 64 字节 | 各段数据 | 各段的块索引 | 段目录
+// 每段切成固定大小的块，每块单独编码、压缩并带 CRC32，因此写入和读取都只需要一块的额外内存，
+// 也可以只解码某个节点用到的那几块。float 数据压缩前按字节重排（所有数的第 0 字节、第 1 字节……），
+// 指数和高位字节连在一起，zlib 的压缩率明显更高。不压缩的 FLOAT32 段是连续的原始数组，
+// open() 映射后可以直接使用。
+class Checkpoint {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // 映射文件并读出目录和树，数据段在用到时才读取
+    // 文件不存在、格式或版本不符，手牌组合非法或未排序，遗憾、策略累加值的长度与树不符时返回空
+    static std::optional<Checkpoint> open(const std::string &path);
+
+    Checkpoint(Checkpoint &&other) noexcept;
+    Checkpoint &operator=(Checkpoint &&other) noexcept;
+    Checkpoint(const Checkpoint &) = delete;
+    Checkpoint &operator=(const Checkpoint &) = delete;
+    ~Checkpoint();
+
+    [[nodiscard]] int getIterations() const { return iterations; }
+    [[nodiscard]] int getAlignment() const { return alignment; }
+    // 按树、手牌数和对齐算出的遗憾/策略累加值的长度；open() 保证存在的这两段都是这个长度
+    [[nodiscard]] size_t getStrategySize() const { return strategySize; }
+    [[nodiscard]] const GameTree &getTree() const { return *tree; }
+    // 按检查点中的树重新建一棵（求解器需要拥有自己的树）
+    [[nodiscard]] GameTree readTree() const;
+    [[nodiscard]] int getHandCount(int player) const { return static_cast<int>(combos[player].size()); }
+    [[nodiscard]] int getHandCombo(int player, int hand) const { return combos[player][hand]; }
+    // 组合在玩家手牌中的下标，不在范围内时为 -1
+    [[nodiscard]] int findHand(int player, int combo) const;
+    // 只包含检查点中手牌的范围，用它构造的求解器与保存时的手牌顺序相同
+    [[nodiscard]] Range getRange(int player) const;
+
+    [[nodiscard]] bool hasSection(CheckpointSection kind) const;
+    // 段中 float 的个数，段不存在时为 0
+    [[nodiscard]] size_t sectionSize(CheckpointSection kind) const;
+    // 解码段中 [first, first + count) 的 float 到 out，只读取涉及的块；块校验失败时抛出 std::runtime_error
+    void read(CheckpointSection kind, size_t first, size_t count, float *out) const;
+
+    // 行动节点的平均策略，按 [动作][手牌] 排列，与 CfrSolver::getAverageStrategy() 相同
+    [[nodiscard]] std::vector<float> getAverageStrategy(int node) const;
+
+    // 流式写入：先写文件头占位，逐段追加数据，finish() 写出目录后改名为目标文件，
+    // 写到一半中断时不会破坏已有的检查点。写入失败时抛出 std::runtime_error。
+    class Writer {
+    public:
+        Writer(const std::string &path, const CheckpointOptions &options);
+        Writer(const Writer &) = delete;
+        Writer &operator=(const Writer &) = delete;
+        ~Writer();
+
+        void writeTree(const GameTree &tree);
+        void writeHands(const std::vector<int> combos[2], const std::vector<float> weights[2]);
+        // 开始一个 float 段，之后用 append() 分任意多次写入，一共 count 个
+        void beginSection(CheckpointSection kind, size_t count);
+        void append(const float *data, size_t count);
+        void finish(int iterations, int alignment);
+
+    private:
+        struct Section;
+
+        void writeBlob(CheckpointSection kind, const std::vector<unsigned char> &bytes);
+        // 压缩（如果开启）并写出一块已编码的数据
+        void store(const unsigned char *data, size_t size);
+        void flushBlock();
+        void endSection();
+
+        std::string path;
+        std::string temporaryPath;
+        CheckpointOptions options;
+        std::ofstream out;
+        std::vector<Section> sections;
+        std::vector<float> block;
+        std::vector<unsigned char> encoded;
+        std::vector<unsigned char> compressed;
+        size_t remaining = 0;  // 当前 float 段还要写入的个数
+        bool inSection = false;
+        bool finished = false;
+    };
+
+private:
+    struct Entry;
+
+    Checkpoint();
+
+    [[nodiscard]] const Entry *find(CheckpointSection kind) const;
+    // 解码第 index 块的原始字节或 float 到 out
+    void decodeBlock(const Entry &entry, size_t index, unsigned char *out, std::vector<unsigned char> &scratch) const;
+    [[nodiscard]] std::vector<unsigned char> readBlob(const Entry &entry) const;
+
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+    int iterations = 0;
+    int alignment = 0;
+    size_t strategySize = 0;
+    std::vector<Entry> entries;
+    std::optional<GameTree> tree;
+    std::vector<int> combos[2];
+    std::vector<float> weights[2];
+};
+
+#endif  // CHECKPOINT_H
@@ -0,0 +1,503 @@
+#include "gametree.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+    constexpr char MAGIC[8] = {'A', 'Y', 'T', 'R', 'E', 'E', 0, 0};
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t nodeCount;
+        uint32_t edgeCount;
+        uint32_t reserved;
+        uint64_t board;
+        float pot;
+        float stack;
+        uint64_t arenaBytes;
+        uint64_t checksum;       // 下注尺度和 arena 的 FNV-1a
+        uint8_t sizeCounts[4];   // 转牌下注、转牌加注、河牌下注、河牌加注的尺度个数
+        uint8_t allIn[2];
+        uint8_t maxRaises[2];    // 之后为 float[尺度总数]（补齐到 8 字节）和 arena
+    };
+    static_assert(sizeof(FileHeader) == 64, "file header layout changed");
+
+    uint64_t fnv1a(const unsigned char *data, size_t size, uint64_t hash = 0xCBF29CE484222325ull) {
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    size_t align8(size_t bytes) {
+        return (bytes + 7) & ~static_cast<size_t>(7);
+    }
+
+    // arena 中各数组的起始位置，每个数组按 8 字节对齐
+    struct Layout {
+        size_t committed, firstEdge, children, amounts, types, players, streets, actionTypes, cards, total;
+
+        Layout(size_t nodes, size_t edges) {
+            size_t offset = 0;
+            auto section = [&](size_t bytes) {
+                const size_t start = offset;
+                offset += align8(bytes);
+                return start;
+            };
+            committed = section(2 * nodes * sizeof(float));
+            firstEdge = section((nodes + 1) * sizeof(uint32_t));
+            children = section(edges * sizeof(uint32_t));
+            amounts = section(edges * sizeof(float));
+            types = section(nodes);
+            players = section(nodes);
+            streets = section(nodes);
+            actionTypes = section(edges);
+            cards = section(edges);
+            total = offset;
+        }
+    };
+
+    std::vector<float> sizeList(const TreeConfig &config) {
+        std::vector<float> sizes;
+        for (const std::vector<float> *list: {&config.turn.betSizes, &config.turn.raiseSizes,
+                                              &config.river.betSizes, &config.river.raiseSizes}) {
+            sizes.insert(sizes.end(), list->begin(), list->end());
+        }
+        return sizes;
+    }
+
+}
+
+// 构建时先按字段追加到各自的 vector，完成后一次性拷进 arena
+struct GameTree::Builder {
+    CardSet board;
+    const TreeConfig &config;
+    std::vector<uint8_t> types;
+    std::vector<uint8_t> players;
+    std::vector<uint8_t> streets;
+    std::vector<float> committed;
+    std::vector<uint32_t> firstEdge;
+    std::vector<uint32_t> children;
+    std::vector<uint8_t> actionTypes;
+    std::vector<float> amounts;
+    std::vector<CardIndex> cards;
+
+    Builder(CardSet board, const TreeConfig &config) : board(board), config(config) {}
+
+    // 新节点的 edges 条边紧跟在之前所有节点的边之后，子节点建好后再填入
+    int addNode(NodeType type, int player, int street, float committed0, float committed1, size_t edges) {
+        const int index = static_cast<int>(types.size());
+        if (types.size() >= UINT32_MAX || children.size() + edges >= UINT32_MAX) {
+            throw std::length_error("game tree does not fit 32-bit offsets");
+        }
+        types.push_back(static_cast<uint8_t>(type));
+        players.push_back(static_cast<uint8_t>(player));
+        streets.push_back(static_cast<uint8_t>(street));
+        committed.push_back(committed0);
+        committed.push_back(committed1);
+        firstEdge.push_back(static_cast<uint32_t>(children.size()));
+        children.resize(children.size() + edges, 0);
+        actionTypes.resize(children.size(), 0);
+        amounts.resize(children.size(), 0);
+        cards.resize(children.size(), 0);
+        return index;
+    }
+
+    int buildAction(int street, int player, float committed0, float committed1, int raises, bool opened);
+    int buildStreetEnd(int street, float committed0, float committed1);
+};
+
+GameTree GameTree::build(CardSet board, const TreeConfig &config) {
+    if (board.size() != 4 && board.size() != 5) {
+        throw std::invalid_argument("subgame board needs four or five cards");
+    }
+    Builder builder(board, config);
+    builder.buildAction(board.size(), 0, 0, 0, 0, false);
+    builder.firstEdge.push_back(static_cast<uint32_t>(builder.children.size()));
+
+    GameTree tree;
+    tree.board = board;
+    tree.config = config;
+    tree.nodeCount = static_cast<uint32_t>(builder.types.size());
+    tree.edgeCount = static_cast<uint32_t>(builder.children.size());
+    const Layout layout(tree.nodeCount, tree.edgeCount);
+    tree.arenaBytes = layout.total;
+    tree.storage.assign(layout.total / sizeof(uint64_t), 0);
+    unsigned char *arena = reinterpret_cast<unsigned char *>(tree.storage.data());
+    auto copy = [&](size_t offset, const auto &values) {
+        std::memcpy(arena + offset, values.data(), values.size() * sizeof(values[0]));
+    };
+    copy(layout.committed, builder.committed);
+    copy(layout.firstEdge, builder.firstEdge);
+    copy(layout.children, builder.children);
+    copy(layout.amounts, builder.amounts);
+    copy(layout.types, builder.types);
+    copy(layout.players, builder.players);
+    copy(layout.streets, builder.streets);
+    copy(layout.actionTypes, builder.actionTypes);
+    copy(layout.cards, builder.cards);
+    tree.bind(arena);
+    return tree;
+}
+
+void GameTree::bind(const unsigned char *base) {
+    const Layout layout(nodeCount, edgeCount);
+    arena = base;
+    committed = reinterpret_cast<const float *>(arena + layout.committed);
+    firstEdge = reinterpret_cast<const uint32_t *>(arena + layout.firstEdge);
+    children = reinterpret_cast<const uint32_t *>(arena + layout.children);
+    amounts = reinterpret_cast<const float *>(arena + layout.amounts);
+    types = arena + layout.types;
+    players = arena + layout.players;
+    streets = arena + layout.streets;
+    actionTypes = arena + layout.actionTypes;
+    cards = arena + layout.cards;
+}
+
+// 一轮下注结束：河牌进入摊牌，转牌发河牌
+int GameTree::Builder::buildStreetEnd(int street, float committed0, float committed1) {
+    if (street == 5) {
+        return addNode(NodeType::SHOWDOWN, 0, street, committed0, committed1, 0);
+    }
+
+    const CardSet rivers = CardSet::full() - board;
+    const int index = addNode(NodeType::CHANCE, 0, street, committed0, committed1, rivers.size());
+    const bool allIn = std::max(committed0, committed1) >= config.stack;
+    int i = 0;
+    for (Card card: rivers) {
+        int child;
+        if (allIn) {
+            child = addNode(NodeType::SHOWDOWN, 0, 5, committed0, committed1, 0);
+        } else {
+            child = buildAction(street + 1, 0, committed0, committed1, 0, false);
+        }
+        const uint32_t edge = firstEdge[index] + i++;
+        children[edge] = static_cast<uint32_t>(child);
+        cards[edge] = card.getIndex();
+    }
+    return index;
+}
+
+// opened 表示本轮已经有人行动过（用于判断过牌后是否结束本轮）
+int GameTree::Builder::buildAction(int street, int player, float committed0, float committed1, int raises, bool opened) {
+    const BetSizeConfig &sizes = street == 4 ? config.turn : config.river;
+    float committedNow[2] = {committed0, committed1};
+    const int opponent = 1 - player;
+    const float toCall = committedNow[opponent] - committedNow[player];
+    const float pot = config.pot + committedNow[0] + committedNow[1];
+
+    std::vector<Action> actions;
+    if (toCall > 0) {
+        actions.push_back({ActionType::FOLD, committedNow[player]});
+        actions.push_back({ActionType::CALL, committedNow[opponent]});
+    } else {
+        actions.push_back({ActionType::CHECK, committedNow[player]});
+    }
+
+    // 下注/加注尺度，超过剩余筹码的都合并为全下
+    if (committedNow[opponent] < config.stack) {
+        const bool raising = toCall > 0;
+        if (!raising || raises < sizes.maxRaises) {
+            const std::vector<float> &fractions = raising ? sizes.raiseSizes : sizes.betSizes;
+            for (float fraction: fractions) {
+                float amount = committedNow[opponent] + fraction * (pot + toCall);
+                amount = std::round(amount * 100) / 100;
+                if (amount >= config.stack) {
+                    continue;
+                }
+                bool duplicate = false;
+                for (const Action &action: actions) {
+                    duplicate = duplicate || (action.type != ActionType::FOLD && action.amount == amount);
+                }
+                if (!duplicate) {
+                    actions.push_back({raising ? ActionType::RAISE : ActionType::BET, amount});
+                }
+            }
+            if (sizes.allIn || actions.size() == (raising ? 2u : 1u)) {
+                actions.push_back({ActionType::ALLIN, config.stack});
+            }
+        }
+    }
+
+    const int index = addNode(NodeType::ACTION, player, street, committed0, committed1, actions.size());
+    for (size_t i = 0; i < actions.size(); ++i) {
+        const Action &action = actions[i];
+        float next[2] = {committedNow[0], committedNow[1]};
+        int child = 0;
+        switch (action.type) {
+            case ActionType::FOLD:
+                child = addNode(NodeType::FOLD, player, street, committedNow[0], committedNow[1], 0);
+                break;
+            case ActionType::CHECK:
+                if (player == 1 || opened) {
+                    child = buildStreetEnd(street, next[0], next[1]);
+                } else {
+                    child = buildAction(street, opponent, next[0], next[1], raises, true);
+                }
+                break;
+            case ActionType::CALL:
+                next[player] = committedNow[opponent];
+                child = buildStreetEnd(street, next[0], next[1]);
+                break;
+            case ActionType::BET:
+            case ActionType::RAISE:
+            case ActionType::ALLIN:
+                next[player] = action.amount;
+                child = buildAction(street, opponent, next[0], next[1], toCall > 0 ? raises + 1 : raises, true);
+                break;
+        }
+        const uint32_t edge = firstEdge[index] + static_cast<uint32_t>(i);
+        children[edge] = static_cast<uint32_t>(child);
+        actionTypes[edge] = static_cast<uint8_t>(action.type);
+        amounts[edge] = action.amount;
+    }
+    return index;
+}
+
+uint32_t GameTree::assignStrategyOffsets(const int handCounts[2], int alignment) {
+    strategyOffsets.assign(nodeCount, 0);
+    uint32_t offset = 0;
+    for (uint32_t node = 0; node < nodeCount; ++node) {
+        if (getType(static_cast<int>(node)) != NodeType::ACTION) {
+            continue;
+        }
+        strategyOffsets[node] = offset;
+        uint32_t stride = (handCounts[players[node]] + alignment - 1) / alignment * alignment;
+        offset += stride * static_cast<uint32_t>(getChildCount(static_cast<int>(node)));
+    }
+    return offset;
+}
+
+void GameTree::save(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    write(out);
+    if (!out) {
+        throw std::runtime_error("cannot write game tree: " + path);
+    }
+}
+
+void GameTree::write(std::ostream &out) const {
+    const std::vector<float> sizes = sizeList(config);
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nodeCount = nodeCount;
+    header.edgeCount = edgeCount;
+    header.board = board.getBits();
+    header.pot = config.pot;
+    header.stack = config.stack;
+    header.arenaBytes = arenaBytes;
+    header.sizeCounts[0] = static_cast<uint8_t>(config.turn.betSizes.size());
+    header.sizeCounts[1] = static_cast<uint8_t>(config.turn.raiseSizes.size());
+    header.sizeCounts[2] = static_cast<uint8_t>(config.river.betSizes.size());
+    header.sizeCounts[3] = static_cast<uint8_t>(config.river.raiseSizes.size());
+    header.allIn[0] = config.turn.allIn;
+    header.allIn[1] = config.river.allIn;
+    header.maxRaises[0] = static_cast<uint8_t>(config.turn.maxRaises);
+    header.maxRaises[1] = static_cast<uint8_t>(config.river.maxRaises);
+    if (sizes.size() > 255) {
+        throw std::invalid_argument("too many bet sizes to save");
+    }
+
+    std::vector<unsigned char> sizeBytes(align8(sizes.size() * sizeof(float)), 0);
+    std::memcpy(sizeBytes.data(), sizes.data(), sizes.size() * sizeof(float));
+    header.checksum = fnv1a(arena, arenaBytes, fnv1a(sizeBytes.data(), sizeBytes.size()));
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(sizeBytes.data()), static_cast<std::streamsize>(sizeBytes.size()));
+    out.write(reinterpret_cast<const char *>(arena), static_cast<std::streamsize>(arenaBytes));
+}
+
+size_t GameTree::readHeader(const unsigned char *bytes, size_t size) {
+    if (size < sizeof(FileHeader)) {
+        return 0;
+    }
+    const auto *header = reinterpret_cast<const FileHeader *>(bytes);
+    const size_t sizeCount = static_cast<size_t>(header->sizeCounts[0]) + header->sizeCounts[1] +
+                             header->sizeCounts[2] + header->sizeCounts[3];
+    const size_t arenaStart = sizeof(FileHeader) + align8(sizeCount * sizeof(float));
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->nodeCount == 0 || Layout(header->nodeCount, header->edgeCount).total != header->arenaBytes ||
+        arenaStart + header->arenaBytes != size) {
+        return 0;
+    }
+
+    board = CardSet(header->board);
+    nodeCount = header->nodeCount;
+    edgeCount = header->edgeCount;
+    arenaBytes = header->arenaBytes;
+    config.pot = header->pot;
+    config.stack = header->stack;
+    const float *sizes = reinterpret_cast<const float *>(bytes + sizeof(FileHeader));
+    std::vector<float> *lists[4] = {&config.turn.betSizes, &config.turn.raiseSizes,
+                                    &config.river.betSizes, &config.river.raiseSizes};
+    for (int i = 0; i < 4; ++i) {
+        lists[i]->assign(sizes, sizes + header->sizeCounts[i]);
+        sizes += header->sizeCounts[i];
+    }
+    config.turn.allIn = header->allIn[0] != 0;
+    config.river.allIn = header->allIn[1] != 0;
+    config.turn.maxRaises = header->maxRaises[0];
+    config.river.maxRaises = header->maxRaises[1];
+    return arenaStart;
+}
+
+std::optional<GameTree> GameTree::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    GameTree tree;
+    tree.mapping = mapping;
+    tree.mappingSize = size;
+    const unsigned char *bytes = static_cast<const unsigned char *>(mapping);
+    const size_t arenaStart = tree.readHeader(bytes, size);
+    if (arenaStart == 0) {
+        return std::nullopt;
+    }
+    tree.bind(bytes + arenaStart);
+    if (!tree.checkStructure()) {
+        return std::nullopt;
+    }
+    return tree;
+}
+
+std::optional<GameTree> GameTree::fromBytes(const unsigned char *bytes, size_t size) {
+    GameTree tree;
+    const size_t arenaStart = tree.readHeader(bytes, size);
+    if (arenaStart == 0) {
+        return std::nullopt;
+    }
+    // 数据不一定按 8 字节对齐，复制到自己的 arena 中
+    tree.storage.assign(align8(tree.arenaBytes) / sizeof(uint64_t), 0);
+    std::memcpy(tree.storage.data(), bytes + arenaStart, tree.arenaBytes);
+    tree.bind(reinterpret_cast<const unsigned char *>(tree.storage.data()));
+    if (!tree.checkStructure()) {
+        return std::nullopt;
+    }
+    return tree;
+}
+
+bool GameTree::checkStructure() const {
+    const int boardCards = board.size();
+    if (nodeCount == 0 || firstEdge[0] != 0 || firstEdge[nodeCount] != edgeCount ||
+        (board.getBits() >> CARD_COUNT) != 0 || boardCards < 4 || boardCards > 5) {
+        return false;
+    }
+    // 每个节点已发出的牌（公共牌加路径上的发牌），子节点编号大于父节点，按编号顺序一遍就能算出
+    std::vector<uint64_t> dealt(nodeCount, 0);
+    std::vector<uint8_t> parents(nodeCount, 0);
+    dealt[0] = board.getBits();
+    for (uint32_t node = 0; node < nodeCount; ++node) {
+        const uint32_t begin = firstEdge[node];
+        const uint32_t end = firstEdge[node + 1];
+        if (end < begin || types[node] > static_cast<uint8_t>(NodeType::SHOWDOWN) || players[node] > 1 ||
+            streets[node] < boardCards || streets[node] > 5 || (node > 0 && parents[node] != 1)) {
+            return false;
+        }
+        // 行动和发牌节点至少有一个子节点（CFR 按动作数归一化），弃牌和摊牌节点是叶子；河牌之后不再发牌
+        const NodeType type = static_cast<NodeType>(types[node]);
+        const bool leaf = type == NodeType::FOLD || type == NodeType::SHOWDOWN;
+        if (leaf != (begin == end) || (type == NodeType::CHANCE && streets[node] == 5)) {
+            return false;
+        }
+        uint64_t siblings = 0;
+        for (uint32_t edge = begin; edge < end; ++edge) {
+            // 子节点按深度优先编号，总是大于父节点，所以遍历不会成环；每个子节点只有一个父节点
+            const uint32_t child = children[edge];
+            if (child <= node || child >= nodeCount || ++parents[child] != 1) {
+                return false;
+            }
+            if (type == NodeType::CHANCE) {
+                // 发的牌不能已经在公共牌上或与同一节点的其他发牌重复，发牌后进入下一条街
+                if (cards[edge] >= CARD_COUNT) {
+                    return false;
+                }
+                const uint64_t card = 1ull << cards[edge];
+                if (((dealt[node] | siblings) & card) != 0 || streets[child] != streets[node] + 1) {
+                    return false;
+                }
+                siblings |= card;
+                dealt[child] = dealt[node] | card;
+            } else {
+                if (actionTypes[edge] > static_cast<uint8_t>(ActionType::ALLIN) || streets[child] != streets[node]) {
+                    return false;
+                }
+                dealt[child] = dealt[node];
+            }
+        }
+    }
+    return true;
+}
+
+bool GameTree::verify() const {
+    if (mapping == nullptr) {
+        return true;
+    }
+    const unsigned char *bytes = static_cast<const unsigned char *>(mapping);
+    const auto *header = reinterpret_cast<const FileHeader *>(bytes);
+    return fnv1a(bytes + sizeof(FileHeader), mappingSize - sizeof(FileHeader)) == header->checksum;
+}
+
+GameTree::GameTree(GameTree &&other) noexcept {
+    *this = std::move(other);
+}
+
+GameTree &GameTree::operator=(GameTree &&other) noexcept {
+    if (this != &other) {
+        if (mapping) {
+            munmap(mapping, mappingSize);
+        }
+        board = other.board;
+        config = std::move(other.config);
+        nodeCount = other.nodeCount;
+        edgeCount = other.edgeCount;
+        arenaBytes = other.arenaBytes;
+        arena = other.arena;
+        types = other.types;
+        players = other.players;
+        streets = other.streets;
+        committed = other.committed;
+        firstEdge = other.firstEdge;
+        children = other.children;
+        actionTypes = other.actionTypes;
+        amounts = other.amounts;
+        cards = other.cards;
+        // vector 移动后缓冲区地址不变，指向 arena 的指针仍然有效
+        storage = std::move(other.storage);
+        mapping = other.mapping;
+        mappingSize = other.mappingSize;
+        strategyOffsets = std::move(other.strategyOffsets);
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+        other.nodeCount = 0;
+        other.edgeCount = 0;
+    }
+    return *this;
+}
+
+GameTree::~GameTree() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+}
@@ -0,0 +1,164 @@
+#ifndef GAMETREE_H
+#define GAMETREE_H
+
+#include "../Card/cardset.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class NodeType : uint8_t {
+    ACTION,
+    CHANCE,
+    FOLD,
+    SHOWDOWN
+};
+
+enum class ActionType : uint8_t {
+    FOLD,
+    CHECK,
+    CALL,
+    BET,
+    RAISE,
+    ALLIN
+};
+
+struct Action {
+    ActionType type;
+    float amount;  // 下注或加注后该玩家在本子博弈中的总投入
+};
+
+inline const char *actionName(ActionType type) {
+    switch (type) {
+        case ActionType::FOLD:
+            return "fold";
+        case ActionType::CHECK:
+            return "check";
+        case ActionType::CALL:
+            return "call";
+        case ActionType::BET:
+            return "bet";
+        case ActionType::RAISE:
+            return "raise";
+        case ActionType::ALLIN:
+            return "allin";
+    }
+    return "?";
+}
+
+// 每条街的下注尺度，都是底池的比例
+struct BetSizeConfig {
+    std::vector<float> betSizes = {0.5f, 1.0f};
+    std::vector<float> raiseSizes = {1.0f};
+    bool allIn = true;
+    int maxRaises = 2;
+};
+
+// 单挑子博弈：两名玩家在开始时各向底池投入了 pot / 2，剩余有效筹码为 stack
+// 玩家 0 为不在位置（先行动），玩家 1 为在位置
+struct TreeConfig {
+    float pot = 100;
+    float stack = 100;
+    BetSizeConfig turn;
+    BetSizeConfig river;
+};
+
+// 翻后子博弈的博弈树
+// 所有节点放在一块连续的内存（arena）中，按字段分成数组（SoA），不含指针：
+//   节点  type u8[n]  player u8[n]  street u8[n]  committed f32[2n]  firstEdge u32[n + 1]
+//   边    child u32[e]  actionType u8[e]  amount f32[e]  card u8[e]
+// 节点 i 的子节点是边 [firstEdge[i], firstEdge[i + 1])，按深度优先顺序编号，子节点编号总是大于父节点。
+// 行动节点的边对应动作，发牌节点的边对应河牌。arena 的内容与位置无关，save() 原样写出，
+// open() 用 mmap 映射后直接使用，不解析、不复制。
+class GameTree {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // board 为 4 张（转牌开始）或 5 张（河牌开始）
+    static GameTree build(CardSet board, const TreeConfig &config);
+    // 写入失败时抛出 std::runtime_error
+    void save(const std::string &path) const;
+    // 映射 save() 写出的文件；文件不存在、格式或版本不符、结构不合法时返回空
+    static std::optional<GameTree> open(const std::string &path);
+    // 与 save() 相同的内容写入流，用于嵌入其他文件
+    void write(std::ostream &out) const;
+    // 从内存中 save() 格式的数据复制出一棵树；格式或版本不符、结构不合法时返回空
+    static std::optional<GameTree> fromBytes(const unsigned char *bytes, size_t size);
+
+    GameTree(GameTree &&other) noexcept;
+    GameTree &operator=(GameTree &&other) noexcept;
+    GameTree(const GameTree &) = delete;
+    GameTree &operator=(const GameTree &) = delete;
+    ~GameTree();
+
+    [[nodiscard]] NodeType getType(int node) const { return static_cast<NodeType>(types[node]); }
+    // 行动节点的行动玩家；弃牌节点的弃牌玩家
+    [[nodiscard]] int getPlayer(int node) const { return players[node]; }
+    // 公共牌张数：4 为转牌，5 为河牌
+    [[nodiscard]] int getStreet(int node) const { return streets[node]; }
+    // 玩家在本子博弈中的投入
+    [[nodiscard]] float getCommitted(int node, int player) const { return committed[2 * node + player]; }
+    [[nodiscard]] int getChildCount(int node) const { return static_cast<int>(firstEdge[node + 1] - firstEdge[node]); }
+    [[nodiscard]] int getChild(int node, int i) const { return static_cast<int>(children[firstEdge[node] + i]); }
+    // 行动节点第 i 个子节点对应的行动
+    [[nodiscard]] Action getAction(int node, int i) const {
+        const uint32_t edge = firstEdge[node] + i;
+        return {static_cast<ActionType>(actionTypes[edge]), amounts[edge]};
+    }
+    // 发牌节点第 i 个子节点对应的河牌
+    [[nodiscard]] CardIndex getCard(int node, int i) const { return cards[firstEdge[node] + i]; }
+
+    [[nodiscard]] int getNodeCount() const { return static_cast<int>(nodeCount); }
+    [[nodiscard]] int getRoot() const { return 0; }
+    [[nodiscard]] CardSet getBoard() const { return board; }
+    [[nodiscard]] const TreeConfig &getConfig() const { return config; }
+    // arena 的字节数，约为 11 字节每节点加 10 字节每条边
+    [[nodiscard]] size_t memoryBytes() const { return arenaBytes; }
+    // 重新计算校验和，检查映射的文件内容是否完整
+    [[nodiscard]] bool verify() const;
+
+    // 根据每名玩家的手牌数为行动节点分配策略数组位置，返回数组总长度
+    // 位置与求解器的数组布局有关，不属于树本身，单独存放，不写入文件
+    uint32_t assignStrategyOffsets(const int handCounts[2], int alignment);
+    // 行动节点在策略/遗憾数组中的起始位置（按手牌数对齐）
+    [[nodiscard]] uint32_t getStrategyOffset(int node) const { return strategyOffsets[node]; }
+
+private:
+    struct Builder;
+
+    GameTree() = default;
+    // 按节点数和边数划分 arena，设置各数组的指针
+    void bind(const unsigned char *base);
+    // 检查文件头并读出配置，返回 arena 在数据中的起始位置；格式不符时返回 0
+    size_t readHeader(const unsigned char *bytes, size_t size);
+    // 检查边的范围和子节点编号，保证遍历时下标不越界；另外检查博弈语义：各字段取值合法，每个节点只有一个父节点，
+    // 行动和发牌节点有子节点而弃牌和摊牌节点没有，发的牌不在公共牌或路径上且不重复，街数与发牌一致。
+    // 比 verify() 的校验和便宜，加载时总是执行
+    [[nodiscard]] bool checkStructure() const;
+
+    CardSet board;
+    TreeConfig config;
+    uint32_t nodeCount = 0;
+    uint32_t edgeCount = 0;
+    size_t arenaBytes = 0;
+
+    const unsigned char *arena = nullptr;
+    const uint8_t *types = nullptr;
+    const uint8_t *players = nullptr;
+    const uint8_t *streets = nullptr;
+    const float *committed = nullptr;
+    const uint32_t *firstEdge = nullptr;
+    const uint32_t *children = nullptr;
+    const uint8_t *actionTypes = nullptr;
+    const float *amounts = nullptr;
+    const CardIndex *cards = nullptr;
+
+    std::vector<uint64_t> storage;   // build() 得到的树的 arena，按 8 字节对齐
+    void *mapping = nullptr;         // open() 得到的树映射的整个文件
+    size_t mappingSize = 0;
+    std::vector<uint32_t> strategyOffsets;
+};
+
+#endif  // GAMETREE_H
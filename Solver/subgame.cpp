@@ -0,0 +1,186 @@
+#include "subgame.h"
+#include "../pokerHand/lookupevaluator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+    // 弃牌和摊牌节点手牌数达到两倍时才按手牌分块，每块的手牌数按缓存行对齐
+    constexpr int LEAF_GRAIN = 256;
+
+    // 把遍历方手牌 [begin, end) 分块并行执行 body(begin, end)
+    template<typename Body>
+    void splitHands(TaskScheduler &scheduler, int begin, int end, Body body) {
+        if (scheduler.getThreadCount() == 1 || end - begin < 2 * LEAF_GRAIN) {
+            body(begin, end);
+            return;
+        }
+        scheduler.parallelFor(end - begin, LEAF_GRAIN, [&](int first, int last) {
+            body(begin + first, begin + last);
+        });
+    }
+
+}
+
+std::unique_ptr<Subgame::Workspace> Subgame::WorkspacePool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!free.empty()) {
+            std::unique_ptr<Workspace> workspace = std::move(free.back());
+            free.pop_back();
+            workspace->top = 0;
+            return workspace;
+        }
+    }
+    return std::make_unique<Workspace>(size);
+}
+
+void Subgame::WorkspacePool::release(std::unique_ptr<Workspace> workspace) {
+    std::lock_guard<std::mutex> lock(mutex);
+    free.push_back(std::move(workspace));
+}
+
+Subgame::Subgame(const GameTree &tree, const Range &oop, const Range &ip) : tree(tree), boardOfCard() {
+    LookupEvaluator::initialize();
+    const CardSet board = tree.getBoard();
+    const Range *ranges[2] = {&oop, &ip};
+    for (int player = 0; player < 2; ++player) {
+        PlayerHands &list = hands[player];
+        for (int combo = 0; combo < COMBO_COUNT; ++combo) {
+            if (ranges[player]->getWeight(combo) > 0 && (COMBO_MASKS[combo] & board.getBits()) == 0) {
+                list.combos.push_back(combo);
+                list.masks.push_back(COMBO_MASKS[combo]);
+                list.weights.push_back(ranges[player]->getWeight(combo));
+                list.firstCards.push_back(static_cast<CardIndex>(__builtin_ctzll(COMBO_MASKS[combo])));
+                list.secondCards.push_back(static_cast<CardIndex>(63 - __builtin_clzll(COMBO_MASKS[combo])));
+            }
+        }
+        if (list.combos.empty()) {
+            throw std::invalid_argument("range is empty on this board");
+        }
+        list.stride = (static_cast<int>(list.combos.size()) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+    for (int player = 0; player < 2; ++player) {
+        const PlayerHands &other = hands[1 - player];
+        for (int combo: hands[player].combos) {
+            auto found = std::lower_bound(other.combos.begin(), other.combos.end(), combo);
+            hands[player].sameHand.push_back(found != other.combos.end() && *found == combo
+                                             ? static_cast<int>(found - other.combos.begin()) : -1);
+        }
+    }
+
+    // 河牌开始只有一副公共牌；转牌开始每张可能的河牌对应一副
+    std::vector<uint64_t> boards;
+    if (board.size() == 5) {
+        boards.push_back(board.getBits());
+    } else {
+        for (Card card: CardSet::full() - board) {
+            boardOfCard[card.getIndex()] = static_cast<int>(boards.size());
+            boards.push_back(board.getBits() | CardSet(card).getBits());
+        }
+    }
+    for (int player = 0; player < 2; ++player) {
+        const PlayerHands &list = hands[player];
+        strengths[player].resize(boards.size() * list.combos.size());
+        for (size_t b = 0; b < boards.size(); ++b) {
+            for (size_t h = 0; h < list.combos.size(); ++h) {
+                strengths[player][b * list.combos.size() + h] =
+                        (list.masks[h] & boards[b]) ? 0 : LookupEvaluator::evaluate(list.masks[h] | boards[b]);
+            }
+        }
+    }
+    for (size_t b = 0; b < boards.size(); ++b) {
+        for (int traverser = 0; traverser < 2; ++traverser) {
+            const PlayerHands &self = hands[traverser];
+            const PlayerHands &other = hands[1 - traverser];
+            showdowns.emplace_back(strengths[traverser].data() + b * self.combos.size(), self.masks.data(),
+                                   static_cast<int>(self.combos.size()),
+                                   strengths[1 - traverser].data() + b * other.combos.size(), other.masks.data(),
+                                   static_cast<int>(other.combos.size()));
+        }
+    }
+
+    for (size_t h = 0; h < hands[0].combos.size(); ++h) {
+        for (size_t v = 0; v < hands[1].combos.size(); ++v) {
+            if ((hands[0].masks[h] & hands[1].masks[v]) == 0) {
+                matchupWeight += static_cast<double>(hands[0].weights[h]) * hands[1].weights[v];
+            }
+        }
+    }
+
+    int maxActions = 0;
+    for (int node = 0; node < tree.getNodeCount(); ++node) {
+        maxActions = std::max(maxActions, tree.getChildCount(node));
+        hasChance = hasChance || tree.getType(node) == NodeType::CHANCE;
+    }
+    // 每层最多为子节点价值、策略和到达概率各分配一份
+    const size_t workspaceSize = static_cast<size_t>(treeDepth(tree.getRoot()) + 1) * (2 * maxActions + 4) *
+                                 std::max(hands[0].stride, hands[1].stride);
+    workspaces = std::make_unique<WorkspacePool>(workspaceSize);
+}
+
+TaskScheduler &Subgame::useScheduler(int threads) const {
+    const int count = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    if (!scheduler || scheduler->getThreadCount() != std::max(1, count)) {
+        scheduler = std::make_unique<TaskScheduler>(count);
+    }
+    return *scheduler;
+}
+
+int Subgame::rootGrain(int count) const {
+    // 有发牌节点时并行主要来自河牌，根节点不再切分，免得每块都重复计算对手策略
+    const int threads = scheduler->getThreadCount();
+    if (hasChance || threads == 1) {
+        return std::max(1, count);
+    }
+    const int chunk = (count + threads - 1) / threads;
+    return std::max(ALIGNMENT, (chunk + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+}
+
+int Subgame::treeDepth(int node) const {
+    int depth = 0;
+    for (int i = 0; i < tree.getChildCount(node); ++i) {
+        depth = std::max(depth, treeDepth(tree.getChild(node, i)));
+    }
+    return depth + 1;
+}
+
+// 弃牌：用按牌累加的对手到达概率做阻断修正，O(手牌数)
+void Subgame::foldValues(int node, int traverser, int begin, int end, const float *reachOpp, float *values) const {
+    const int folder = tree.getPlayer(node);
+    const float halfPot = tree.getConfig().pot / 2;
+    const float payoff = folder == traverser ? -(halfPot + tree.getCommitted(node, traverser)) : halfPot + tree.getCommitted(node, folder);
+    const PlayerHands &self = hands[traverser];
+    const PlayerHands &other = hands[1 - traverser];
+
+    float total = 0;
+    float perCard[CARD_COUNT] = {};
+    for (size_t v = 0; v < other.combos.size(); ++v) {
+        total += reachOpp[v];
+        perCard[other.firstCards[v]] += reachOpp[v];
+        perCard[other.secondCards[v]] += reachOpp[v];
+    }
+    splitHands(*scheduler, begin, end, [&](int first, int last) {
+        for (int h = first; h < last; ++h) {
+            float blocked = perCard[self.firstCards[h]] + perCard[self.secondCards[h]];
+            if (self.sameHand[h] >= 0) {
+                blocked -= reachOpp[self.sameHand[h]];
+            }
+            values[h] = payoff * (total - blocked);
+        }
+    });
+}
+
+// 摊牌：按牌力排序后的前缀和计算，见 ShowdownKernel
+void Subgame::showdownValues(int node, int traverser, int begin, int end, const float *reachOpp, float *values,
+                             int board) const {
+    const float amount = tree.getConfig().pot / 2 + tree.getCommitted(node, 0);
+    splitHands(*scheduler, begin, end, [&](int first, int last) {
+        showdowns[board * 2 + traverser].compute(reachOpp, values, nullptr, first, last);
+        for (int h = first; h < last; ++h) {
+            values[h] *= amount;
+        }
+    });
+}
@@ -0,0 +1,163 @@
+#ifndef SUBGAME_H
+#define SUBGAME_H
+
+#include "gametree.h"
+#include "../Concurrency/scheduler.h"
+#include "../Equity/showdown.h"
+#include "../Range/range.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 单挑子博弈中与策略无关的部分：双方的手牌、每副公共牌上的牌力和摊牌计算，
+// 以及弃牌、摊牌、发牌节点按手牌向量化的价值计算。CFR 求解和最佳应对共用这些计算和并行方式：
+// 发牌节点的每张河牌是一个任务，手牌多的弃牌/摊牌节点按手牌分块，任务借用池中的临时数组。
+class Subgame {
+public:
+    static constexpr int ALIGNMENT = 16;  // 16 个 float 正好一个缓存行
+
+    struct PlayerHands {
+        std::vector<int> combos;
+        std::vector<uint64_t> masks;
+        std::vector<float> weights;
+        std::vector<CardIndex> firstCards;
+        std::vector<CardIndex> secondCards;
+        std::vector<int> sameHand;  // 对手手牌列表中组合相同的手牌下标，没有为 -1
+        int stride = 0;             // 按缓存行对齐后的手牌数
+    };
+
+    // 每个任务的临时数组，按递归深度像栈一样分配和释放
+    struct Workspace {
+        std::vector<float> arena;
+        size_t top = 0;
+
+        explicit Workspace(size_t size) : arena(size) {}
+
+        float *allocate(size_t count) {
+            float *pointer = arena.data() + top;
+            top += count;
+            return pointer;
+        }
+    };
+
+    // 并行任务借用的临时数组，用完归还，反复使用
+    class WorkspacePool {
+    public:
+        explicit WorkspacePool(size_t size) : size(size) {}
+
+        std::unique_ptr<Workspace> acquire();
+        void release(std::unique_ptr<Workspace> workspace);
+
+    private:
+        size_t size;
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Workspace>> free;
+    };
+
+    // tree 必须比 Subgame 活得久；范围在公共牌上为空时抛出 std::invalid_argument
+    Subgame(const GameTree &tree, const Range &oop, const Range &ip);
+
+    [[nodiscard]] const GameTree &getTree() const { return tree; }
+    [[nodiscard]] const PlayerHands &getHands(int player) const { return hands[player]; }
+    // 所有不冲突的手牌组合的权重之和，用来把价值换算为每局的平均值
+    [[nodiscard]] double getMatchupWeight() const { return matchupWeight; }
+    // 根节点的公共牌编号：河牌开始为 0，转牌开始还没有确定（-1）
+    [[nodiscard]] int getRootBoard() const { return tree.getBoard().size() == 5 ? 0 : -1; }
+
+    // 遍历方手牌 [begin, end) 在终局节点的价值写入 values
+    void foldValues(int node, int traverser, int begin, int end, const float *reachOpp, float *values) const;
+    void showdownValues(int node, int traverser, int begin, int end, const float *reachOpp, float *values,
+                        int board) const;
+    // 发牌节点：对每张河牌调用 visit(子节点, 公共牌编号, 遍历方到达概率, 对手到达概率, 子节点价值, 临时数组)，
+    // 再按河牌顺序加权求和；reachSelf 可以为空
+    template<typename Visit>
+    void chance(int node, int traverser, int begin, int end, const float *reachSelf, const float *reachOpp,
+                float *values, Workspace &workspace, Visit visit) const;
+
+    // 按线程数取调度器，线程数变化时重建
+    TaskScheduler &useScheduler(int threads) const;
+    // 根节点把遍历方手牌 [0, count) 切成的块大小，必须在 useScheduler() 之后调用
+    [[nodiscard]] int rootGrain(int count) const;
+    [[nodiscard]] WorkspacePool &getWorkspaces() const { return *workspaces; }
+
+private:
+    const GameTree &tree;
+    PlayerHands hands[2];
+    // 每副完整公共牌上每名玩家每手牌的牌力，与公共牌冲突的手牌为 0
+    std::vector<uint32_t> strengths[2];
+    // 每副完整公共牌上以每名玩家为遍历方的摊牌计算，按 board * 2 + traverser 排列
+    std::vector<ShowdownKernel> showdowns;
+    int boardOfCard[CARD_COUNT];
+    double matchupWeight = 0;
+    bool hasChance = false;
+
+    mutable std::unique_ptr<TaskScheduler> scheduler;
+    std::unique_ptr<WorkspacePool> workspaces;
+
+    int treeDepth(int node) const;
+};
+
+// 多线程时每张河牌是一个任务，各自借一份临时数组；子节点价值先分别保存，再按河牌顺序相加
+template<typename Visit>
+void Subgame::chance(int node, int traverser, int begin, int end, const float *reachSelf, const float *reachOpp,
+                     float *values, Workspace &workspace, Visit visit) const {
+    const PlayerHands &self = hands[traverser];
+    const PlayerHands &other = hands[1 - traverser];
+    const int cards = tree.getChildCount(node);
+    const bool parallel = scheduler->getThreadCount() > 1;
+    const size_t mark = workspace.top;
+    float *childValues = workspace.allocate(static_cast<size_t>(parallel ? cards : 1) * self.stride);
+    // 任意一对不冲突的手牌，河牌都有 52 - 4 - 4 张可能
+    const float scale = 1.0f / static_cast<float>(CARD_COUNT - tree.getStreet(node) - 4);
+
+    auto river = [&](int i, float *riverValues, Workspace &local) {
+        const uint64_t card = 1ull << tree.getCard(node, i);
+        const size_t localMark = local.top;
+        float *childReachSelf = local.allocate(self.stride);
+        float *childReachOpp = local.allocate(other.stride);
+        for (size_t v = 0; v < other.combos.size(); ++v) {
+            childReachOpp[v] = (other.masks[v] & card) ? 0.0f : reachOpp[v];
+        }
+        if (reachSelf != nullptr) {
+            for (int h = begin; h < end; ++h) {
+                childReachSelf[h] = (self.masks[h] & card) ? 0.0f : reachSelf[h];
+            }
+        }
+        visit(tree.getChild(node, i), boardOfCard[tree.getCard(node, i)], childReachSelf, childReachOpp, riverValues,
+              local);
+        local.top = localMark;
+    };
+    auto accumulate = [&](int i, const float *riverValues) {
+        const uint64_t card = 1ull << tree.getCard(node, i);
+        for (int h = begin; h < end; ++h) {
+            if ((self.masks[h] & card) == 0) {
+                values[h] += riverValues[h] * scale;
+            }
+        }
+    };
+
+    std::fill(values + begin, values + end, 0.0f);
+    if (!parallel) {
+        for (int i = 0; i < cards; ++i) {
+            river(i, childValues, workspace);
+            accumulate(i, childValues);
+        }
+    } else {
+        TaskScheduler::TaskGroup group(*scheduler);
+        for (int i = 0; i < cards; ++i) {
+            group.run([&, i]() {
+                std::unique_ptr<Workspace> local = workspaces->acquire();
+                river(i, childValues + static_cast<size_t>(i) * self.stride, *local);
+                workspaces->release(std::move(local));
+            });
+        }
+        group.wait();
+        for (int i = 0; i < cards; ++i) {
+            accumulate(i, childValues + static_cast<size_t>(i) * self.stride);
+        }
+    }
+    workspace.top = mark;
+}
+
+#endif  // SUBGAME_H
@@ -0,0 +1,30 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+
+// 极简的测试断言：失败时打印位置并计数，不中断后面的检查；main 最后返回 Check::result()
+// 大量失败时只打印前若干条，避免刷屏
+namespace Check {
+
+    inline int failures = 0;
+
+    inline void fail(const char *file, int line, const char *expression) {
+        if (++failures <= 20) {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        }
+    }
+
+    inline int result() {
+        if (failures > 0) {
+            std::fprintf(stderr, "%d checks failed\n", failures);
+            return 1;
+        }
+        return 0;
+    }
+
+}
+
+#define CHECK(condition) ((condition) ? static_cast<void>(0) : Check::fail(__FILE__, __LINE__, #condition))
+
+#endif  // CHECK_H
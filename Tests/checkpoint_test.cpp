@@ -0,0 +1,109 @@
+#include "check.h"
+#include "../Solver/cfrsolver.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+
+    constexpr int ITERATIONS = 24;
+
+    GameTree buildTree() {
+        return GameTree::build(*CardSet::fromString("Kh9d4c2s"), TreeConfig());
+    }
+
+    std::string readFile(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    SolverConfig solverConfig(int iterations) {
+        SolverConfig config;
+        config.iterations = iterations;
+        config.targetExploitability = 0;
+        config.checkInterval = ITERATIONS;
+        config.threads = 2;
+        return config;
+    }
+
+    // 先迭代一半保存检查点，再由检查点中的树和范围构造新的求解器继续到 ITERATIONS 次
+    void resume(const Range &oop, const Range &ip, const CheckpointOptions &options,
+                const std::string &half, const std::string &resumed) {
+        {
+            CfrSolver solver(buildTree(), oop, ip);
+            solver.solve(solverConfig(ITERATIONS / 2));
+            solver.saveCheckpoint(half, options);
+        }
+        std::optional<Checkpoint> checkpoint = Checkpoint::open(half);
+        CHECK(checkpoint.has_value());
+        if (!checkpoint) {
+            return;
+        }
+        CHECK(checkpoint->getIterations() == ITERATIONS / 2);
+        CfrSolver solver(checkpoint->readTree(), checkpoint->getRange(0), checkpoint->getRange(1));
+        solver.restore(*checkpoint);
+        checkpoint.reset();
+        solver.solve(solverConfig(ITERATIONS));
+        CHECK(solver.getIterations() == ITERATIONS);
+        solver.saveCheckpoint(resumed);
+    }
+
+    // 直接用 Writer 写出手牌和策略累加值长度可以随意指定的检查点，CRC 都正确，只有内容不合法
+    bool writeAndOpen(const std::vector<int> &combos, long sumsDelta, const std::string &path) {
+        GameTree tree = buildTree();
+        const std::vector<int> hands[2] = {combos, {3, 40, 700}};
+        const std::vector<float> weights[2] = {std::vector<float>(combos.size(), 1.0f), std::vector<float>(3, 1.0f)};
+        const int counts[2] = {static_cast<int>(combos.size()), 3};
+        const size_t size = tree.assignStrategyOffsets(counts, 16) + sumsDelta;
+        Checkpoint::Writer writer(path, CheckpointOptions());
+        writer.writeTree(tree);
+        writer.writeHands(hands, weights);
+        writer.beginSection(CheckpointSection::STRATEGY_SUMS, size);
+        const std::vector<float> sums(size, 1.0f);
+        writer.append(sums.data(), sums.size());
+        writer.finish(1, 16);
+        return Checkpoint::open(path).has_value();
+    }
+
+}
+
+// 中断后从 FLOAT32 检查点恢复，继续迭代得到的检查点与不中断求解的逐字节相同
+// 中间检查点分别用压缩（逐块解码）和不压缩（映射后直接读取）两种方式保存；另外检查内容不合法的文件被拒绝
+int main() {
+    const Range oop = *Range::fromString("AA, KK, 99, AK, KQ, 98s, 76s, A5s");
+    const Range ip = *Range::fromString("QQ-TT, AQ, KJs, QJs, T9s, 65s");
+
+    {
+        CfrSolver solver(buildTree(), oop, ip);
+        solver.solve(solverConfig(ITERATIONS));
+        solver.saveCheckpoint("checkpoint_test_full.ckpt");
+    }
+    const std::string full = readFile("checkpoint_test_full.ckpt");
+    CHECK(!full.empty());
+
+    CheckpointOptions compressed;
+    compressed.compression = 1;
+    resume(oop, ip, compressed, "checkpoint_test_half.ckpt", "checkpoint_test_resumed.ckpt");
+    CHECK(readFile("checkpoint_test_resumed.ckpt") == full);
+
+    CheckpointOptions raw;
+    raw.compression = 0;
+    resume(oop, ip, raw, "checkpoint_test_half.ckpt", "checkpoint_test_resumed.ckpt");
+    CHECK(readFile("checkpoint_test_resumed.ckpt") == full);
+
+    // 组合编号越界、未排序或重复，策略累加值比树的布局短或长时拒绝打开
+    CHECK(writeAndOpen({5, 6, 1000}, 0, "checkpoint_test_corrupt.ckpt"));
+    CHECK(!writeAndOpen({5, 6, COMBO_COUNT}, 0, "checkpoint_test_corrupt.ckpt"));
+    CHECK(!writeAndOpen({-1, 6, 1000}, 0, "checkpoint_test_corrupt.ckpt"));
+    CHECK(!writeAndOpen({6, 5, 1000}, 0, "checkpoint_test_corrupt.ckpt"));
+    CHECK(!writeAndOpen({5, 5, 1000}, 0, "checkpoint_test_corrupt.ckpt"));
+    CHECK(!writeAndOpen({5, 6, 1000}, -1, "checkpoint_test_corrupt.ckpt"));
+    CHECK(!writeAndOpen({5, 6, 1000}, 1, "checkpoint_test_corrupt.ckpt"));
+
+    std::remove("checkpoint_test_corrupt.ckpt");
+    std::remove("checkpoint_test_full.ckpt");
+    std::remove("checkpoint_test_half.ckpt");
+    std::remove("checkpoint_test_resumed.ckpt");
+    return Check::result();
+}
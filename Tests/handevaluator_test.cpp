@@ -0,0 +1,60 @@
+#include "check.h"
+#include "reference.h"
+#include "../pokerHand/handevaluator.h"
+#include "../pokerHand/lookupevaluator.h"
+
+namespace {
+
+    // 从 deck 中随机取 N 张牌与参考实现比较；deck 只含少数点数或花色时专门覆盖多个三条、四条、同花顺等情况
+    template<int N>
+    void compareRandom(Xoshiro256 &rng, uint64_t deck, int hands) {
+        for (int i = 0; i < hands; ++i) {
+            const uint64_t cards = Reference::deal(rng, N, ~deck);
+            const uint32_t expected = Reference::evaluate(cards);
+            CHECK(HandEvaluator<N>::evaluate(cards) == expected);
+            CHECK(LookupEvaluator::evaluate(cards) == expected);
+        }
+    }
+
+    template<int N>
+    void compareDecks(Xoshiro256 &rng) {
+        const uint64_t fullDeck = (1ull << CARD_COUNT) - 1;
+        uint64_t fewRanks = 0;     // 5 个点数的全部花色
+        for (int suit = 0; suit < SUIT_COUNT; ++suit) {
+            fewRanks |= 0b1000000001111ull << (suit * RANK_COUNT);
+        }
+        const uint64_t twoSuits = (1ull << (2 * RANK_COUNT)) - 1;
+        compareRandom<N>(rng, fullDeck, 200000);
+        compareRandom<N>(rng, fewRanks, 200000);
+        compareRandom<N>(rng, twoSuits, 200000);
+    }
+
+}
+
+// HandEvaluator<N> 与朴素参考实现比较：全部五张牌，以及从不同牌堆随机抽取的 6、7 张牌
+int main() {
+    LookupEvaluator::initialize();
+
+    for (int a = 0; a < CARD_COUNT; ++a) {
+        for (int b = a + 1; b < CARD_COUNT; ++b) {
+            for (int c = b + 1; c < CARD_COUNT; ++c) {
+                for (int d = c + 1; d < CARD_COUNT; ++d) {
+                    for (int e = d + 1; e < CARD_COUNT; ++e) {
+                        const HandEvaluator<5>::Cards cards = {
+                                Card(static_cast<CardIndex>(a)), Card(static_cast<CardIndex>(b)),
+                                Card(static_cast<CardIndex>(c)), Card(static_cast<CardIndex>(d)),
+                                Card(static_cast<CardIndex>(e))};
+                        const uint32_t expected = Reference::evaluateFive(HandEvaluator<5>::mask(cards));
+                        CHECK(HandEvaluator<5>::evaluate(cards) == expected);
+                        CHECK(HandEvaluator<5>::handType(cards) == static_cast<HandType>(expected >> 20));
+                    }
+                }
+            }
+        }
+    }
+
+    Xoshiro256 rng(23);
+    compareDecks<6>(rng);
+    compareDecks<7>(rng);
+    return Check::result();
+}
@@ -0,0 +1,53 @@
+#include "check.h"
+#include "reference.h"
+#include "../pokerHand/handstate.h"
+
+// HandState 与朴素参考实现逐手比较：全部五张牌，以及按手牌、翻牌、转牌、河牌逐张加牌得到的 6、7 张牌
+int main() {
+    LookupEvaluator::initialize();
+
+    for (int a = 0; a < CARD_COUNT; ++a) {
+        for (int b = a + 1; b < CARD_COUNT; ++b) {
+            for (int c = b + 1; c < CARD_COUNT; ++c) {
+                for (int d = c + 1; d < CARD_COUNT; ++d) {
+                    for (int e = d + 1; e < CARD_COUNT; ++e) {
+                        const uint64_t cards = 1ull << a | 1ull << b | 1ull << c | 1ull << d | 1ull << e;
+                        const HandState state{CardSet(cards)};
+                        const uint32_t expected = Reference::evaluateFive(cards);
+                        CHECK(state.evaluate() == expected);
+                        CHECK(LookupEvaluator::classStrength(state.evaluateClass()) == expected);
+                    }
+                }
+            }
+        }
+    }
+
+    // 同一前缀上分支：翻牌状态复制后分别加每一张转牌，转牌状态再加若干张河牌
+    Xoshiro256 rng(16);
+    for (int deal = 0; deal < 2000; ++deal) {
+        const uint64_t hole = Reference::deal(rng, 2);
+        const uint64_t flop = Reference::deal(rng, 3, hole);
+        const HandState flopState = HandState(CardSet(hole)).add(CardSet(flop));
+        CHECK(flopState.size() == 5);
+        CHECK(flopState.evaluate() == Reference::evaluate(hole | flop));
+        for (int turn = 0; turn < CARD_COUNT; ++turn) {
+            const uint64_t turnCard = 1ull << turn;
+            if ((hole | flop) & turnCard) {
+                continue;
+            }
+            const HandState turnState = flopState.add(Card(static_cast<CardIndex>(turn)));
+            const uint64_t six = hole | flop | turnCard;
+            CHECK(turnState.getCards().getBits() == six);
+            CHECK(turnState.evaluate() == Reference::evaluate(six));
+            for (int sample = 0; sample < 4; ++sample) {
+                const uint64_t river = Reference::deal(rng, 1, six);
+                const HandState riverState = turnState.add(CardSet(river));
+                const uint32_t expected = Reference::evaluate(six | river);
+                CHECK(riverState.evaluate() == expected);
+                CHECK(LookupEvaluator::classStrength(riverState.evaluateClass()) == expected);
+                CHECK(riverState.handType() == static_cast<HandType>(expected >> 20));
+            }
+        }
+    }
+    return Check::result();
+}
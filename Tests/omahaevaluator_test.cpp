@@ -0,0 +1,73 @@
+#include "check.h"
+#include "reference.h"
+#include "../pokerHand/lookupevaluator.h"
+#include "../pokerHand/omahaevaluator.h"
+#include "../pokerHand/pokerhand.h"
+#include <stdexcept>
+
+namespace {
+
+    template<typename Function>
+    bool throwsInvalidArgument(Function function) {
+        try {
+            function();
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    }
+
+    // 3~5 张公共牌、2~6 张手牌，与“两张手牌加三张公共牌”的穷举比较
+    void compareRandom(Xoshiro256 &rng, uint64_t deck, int boards) {
+        for (int i = 0; i < boards; ++i) {
+            const int boardCards = 3 + static_cast<int>(rng.bounded(3));
+            const uint64_t board = Reference::deal(rng, boardCards, ~deck);
+            const OmahaEvaluator evaluator{CardSet(board)};
+            for (int j = 0; j < 8; ++j) {
+                const int holeCards = OmahaEvaluator::MIN_HOLE +
+                                      static_cast<int>(rng.bounded(OmahaEvaluator::MAX_HOLE - OmahaEvaluator::MIN_HOLE + 1));
+                const uint64_t hole = Reference::deal(rng, holeCards, ~deck | board);
+                const uint32_t expected = Reference::evaluateOmaha(hole, board);
+                CHECK(evaluator.evaluate(CardSet(hole)) == expected);
+                CHECK(LookupEvaluator::classStrength(evaluator.evaluateClass(CardSet(hole))) == expected);
+                CHECK(evaluator.handType(CardSet(hole)) == static_cast<HandType>(expected >> 20));
+
+                const CardSet best = evaluator.bestHand(CardSet(hole));
+                CHECK(best.size() == 5);
+                CHECK((best & CardSet(hole)).size() == 2);
+                CHECK((best & CardSet(board)).size() == 3);
+                CHECK(Reference::evaluateFive(best.getBits()) == expected);
+            }
+        }
+    }
+
+}
+
+// OmahaEvaluator 与朴素穷举比较，另外检查非法输入的异常
+int main() {
+    LookupEvaluator::initialize();
+
+    Xoshiro256 rng(24);
+    const uint64_t fullDeck = (1ull << CARD_COUNT) - 1;
+    const uint64_t twoSuits = (1ull << (2 * RANK_COUNT)) - 1;  // 公共牌经常有三张同花
+    compareRandom(rng, fullDeck, 40000);
+    compareRandom(rng, twoSuits, 40000);
+
+    const CardSet board = *CardSet::fromString("AsKsQs2d3c");
+    const OmahaEvaluator evaluator(board);
+    CHECK(throwsInvalidArgument([] { OmahaEvaluator(*CardSet::fromString("AsKs")); }));
+    CHECK(throwsInvalidArgument([] { OmahaEvaluator(*CardSet::fromString("AsKsQsJsTs9s")); }));
+    CHECK(throwsInvalidArgument([&] { (void) evaluator.evaluate(*CardSet::fromString("Ah")); }));
+    CHECK(throwsInvalidArgument([&] { (void) evaluator.evaluate(*CardSet::fromString("AhKhQhJhTh9h8h")); }));
+    CHECK(throwsInvalidArgument([&] { (void) evaluator.evaluate(*CardSet::fromString("AsJsTs9s")); }));
+    // 只有一张手牌同花时不能成同花
+    CHECK(evaluator.handType(*CardSet::fromString("JsTh9h8h")) == HandType::STRAIGHT);
+    CHECK(evaluator.handType(*CardSet::fromString("JsTs9h8h")) == HandType::STRAIGHT_FLUSH);
+
+    CHECK(PokerHand::compareOmahaHands(*CardSet::fromString("JsTs9h8h"), *CardSet::fromString("JdTh9c8c"), board) == 1);
+    CHECK(PokerHand::compareOmahaHands(*CardSet::fromString("JcTh9h8h"), *CardSet::fromString("JdTd9c8c"), board) == 0);
+    CHECK(throwsInvalidArgument([&] {
+        (void) PokerHand::compareOmahaHands(*CardSet::fromString("JsTs9h8h"), *CardSet::fromString("JdTs9c8c"), board);
+    }));
+    return Check::result();
+}
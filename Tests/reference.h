@@ -0,0 +1,109 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include "../Card/card.h"
+#include "../Random/rng.h"
+#include "../pokerHand/handtype.h"
+#include <cstdint>
+
+// 测试用的朴素参考实现：逐个枚举五张牌的子集，按最直接的规则判断牌型，不用查找表也不用位运算技巧
+// 编码与 Evaluator 相同：牌型 << 20，之后按 (张数, 点数) 从大到小排列的点数各占 4 位，不足 5 个时低位补 0；
+// 顺子和同花顺只记最大的点数（A-2-3-4-5 记为 5）
+namespace Reference {
+
+    inline uint32_t evaluateFive(uint64_t cards) {
+        int rankCounts[RANK_COUNT] = {};
+        int suitCounts[SUIT_COUNT] = {};
+        for (int index = 0; index < CARD_COUNT; ++index) {
+            if (cards >> index & 1) {
+                ++rankCounts[index % RANK_COUNT];
+                ++suitCounts[index / RANK_COUNT];
+            }
+        }
+        bool flush = false;
+        for (int count: suitCounts) {
+            flush = flush || count == 5;
+        }
+        int groups[5] = {};
+        int groupCount = 0;
+        for (int count = 4; count >= 1; --count) {
+            for (int rank = RANK_COUNT - 1; rank >= 0; --rank) {
+                if (rankCounts[rank] == count) {
+                    groups[groupCount++] = rank;
+                }
+            }
+        }
+
+        int straightHigh = -1;
+        if (groupCount == 5 && groups[0] - groups[4] == 4) {
+            straightHigh = groups[0];
+        } else if (groupCount == 5 && groups[0] == 12 && groups[1] == 3) {
+            straightHigh = 3;
+        }
+        if (straightHigh >= 0) {
+            const HandType type = flush ? HandType::STRAIGHT_FLUSH : HandType::STRAIGHT;
+            return static_cast<uint32_t>(type) << 20 | static_cast<uint32_t>(straightHigh) << 16;
+        }
+
+        HandType type = HandType::HIGH_CARD;
+        if (flush) {
+            type = HandType::FLUSH;
+        } else if (rankCounts[groups[0]] == 4) {
+            type = HandType::FOUR_OF_A_KIND;
+        } else if (rankCounts[groups[0]] == 3) {
+            type = groupCount == 2 ? HandType::FULL_HOUSE : HandType::THREE_OF_A_KIND;
+        } else if (rankCounts[groups[0]] == 2) {
+            type = groupCount == 3 ? HandType::TWO_PAIR : HandType::PAIR;
+        }
+        uint32_t packed = 0;
+        for (int i = 0; i < groupCount; ++i) {
+            packed = packed << 4 | static_cast<uint32_t>(groups[i]);
+        }
+        return static_cast<uint32_t>(type) << 20 | packed << (4 * (5 - groupCount));
+    }
+
+    // 5~7 张牌：所有五张子集中的最大值
+    inline uint32_t evaluate(uint64_t cards) {
+        uint32_t best = 0;
+        for (uint64_t subset = cards; subset != 0; subset = (subset - 1) & cards) {
+            if (__builtin_popcountll(subset) == 5) {
+                const uint32_t strength = evaluateFive(subset);
+                best = strength > best ? strength : best;
+            }
+        }
+        return best;
+    }
+
+    // 奥马哈：正好两张手牌加三张公共牌
+    inline uint32_t evaluateOmaha(uint64_t hole, uint64_t board) {
+        uint32_t best = 0;
+        for (uint64_t pair = hole; pair != 0; pair = (pair - 1) & hole) {
+            if (__builtin_popcountll(pair) != 2) {
+                continue;
+            }
+            for (uint64_t triple = board; triple != 0; triple = (triple - 1) & board) {
+                if (__builtin_popcountll(triple) == 3) {
+                    const uint32_t strength = evaluateFive(pair | triple);
+                    best = strength > best ? strength : best;
+                }
+            }
+        }
+        return best;
+    }
+
+    // 随机发 count 张不在 dead 中的牌
+    inline uint64_t deal(Xoshiro256 &rng, int count, uint64_t dead = 0) {
+        uint64_t cards = 0;
+        while (count > 0) {
+            const uint64_t card = 1ull << rng.bounded(CARD_COUNT);
+            if (((cards | dead) & card) == 0) {
+                cards |= card;
+                --count;
+            }
+        }
+        return cards;
+    }
+
+}
+
+#endif  // REFERENCE_H
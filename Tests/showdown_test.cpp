@@ -0,0 +1,109 @@
+#include "check.h"
+#include "reference.h"
+#include "../Equity/showdown.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+    struct Side {
+        std::vector<uint32_t> strengths;  // 与公共牌冲突时为 0
+        std::vector<uint64_t> masks;
+    };
+
+    // 随机取 count 个不同的组合；与公共牌冲突的组合保留下来，牌力记为 0
+    Side randomSide(Xoshiro256 &rng, int count, uint64_t board) {
+        std::vector<int> combos(COMBO_COUNT);
+        std::iota(combos.begin(), combos.end(), 0);
+        std::shuffle(combos.begin(), combos.end(), rng);
+        Side side;
+        for (int i = 0; i < count; ++i) {
+            const uint64_t mask = COMBO_MASKS[combos[i]];
+            side.masks.push_back(mask);
+            side.strengths.push_back((mask & board) != 0 ? 0 : Reference::evaluate(mask | board));
+        }
+        return side;
+    }
+
+    // 逐对比较：values[h] = 赢的到达概率 - 输的到达概率，reachable[h] = 不冲突的到达概率
+    void bruteForce(const Side &hero, const Side &villain, const std::vector<float> &reach, std::vector<float> &values,
+                    std::vector<float> &reachable) {
+        for (size_t h = 0; h < hero.masks.size(); ++h) {
+            double value = 0;
+            double total = 0;
+            for (size_t v = 0; hero.strengths[h] != 0 && v < villain.masks.size(); ++v) {
+                if (villain.strengths[v] == 0 || (hero.masks[h] & villain.masks[v]) != 0) {
+                    continue;
+                }
+                total += reach[v];
+                value += hero.strengths[h] > villain.strengths[v] ? reach[v] :
+                         hero.strengths[h] < villain.strengths[v] ? -reach[v] : 0;
+            }
+            values[h] = static_cast<float>(value);
+            reachable[h] = static_cast<float>(total);
+        }
+    }
+
+    void compare(Xoshiro256 &rng, int heroCount, int villainCount) {
+        // 随机取的组合两边都有与公共牌冲突的，对手手牌也经常与英雄手牌共用一张牌
+        const uint64_t board = Reference::deal(rng, 5);
+        const Side hero = randomSide(rng, heroCount, board);
+        const Side villain = randomSide(rng, villainCount, board);
+        std::vector<float> reach(villainCount);
+        for (float &r: reach) {
+            r = rng.bounded(4) == 0 ? 0.0f : static_cast<float>(rng.bounded(1000)) / 1000.0f;
+        }
+        const ShowdownKernel kernel(hero.strengths.data(), hero.masks.data(), heroCount, villain.strengths.data(),
+                                    villain.masks.data(), villainCount);
+
+        std::vector<float> expectedValues(heroCount);
+        std::vector<float> expectedReachable(heroCount);
+        bruteForce(hero, villain, reach, expectedValues, expectedReachable);
+        const float tolerance = 1e-4f * std::max(1.0f, std::accumulate(reach.begin(), reach.end(), 0.0f));
+
+        // 整段以及起止不对齐的一段；段外的值不能被改写
+        const int begin = heroCount > 3 ? static_cast<int>(rng.bounded(static_cast<uint32_t>(heroCount / 3))) : 0;
+        const int end = heroCount - (heroCount > 3 ? static_cast<int>(rng.bounded(static_cast<uint32_t>(heroCount / 3))) : 0);
+        for (const auto &[first, last]: {std::pair<int, int>(0, heroCount), std::pair<int, int>(begin, end)}) {
+            std::vector<float> values(heroCount, -1234.0f);
+            std::vector<float> reachable(heroCount, -1234.0f);
+            kernel.compute(reach.data(), values.data(), reachable.data(), first, last);
+            for (int h = 0; h < heroCount; ++h) {
+                if (h < first || h >= last) {
+                    CHECK(values[h] == -1234.0f && reachable[h] == -1234.0f);
+                } else {
+                    CHECK(std::fabs(values[h] - expectedValues[h]) <= tolerance);
+                    CHECK(std::fabs(reachable[h] - expectedReachable[h]) <= tolerance);
+                }
+            }
+            // 不需要 reachable 时传 nullptr
+            std::vector<float> valuesOnly(heroCount, -1234.0f);
+            kernel.compute(reach.data(), valuesOnly.data(), nullptr, first, last);
+            for (int h = first; h < last; ++h) {
+                CHECK(valuesOnly[h] == values[h]);
+            }
+        }
+    }
+
+}
+
+// ShowdownKernel 与逐对比较的结果一致；同一份源文件再以 AY_GTO_NO_SIMD 编译一次（showdown_scalar_test），
+// 两个可执行文件分别覆盖 AVX2 和标量实现。手牌数特意包含不是 8 的倍数的情况，覆盖向量化的尾部
+int main() {
+#ifdef AY_GTO_NO_SIMD
+    CHECK(!ShowdownKernel::usesAvx2());
+#endif
+    Xoshiro256 rng(8);
+    const int counts[] = {1, 2, 7, 8, 9, 15, 17, 63, 100, 331, 800, COMBO_COUNT};
+    for (int heroCount: counts) {
+        for (int villainCount: counts) {
+            compare(rng, heroCount, villainCount);
+        }
+    }
+    for (int i = 0; i < 40; ++i) {
+        compare(rng, 1 + static_cast<int>(rng.bounded(COMBO_COUNT)), 1 + static_cast<int>(rng.bounded(COMBO_COUNT)));
+    }
+    return Check::result();
+}
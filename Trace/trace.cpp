@@ -0,0 +1,108 @@
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    std::mutex &outputMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    // 每个线程一份计数；只有所属线程写入，用 relaxed 原子变量让 snapshot() 可以同时读取
+    struct ThreadCounters {
+        std::atomic<uint64_t> slots[Counters::SLOT_COUNT] = {};
+    };
+
+    // 已退出线程的计数合并到 retired，线程本身的条目随之删除，注册表只包含还在运行的线程
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadCounters *> threads;
+        uint64_t retired[Counters::SLOT_COUNT] = {};
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // 线程退出时析构：把计数加到 retired 中并从注册表删除
+    struct CounterOwner {
+        ThreadCounters counters;
+
+        CounterOwner() {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.threads.push_back(&counters);
+        }
+
+        ~CounterOwner() {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (int slot = 0; slot < Counters::SLOT_COUNT; ++slot) {
+                r.retired[slot] += counters.slots[slot].load(std::memory_order_relaxed);
+            }
+            r.threads.erase(std::find(r.threads.begin(), r.threads.end(), &counters));
+        }
+    };
+
+    ThreadCounters &localCounters() {
+        // 先构造注册表，保证它比所有线程的 CounterOwner 都晚析构
+        registry();
+        thread_local CounterOwner owner;
+        return owner.counters;
+    }
+
+}
+
+void Trace::write(TraceLevel level, const std::string &line) {
+    std::lock_guard<std::mutex> lock(outputMutex());
+    std::clog << (level == TraceLevel::DEBUG ? "[debug] " : "[info] ") << line << '\n';
+}
+
+void Counters::add(int slot, uint64_t amount) {
+    std::atomic<uint64_t> &value = localCounters().slots[slot];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+EvaluationCounters Counters::snapshot() {
+    uint64_t totals[SLOT_COUNT] = {};
+    Registry &r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+            totals[slot] = r.retired[slot];
+        }
+        for (const ThreadCounters *thread: r.threads) {
+            for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+                totals[slot] += thread->slots[slot].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    EvaluationCounters counters;
+    counters.evaluations = totals[EVALUATIONS];
+    for (int type = 0; type < 9; ++type) {
+        counters.categoryHits[type] = totals[CATEGORY_HITS + type];
+    }
+    counters.bestHandCalls = totals[BEST_HAND_CALLS];
+    counters.bestHandNanoseconds = totals[BEST_HAND_NANOSECONDS];
+    counters.compareCalls = totals[COMPARE_CALLS];
+    counters.compareNanoseconds = totals[COMPARE_NANOSECONDS];
+    return counters;
+}
+
+void Counters::reset() {
+    // 其他线程可能同时在写，reset() 应在没有求值进行时调用
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::fill(std::begin(r.retired), std::end(r.retired), 0);
+    for (ThreadCounters *thread: r.threads) {
+        for (std::atomic<uint64_t> &slot: thread->slots) {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "../pokerHand/handtype.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// 编译期的跟踪级别：0 关闭，1 INFO，2 DEBUG
+// 没有指定时 Release（定义了 NDEBUG）关闭，其他构建打开到 DEBUG；也可以用 CMake 的 AY_GTO_TRACE_LEVEL 指定
+#ifndef AY_GTO_TRACE_LEVEL
+#ifdef NDEBUG
+#define AY_GTO_TRACE_LEVEL 0
+#else
+#define AY_GTO_TRACE_LEVEL 2
+#endif
+#endif
+
+// 求值计数器，默认关闭；用 CMake 的 AY_GTO_COUNTERS 打开
+#ifndef AY_GTO_COUNTERS
+#define AY_GTO_COUNTERS 0
+#endif
+
+enum class TraceLevel {
+    OFF,
+    INFO,
+    DEBUG
+};
+
+class Trace {
+public:
+    static constexpr int LEVEL = AY_GTO_TRACE_LEVEL;
+
+    static constexpr bool enabled(TraceLevel level) {
+        return level != TraceLevel::OFF && static_cast<int>(level) <= LEVEL;
+    }
+
+    // 整行写到 std::clog，多线程同时输出时不会交错
+    static void write(TraceLevel level, const std::string &line);
+};
+
+// 编译期未开启该级别时整条语句被丢弃，message 中的表达式不会求值
+#define AY_TRACE(level, message)                            \
+    do {                                                    \
+        if constexpr (Trace::enabled(level)) {              \
+            std::ostringstream traceStream;                 \
+            traceStream << message;                         \
+            Trace::write(level, traceStream.str());         \
+        }                                                   \
+    } while (false)
+
+// 计数器快照，各线程的计数已经合并
+struct EvaluationCounters {
+    uint64_t evaluations = 0;                    // LookupEvaluator 的求值次数
+    std::array<uint64_t, 9> categoryHits{};      // 按 HandType 统计的求值结果
+    uint64_t bestHandCalls = 0;                  // PokerHand::getBestHand
+    uint64_t bestHandNanoseconds = 0;
+    uint64_t compareCalls = 0;                   // PokerHand::compareHands
+    uint64_t compareNanoseconds = 0;
+
+    [[nodiscard]] uint64_t hits(HandType type) const { return categoryHits[static_cast<int>(type)]; }
+};
+
+// 每个线程写自己的计数，没有竞争；snapshot() 合并所有线程（包括已经退出的线程）
+// 编译期关闭时所有记录函数都是空的
+class Counters {
+public:
+    static constexpr bool ENABLED = AY_GTO_COUNTERS != 0;
+
+    enum Slot {
+        EVALUATIONS,
+        CATEGORY_HITS,
+        BEST_HAND_CALLS = CATEGORY_HITS + 9,
+        BEST_HAND_NANOSECONDS,
+        COMPARE_CALLS,
+        COMPARE_NANOSECONDS,
+        SLOT_COUNT
+    };
+
+    static void recordEvaluation(uint32_t strength) {
+        if constexpr (ENABLED) {
+            add(EVALUATIONS, 1);
+            add(CATEGORY_HITS + static_cast<int>(strength >> 20), 1);
+        }
+    }
+
+    // 在作用域结束时记录一次调用及其耗时
+    class ScopedCall {
+    public:
+        ScopedCall(Slot calls, Slot nanoseconds) : calls(calls), nanoseconds(nanoseconds) {
+            if constexpr (ENABLED) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedCall() {
+            if constexpr (ENABLED) {
+                add(calls, 1);
+                add(nanoseconds, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count()));
+            }
+        }
+
+        ScopedCall(const ScopedCall &) = delete;
+        ScopedCall &operator=(const ScopedCall &) = delete;
+
+    private:
+        Slot calls;
+        Slot nanoseconds;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    [[nodiscard]] static EvaluationCounters snapshot();
+    static void reset();
+
+private:
+    static void add(int slot, uint64_t amount);
+};
+
+#endif  // TRACE_H
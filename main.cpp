@@ -1,75 +1,910 @@
+#include <charconv>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include "Abstraction/abstraction.h"
 #include "Card/card.h"
-#include "Deck/deck.h"
-#include "pokerHand/pokerhand.h"
+#include "pokerHand/lookupevaluator.h"
+#include "Equity/equity.h"
+#include "Equity/rangeequity.h"
+#include "History/handhistory.h"
+#include "Preflop/prefloptable.h"
+#include "Range/range.h"
+#include "Report/boardreport.h"
+#include "Server/queryserver.h"
+#include "Simulation/simulator.h"
+#include "Solver/cfrsolver.h"
+#include "Trace/trace.h"
 
-int main() {
-    Deck deck;
-    deck.shuffle();
-    std::cout << "Dealing cards..." << std::endl;
+// 把整个字符串解析为数字；不是数字、有多余字符或越界时返回空，不抛异常
+template<typename T>
+static std::optional<T> parseNumber(std::string_view text) {
+    T value{};
+    const char *end = text.data() + text.size();
+    auto [stop, error] = std::from_chars(text.data(), end, value);
+    if (error != std::errc() || stop != end) {
+        return std::nullopt;
+    }
+    return value;
+}
 
-    std::vector<Card> player1;
-    std::vector<Card> player2;
-    std::vector<Card> commonCard;
+// 解析选项 option 的值到 value，失败时打印错误并返回 false
+template<typename T>
+static bool readNumber(std::string_view option, std::string_view text, T &value) {
+    std::optional<T> parsed = parseNumber<T>(text);
+    if (!parsed) {
+        std::cerr << "invalid value for " << option << ": " << text << std::endl;
+        return false;
+    }
+    value = *parsed;
+    return true;
+}
 
-    // 发牌给玩家1
-    for (int i = 0; i < 2; i++) {
-        Card card1 = deck.dealCard();
-        player1.push_back(card1);
-        std::cout << "Dealt card 1: " << card1.getRankString() << " of " << card1.getSuitString() << std::endl;
+// 计算胜率：AY_GTO equity <英雄手牌> <对手手牌|random>... [--board 公共牌] [--threads N] [--trials N] [--stderr X] [--exact]
+static int runEquity(int argc, char *argv[]) {
+    const char *usage = "usage: AY_GTO equity <hero> <opponent|random>... [--board cards] [--threads n] [--trials n] [--stderr x] [--exact]";
+    if (argc < 1) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+    std::optional<CardSet> hero = CardSet::fromString(argv[0]);
+    CardSet board;
+    std::vector<std::string> opponentArgs;
+    EquityConfig config;
+    config.targetStandardError = 0.0005;
+    bool exact = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--board" && i + 1 < argc) {
+            std::optional<CardSet> parsed = CardSet::fromString(argv[++i]);
+            if (!parsed) {
+                std::cerr << "invalid board: " << argv[i] << std::endl;
+                return 1;
+            }
+            board = *parsed;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!readNumber(arg, argv[++i], config.threads)) {
+                return 1;
+            }
+        } else if (arg == "--trials" && i + 1 < argc) {
+            if (!readNumber(arg, argv[++i], config.maxTrials)) {
+                return 1;
+            }
+        } else if (arg == "--stderr" && i + 1 < argc) {
+            if (!readNumber(arg, argv[++i], config.targetStandardError)) {
+                return 1;
+            }
+        } else if (arg == "--exact") {
+            exact = true;
+        } else {
+            opponentArgs.push_back(arg);
+        }
+    }
+    if (!hero) {
+        std::cerr << "invalid hero hand: " << argv[0] << std::endl;
+        return 1;
     }
 
-    // 发牌给玩家2
-    for (int i = 0; i < 2; i++) {
-        Card card2 = deck.dealCard();
-        player2.push_back(card2);
-        std::cout << "Dealt card 2: " << card2.getRankString() << " of " << card2.getSuitString() << std::endl;
+    try {
+        EquityCalculator calculator(*hero, board);
+        for (const std::string &arg: opponentArgs) {
+            if (arg == "random") {
+                calculator.addRandomOpponents(1);
+            } else if (std::optional<CardSet> hand = CardSet::fromString(arg)) {
+                calculator.addOpponent(*hand);
+            } else {
+                std::cerr << "invalid opponent hand: " << arg << std::endl;
+                return 1;
+            }
+        }
+        if (calculator.getOpponentCount() == 0) {
+            calculator.addRandomOpponents(1);
+        }
+        EquityResult result = exact ? calculator.enumerate(config.threads) : calculator.monteCarlo(config);
+        std::cout << "trials: " << result.trials << std::endl;
+        std::cout << "win: " << result.win * 100 << "%" << std::endl;
+        std::cout << "tie: " << result.tie * 100 << "%" << std::endl;
+        std::cout << "lose: " << result.lose * 100 << "%" << std::endl;
+        std::cout << "equity: " << result.equity * 100 << "% +/- " << result.standardError * 100 << "%" << std::endl;
+    } catch (const std::invalid_argument &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
     }
+    return 0;
+}
+
+// 范围对范围胜率：AY_GTO range <英雄范围> <对手范围> [--board 公共牌] [--threads N] [--samples N]
+static int runRangeEquity(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: AY_GTO range <hero range> <villain range> [--board cards] [--threads n] [--samples n]" << std::endl;
+        return 1;
+    }
+    std::optional<Range> hero = Range::fromString(argv[0]);
+    std::optional<Range> villain = Range::fromString(argv[1]);
+    if (!hero || !villain) {
+        std::cerr << "invalid range" << std::endl;
+        return 1;
+    }
+    CardSet board;
+    RangeEquityConfig config;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--board") {
+            std::optional<CardSet> parsed = CardSet::fromString(argv[i + 1]);
+            if (!parsed) {
+                std::cerr << "invalid board: " << argv[i + 1] << std::endl;
+                return 1;
+            }
+            board = *parsed;
+        } else if (arg == "--threads") {
+            if (!readNumber(arg, argv[i + 1], config.threads)) {
+                return 1;
+            }
+        } else if (arg == "--samples") {
+            if (!readNumber(arg, argv[i + 1], config.boardSamples)) {
+                return 1;
+            }
+        }
+    }
+
+    RangeEquityResult result = RangeEquity::compute(*hero, *villain, board, config);
+    std::cout << "hero combos: " << hero->withoutBlocked(board).comboCount() << std::endl;
+    std::cout << "villain combos: " << villain->withoutBlocked(board).comboCount() << std::endl;
+    std::cout << "boards: " << result.boards << std::endl;
+    std::cout << "equity: " << result.equity * 100 << "%" << std::endl;
+    return 0;
+}
 
-    // 发公共牌
-    for (int i = 0; i < 5; i++) {
-        Card card3 = deck.dealCard();
-        commonCard.push_back(card3);
-        std::cout << "Dealt card 3: " << card3.getRankString() << " of " << card3.getSuitString() << std::endl;
+// 逐公共牌报告：AY_GTO report <英雄范围> <对手范围> <输出文件> [--board 公共牌] [--cards 3~5] [--threads N]
+//   [--samples N]（每副公共牌随机抽取的剩余发法数，默认精确枚举） [--pot X] [--stake X] [--binary] [--seed N]
+static int runReport(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: AY_GTO report <hero range> <villain range> <output> [--board cards] [--cards n] [--threads n] [--samples n] [--pot x] [--stake x] [--binary] [--seed n]" << std::endl;
+        return 1;
+    }
+    std::optional<Range> hero = Range::fromString(argv[0]);
+    std::optional<Range> villain = Range::fromString(argv[1]);
+    if (!hero || !villain) {
+        std::cerr << "invalid range" << std::endl;
+        return 1;
+    }
+    CardSet board;
+    BoardReportConfig config;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--binary") {
+            config.format = ReportFormat::BINARY;
+        } else if (i + 1 >= argc) {
+            break;
+        } else if (arg == "--board") {
+            std::optional<CardSet> parsed = CardSet::fromString(argv[++i]);
+            if (!parsed) {
+                std::cerr << "invalid board: " << argv[i] << std::endl;
+                return 1;
+            }
+            board = *parsed;
+        } else if (arg == "--cards") {
+            if (!readNumber(arg, argv[++i], config.boardCards)) {
+                return 1;
+            }
+        } else if (arg == "--threads") {
+            if (!readNumber(arg, argv[++i], config.threads)) {
+                return 1;
+            }
+        } else if (arg == "--samples") {
+            if (!readNumber(arg, argv[++i], config.runoutSamples)) {
+                return 1;
+            }
+        } else if (arg == "--pot") {
+            if (!readNumber(arg, argv[++i], config.pot)) {
+                return 1;
+            }
+        } else if (arg == "--stake") {
+            if (!readNumber(arg, argv[++i], config.stake)) {
+                return 1;
+            }
+        } else if (arg == "--seed") {
+            if (!readNumber(arg, argv[++i], config.seed)) {
+                return 1;
+            }
+        }
     }
+    try {
+        BoardReportStats stats = BoardReport::generate(*hero, *villain, board, argv[2], config);
+        std::cout << "rows: " << stats.rows << ", boards: " << stats.boards << ", seconds: " << stats.seconds
+                  << std::endl;
+        std::cout << "equity: " << stats.equity * 100 << "%, ev: " << stats.ev << std::endl;
+        const char *names[HAND_TYPE_COUNT] = {"high card", "pair", "two pair", "three of a kind", "straight",
+                                              "flush", "full house", "four of a kind", "straight flush"};
+        for (int type = 0; type < HAND_TYPE_COUNT; ++type) {
+            std::cout << names[type] << ": " << stats.handTypes[type] * 100 << "%" << std::endl;
+        }
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
 
-    // 打印发牌后的手牌内容
-    std::cout << "Player 1 cards:";
-    for (const Card& card : player1) {
-        std::cout << " " << card.getRankString() << " of " << card.getSuitString();
+// 翻前胜率表：AY_GTO preflop generate <文件> [--threads N] [--trials N]
+//           AY_GTO preflop <文件> <起手牌> <起手牌>
+//           AY_GTO preflop <文件> <起手牌> --players N
+static int runPreflop(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: AY_GTO preflop generate <file> [--threads n] [--trials n]" << std::endl;
+        std::cerr << "       AY_GTO preflop <file> <hand> <hand|--players n>" << std::endl;
+        return 1;
+    }
+    if (std::string(argv[0]) == "generate") {
+        PreflopGenerateConfig config;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            std::string arg = argv[i];
+            if (arg == "--threads") {
+                if (!readNumber(arg, argv[i + 1], config.threads)) {
+                    return 1;
+                }
+            } else if (arg == "--trials") {
+                if (!readNumber(arg, argv[i + 1], config.randomTrials)) {
+                    return 1;
+                }
+            }
+        }
+        try {
+            PreflopTable::generate(argv[1], config);
+        } catch (const std::runtime_error &error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        std::cout << "wrote " << argv[1] << std::endl;
+        return 0;
     }
-    std::cout << std::endl;
 
-    std::cout << "Player 2 cards:";
-    for (const Card& card : player2) {
-        std::cout << " " << card.getRankString() << " of " << card.getSuitString();
+    std::optional<PreflopTable> table = PreflopTable::open(argv[0]);
+    if (!table) {
+        std::cerr << "cannot open preflop table: " << argv[0] << std::endl;
+        return 1;
+    }
+    std::optional<int> hero = PreflopTable::parseClass(argv[1]);
+    if (!hero) {
+        std::cerr << "invalid hand: " << argv[1] << std::endl;
+        return 1;
+    }
+    if (argc >= 4 && std::string(argv[2]) == "--players") {
+        int players = 0;
+        if (!readNumber(argv[2], argv[3], players)) {
+            return 1;
+        }
+        if (players < 2 || players > PreflopTable::MAX_PLAYERS) {
+            std::cerr << "players must be between 2 and " << PreflopTable::MAX_PLAYERS << std::endl;
+            return 1;
+        }
+        std::cout << PreflopTable::className(*hero) << " vs " << players - 1 << " random: "
+                  << table->equityVsRandom(*hero, players) * 100 << "%" << std::endl;
+        return 0;
     }
-    std::cout << std::endl;
+    std::optional<int> villain = argc >= 3 ? PreflopTable::parseClass(argv[2]) : std::nullopt;
+    if (!villain) {
+        std::cerr << "invalid hand: " << (argc >= 3 ? argv[2] : "") << std::endl;
+        return 1;
+    }
+    std::cout << PreflopTable::className(*hero) << " vs " << PreflopTable::className(*villain) << ": "
+              << table->equity(*hero, *villain) * 100 << "%" << std::endl;
+    return 0;
+}
 
-    PokerHand pokerHand1(player1);
-    PokerHand pokerHand2(player2);
+// 手牌抽象：AY_GTO abstract <flop|turn> <文件> [--buckets N] [--bins N] [--iterations N] [--samples N] [--threads N]
+//         AY_GTO bucket <文件> <手牌> <公共牌>
+static int runAbstract(int argc, char *argv[]) {
+    if (argc < 2 || (std::string(argv[0]) != "flop" && std::string(argv[0]) != "turn")) {
+        std::cerr << "usage: AY_GTO abstract <flop|turn> <file> [--buckets n] [--bins n] [--iterations n] [--samples n] [--threads n]" << std::endl;
+        return 1;
+    }
+    AbstractionConfig config;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--buckets") {
+            if (!readNumber(arg, argv[i + 1], config.buckets)) {
+                return 1;
+            }
+        } else if (arg == "--bins") {
+            if (!readNumber(arg, argv[i + 1], config.histogramBins)) {
+                return 1;
+            }
+        } else if (arg == "--iterations") {
+            if (!readNumber(arg, argv[i + 1], config.iterations)) {
+                return 1;
+            }
+        } else if (arg == "--samples") {
+            if (!readNumber(arg, argv[i + 1], config.trainingSamples)) {
+                return 1;
+            }
+        } else if (arg == "--threads") {
+            if (!readNumber(arg, argv[i + 1], config.threads)) {
+                return 1;
+            }
+        }
+    }
+    try {
+        BucketMap map = BucketMap::build(std::string(argv[0]) == "flop" ? 3 : 4, config);
+        map.save(argv[1]);
+        std::cout << "boards: " << map.getBoardCount() << ", buckets: " << map.getBucketCount()
+                  << ", bytes: " << map.memoryBytes() << std::endl;
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
 
-    // 获取每个玩家的最佳手牌
-    std::vector<Card> player1BestHand = PokerHand::getBestHand(commonCard, player1);
-    std::vector<Card> player2BestHand = PokerHand::getBestHand(commonCard, player2);
+static int runBucket(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: AY_GTO bucket <file> <hole cards> <board>" << std::endl;
+        return 1;
+    }
+    std::optional<BucketMap> map = BucketMap::load(argv[0]);
+    std::optional<CardSet> hole = CardSet::fromString(argv[1]);
+    std::optional<CardSet> board = CardSet::fromString(argv[2]);
+    if (!map || !hole || !board) {
+        std::cerr << "invalid bucket map or cards" << std::endl;
+        return 1;
+    }
+    uint16_t bucket = map->bucket(*hole, *board);
+    if (bucket == BucketMap::NO_BUCKET) {
+        std::cerr << "cards do not match this bucket map" << std::endl;
+        return 1;
+    }
+    std::cout << "bucket: " << bucket << " / " << map->getBucketCount() << std::endl;
+    if (std::optional<StrengthMoments> moments = map->moments(*hole, *board)) {
+        std::cout << "E[HS]: " << moments->expected << ", E[HS^2]: " << moments->expectedSquare << std::endl;
+    }
+    return 0;
+}
 
-    // 打印最佳手牌的类型
-    std::cout << "Player 1 best hand type: ";
-    PokerHand(player1BestHand).printHandType();
+// 批量处理手牌记录：AY_GTO history <输入> <输出> [--threads N] [--batch N] [--trials N]
+static int runHistory(int argc, char *argv[]) {
+    const char *usage = "usage: AY_GTO history <hand history> <summary file> [--threads n] [--batch n] [--trials n]";
+    if (argc < 2) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+    HistoryConfig config;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--threads") {
+            if (!readNumber(arg, argv[i + 1], config.threads)) {
+                return 1;
+            }
+        } else if (arg == "--batch") {
+            if (!readNumber(arg, argv[i + 1], config.batchSize)) {
+                return 1;
+            }
+        } else if (arg == "--trials") {
+            if (!readNumber(arg, argv[i + 1], config.allInTrials)) {
+                return 1;
+            }
+        }
+    }
+    try {
+        HistoryStats stats = HandHistory::process(argv[0], argv[1], config);
+        std::cout << "hands: " << stats.hands << ", showdowns: " << stats.showdowns << ", all-in: " << stats.allIns
+                  << ", skipped: " << stats.skipped << ", seats: " << stats.seats << ", bytes: " << stats.bytes << std::endl;
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
 
-    std::cout << "Player 2 best hand type: ";
-    PokerHand(player2BestHand).printHandType();
+// 解析逗号分隔的下注尺度，例如 "0.5,1"；有一项不是数字时返回空
+static std::optional<std::vector<float>> parseSizes(const std::string &text) {
+    std::vector<float> sizes;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::optional<float> size = parseNumber<float>(std::string_view(text).substr(start, end - start));
+        if (!size) {
+            return std::nullopt;
+        }
+        sizes.push_back(*size);
+        start = end + 1;
+    }
+    return sizes;
+}
 
-    // 比较手牌大小
-    int result = PokerHand::compareHands(player1BestHand, player2BestHand);
+static std::optional<CheckpointEncoding> parseEncoding(const std::string &text) {
+    if (text == "f32") {
+        return CheckpointEncoding::FLOAT32;
+    }
+    if (text == "f16") {
+        return CheckpointEncoding::FLOAT16;
+    }
+    if (text == "q8") {
+        return CheckpointEncoding::QUANTIZED8;
+    }
+    return std::nullopt;
+}
 
-    if (result == 1) {
-        std::cout << "Hand 1 wins!" << std::endl;
-    } else if (result == -1) {
-        std::cout << "Hand 2 wins!" << std::endl;
-    } else {
-        std::cout << "It's a tie!" << std::endl;
+// 行动节点各动作的平均频率（按手牌权重），strategy 按 [动作][手牌] 排列
+static void printFrequencies(const GameTree &tree, int node, const std::vector<float> &strategy,
+                             const std::vector<float> &weights) {
+    const size_t count = weights.size();
+    double total = 0;
+    for (float weight: weights) {
+        total += weight;
+    }
+    for (int a = 0; a < tree.getChildCount(node); ++a) {
+        double frequency = 0;
+        for (size_t h = 0; h < count; ++h) {
+            frequency += strategy[a * count + h] * weights[h];
+        }
+        const Action action = tree.getAction(node, a);
+        std::cout << actionName(action.type) << " " << action.amount << ": " << frequency / total * 100 << "%"
+                  << std::endl;
     }
+}
 
+// 求解转牌/河牌子博弈：AY_GTO solve --board 公共牌 --oop 范围 --ip 范围 [--pot N] [--stack N]
+//   [--bets 0.5,1] [--raises 1] [--iterations N] [--target 百分比] [--threads N] [--algorithm dcfr|cfr+]
+//   [--check-every N]（每 N 次迭代计算一次可利用度）
+//   [--save-tree 文件] [--tree 文件]（从文件映射已建好的树，忽略公共牌和下注设置）
+//   [--checkpoint 文件] [--checkpoint-every N]（结束时和每 N 次迭代保存可以继续求解的检查点）
+//   [--resume 文件]（从检查点继续，树和范围都来自检查点）
+//   [--export 文件] [--encoding f32|f16|q8] [--compression 0~9]（结束时只保存用于查询的平均策略）
+static int runSolve(int argc, char *argv[]) {
+    CardSet board;
+    std::optional<Range> ranges[2];
+    TreeConfig treeConfig;
+    SolverConfig solverConfig;
+    std::string treeIn;
+    std::string treeOut;
+    std::string resumePath;
+    std::string exportPath;
+    CheckpointOptions exportOptions;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--board") {
+            std::optional<CardSet> parsed = CardSet::fromString(value);
+            if (!parsed) {
+                std::cerr << "invalid board: " << value << std::endl;
+                return 1;
+            }
+            board = *parsed;
+        } else if (arg == "--oop") {
+            ranges[0] = Range::fromString(value);
+        } else if (arg == "--ip") {
+            ranges[1] = Range::fromString(value);
+        } else if (arg == "--pot") {
+            if (!readNumber(arg, value, treeConfig.pot)) {
+                return 1;
+            }
+        } else if (arg == "--stack") {
+            if (!readNumber(arg, value, treeConfig.stack)) {
+                return 1;
+            }
+        } else if (arg == "--bets" || arg == "--raises") {
+            std::optional<std::vector<float>> sizes = parseSizes(value);
+            if (!sizes) {
+                std::cerr << "invalid value for " << arg << ": " << value << std::endl;
+                return 1;
+            }
+            if (arg == "--bets") {
+                treeConfig.turn.betSizes = treeConfig.river.betSizes = *sizes;
+            } else {
+                treeConfig.turn.raiseSizes = treeConfig.river.raiseSizes = *sizes;
+            }
+        } else if (arg == "--iterations") {
+            if (!readNumber(arg, value, solverConfig.iterations)) {
+                return 1;
+            }
+        } else if (arg == "--target") {
+            if (!readNumber(arg, value, solverConfig.targetExploitability)) {
+                return 1;
+            }
+            solverConfig.targetExploitability /= 100;
+        } else if (arg == "--threads") {
+            if (!readNumber(arg, value, solverConfig.threads)) {
+                return 1;
+            }
+        } else if (arg == "--algorithm") {
+            solverConfig.algorithm = value == "cfr+" ? CfrAlgorithm::CFR_PLUS : CfrAlgorithm::DISCOUNTED;
+        } else if (arg == "--tree") {
+            treeIn = value;
+        } else if (arg == "--save-tree") {
+            treeOut = value;
+        } else if (arg == "--check-every") {
+            if (!readNumber(arg, value, solverConfig.checkInterval)) {
+                return 1;
+            }
+            solverConfig.checkInterval = std::max(1, solverConfig.checkInterval);
+        } else if (arg == "--checkpoint") {
+            solverConfig.checkpointPath = value;
+        } else if (arg == "--checkpoint-every") {
+            if (!readNumber(arg, value, solverConfig.checkpointInterval)) {
+                return 1;
+            }
+        } else if (arg == "--resume") {
+            resumePath = value;
+        } else if (arg == "--export") {
+            exportPath = value;
+        } else if (arg == "--encoding") {
+            std::optional<CheckpointEncoding> encoding = parseEncoding(value);
+            if (!encoding) {
+                std::cerr << "invalid encoding: " << value << std::endl;
+                return 1;
+            }
+            exportOptions.encoding = *encoding;
+        } else if (arg == "--compression") {
+            if (!readNumber(arg, value, exportOptions.compression)) {
+                return 1;
+            }
+        }
+    }
+    if ((!ranges[0] || !ranges[1]) && resumePath.empty()) {
+        std::cerr << "usage: AY_GTO solve --board cards --oop range --ip range [--pot n] [--stack n] [--bets 0.5,1]"
+                     " [--raises 1] [--iterations n] [--target percent] [--threads n] [--algorithm dcfr|cfr+]"
+                     " [--check-every n] [--save-tree file] [--tree file] [--checkpoint file] [--checkpoint-every n]"
+                     " [--resume file] [--export file] [--encoding f32|f16|q8] [--compression 0-9]" << std::endl;
+        return 1;
+    }
+
+    try {
+        std::optional<Checkpoint> checkpoint;
+        std::optional<GameTree> gameTree;
+        if (!resumePath.empty()) {
+            checkpoint = Checkpoint::open(resumePath);
+            if (!checkpoint) {
+                std::cerr << "invalid checkpoint file: " << resumePath << std::endl;
+                return 1;
+            }
+            gameTree = checkpoint->readTree();
+            ranges[0] = checkpoint->getRange(0);
+            ranges[1] = checkpoint->getRange(1);
+        } else {
+            gameTree = treeIn.empty() ? GameTree::build(board, treeConfig) : GameTree::open(treeIn);
+        }
+        if (!gameTree) {
+            std::cerr << "invalid game tree file: " << treeIn << std::endl;
+            return 1;
+        }
+        if (!treeOut.empty()) {
+            gameTree->save(treeOut);
+        }
+        CfrSolver solver(std::move(*gameTree), *ranges[0], *ranges[1]);
+        if (checkpoint) {
+            solver.restore(*checkpoint);
+            checkpoint.reset();
+        }
+        std::cout << "tree nodes: " << solver.getTree().getNodeCount() << ", bytes: " << solver.getTree().memoryBytes()
+                  << std::endl;
+        std::cout << "hands: " << solver.getHandCount(0) << " vs " << solver.getHandCount(1) << std::endl;
+        float exploitability = solver.solve(solverConfig);
+        std::cout << "iterations: " << solver.getIterations() << std::endl;
+        std::cout << "exploitability: " << exploitability * 100 << "% of pot" << std::endl;
+        if (!solverConfig.checkpointPath.empty()) {
+            solver.saveCheckpoint(solverConfig.checkpointPath);
+        }
+        if (!exportPath.empty()) {
+            solver.exportStrategy(exportPath, exportOptions);
+        }
+
+        const GameTree &tree = solver.getTree();
+        std::vector<float> weights(solver.getHandCount(0));
+        for (int h = 0; h < solver.getHandCount(0); ++h) {
+            weights[h] = ranges[0]->getWeight(solver.getHandCombo(0, h));
+        }
+        printFrequencies(tree, tree.getRoot(), solver.getAverageStrategy(tree.getRoot()), weights);
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 查询检查点中的策略：AY_GTO strategy <检查点> [--node N]
+// 只映射文件、解码该节点用到的块，不需要把整个解读入内存
+static int runStrategy(int argc, char *argv[]) {
+    if (argc < 1) {
+        std::cerr << "usage: AY_GTO strategy <checkpoint> [--node n]" << std::endl;
+        return 1;
+    }
+    int node = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::string(argv[i]) == "--node") {
+            if (!readNumber(argv[i], argv[i + 1], node)) {
+                return 1;
+            }
+        }
+    }
+    std::optional<Checkpoint> checkpoint = Checkpoint::open(argv[0]);
+    if (!checkpoint) {
+        std::cerr << "invalid checkpoint file: " << argv[0] << std::endl;
+        return 1;
+    }
+    const GameTree &tree = checkpoint->getTree();
+    if (node < 0 || node >= tree.getNodeCount() || tree.getType(node) != NodeType::ACTION) {
+        std::cerr << "not an action node: " << node << std::endl;
+        return 1;
+    }
+    try {
+        const int player = tree.getPlayer(node);
+        std::vector<float> weights(checkpoint->getHandCount(player));
+        const Range range = checkpoint->getRange(player);
+        for (int h = 0; h < checkpoint->getHandCount(player); ++h) {
+            weights[h] = range.getWeight(checkpoint->getHandCombo(player, h));
+        }
+        std::cout << "iterations: " << checkpoint->getIterations() << ", player: " << player << std::endl;
+        printFrequencies(tree, node, checkpoint->getAverageStrategy(node), weights);
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 最佳应对：AY_GTO br <检查点> [--threads N] [--bb 大盲]
+// 计算检查点中平均策略的精确最佳应对和可利用度，bb 为一个大盲的筹码数，默认 1
+static int runBestResponse(int argc, char *argv[]) {
+    if (argc < 1) {
+        std::cerr << "usage: AY_GTO br <checkpoint> [--threads n] [--bb chips]" << std::endl;
+        return 1;
+    }
+    int threads = 0;
+    double bigBlind = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--threads") {
+            if (!readNumber(arg, argv[i + 1], threads)) {
+                return 1;
+            }
+        } else if (arg == "--bb") {
+            if (!readNumber(arg, argv[i + 1], bigBlind)) {
+                return 1;
+            }
+        }
+    }
+    std::optional<Checkpoint> checkpoint = Checkpoint::open(argv[0]);
+    if (!checkpoint) {
+        std::cerr << "invalid checkpoint file: " << argv[0] << std::endl;
+        return 1;
+    }
+    try {
+        const GameTree tree = checkpoint->readTree();
+        const Subgame subgame(tree, checkpoint->getRange(0), checkpoint->getRange(1));
+        const CheckpointProfile profile(*checkpoint, subgame);
+        const BestResponseResult result = BestResponse(subgame).compute(profile, threads);
+        std::cout << "best response oop: " << result.values[0] << ", ip: " << result.values[1] << std::endl;
+        std::cout << "exploitability: " << result.exploitability << " chips, "
+                  << result.exploitability / tree.getConfig().pot * 100 << "% of pot, "
+                  << result.mbbPerHand(bigBlind) << " mbb/hand" << std::endl;
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
     return 0;
 }
+
+// 查询服务：AY_GTO serve [--socket 路径] [--preflop 文件] [--strategy 文件]... [--threads N] [--cache N] [--trials N]
+// 不指定 --socket 时从标准输入逐行读请求、向标准输出写回答，协议见 Server/queryserver.h
+static int runServe(int argc, char *argv[]) {
+    const char *usage = "usage: AY_GTO serve [--socket path] [--preflop file] [--strategy file]... [--threads n]"
+                        " [--cache n] [--trials n]";
+    ServerConfig config;
+    std::string socketPath;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--socket") {
+            socketPath = value;
+        } else if (arg == "--preflop") {
+            config.preflopPath = value;
+        } else if (arg == "--strategy") {
+            config.strategyPaths.push_back(value);
+        } else if (arg == "--threads") {
+            if (!readNumber(arg, value, config.threads)) {
+                return 1;
+            }
+        } else if (arg == "--cache") {
+            if (!readNumber(arg, value, config.cacheSize)) {
+                return 1;
+            }
+        } else if (arg == "--trials") {
+            if (!readNumber(arg, value, config.trials)) {
+                return 1;
+            }
+        } else {
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+    }
+    try {
+        QueryServer server(config);
+        if (socketPath.empty()) {
+            std::ios::sync_with_stdio(false);
+            server.serveStream(std::cin, std::cout);
+        } else {
+            std::cerr << "listening on " << socketPath << std::endl;
+            server.serveSocket(socketPath);
+        }
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 多桌模拟：AY_GTO simulate [--bots tight,calling,...] [--hands N] [--tournament] [--payouts 50,30,20]
+//   [--blinds 1/2] [--stack N] [--level-hands N] [--duplicate] [--target X] [--tables N] [--threads N] [--seed N]
+// 每个座位一个机器人（2~9 个，见 BotPolicy::create），运行中每秒输出一次当前统计
+static int runSimulate(int argc, char *argv[]) {
+    SimulationConfig config;
+    std::vector<std::string> names{"tight", "calling"};
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tournament") {
+            config.format = GameFormat::TOURNAMENT;
+        } else if (arg == "--duplicate") {
+            config.duplicate = true;
+        } else if (i + 1 < argc && arg == "--bots") {
+            names.clear();
+            std::string text = argv[++i];
+            for (size_t start = 0; start <= text.size();) {
+                size_t end = std::min(text.find(',', start), text.size());
+                names.push_back(text.substr(start, end - start));
+                start = end + 1;
+            }
+        } else if (i + 1 < argc && arg == "--hands") {
+            if (!readNumber(arg, argv[++i], config.hands)) {
+                return 1;
+            }
+        } else if (i + 1 < argc && arg == "--payouts") {
+            std::optional<std::vector<float>> payouts = parseSizes(argv[++i]);
+            if (!payouts) {
+                std::cerr << "invalid value for " << arg << ": " << argv[i] << std::endl;
+                return 1;
+            }
+            config.payouts.assign(payouts->begin(), payouts->end());
+        } else if (i + 1 < argc && arg == "--blinds") {
+            std::string text = argv[++i];
+            size_t slash = text.find('/');
+            if (!readNumber(arg, text.substr(0, slash), config.smallBlind)) {
+                return 1;
+            }
+            config.bigBlind = 2 * config.smallBlind;
+            if (slash != std::string::npos && !readNumber(arg, text.substr(slash + 1), config.bigBlind)) {
+                return 1;
+            }
+        } else if (i + 1 < argc && arg == "--stack") {
+            if (!readNumber(arg, argv[++i], config.stack)) {
+                return 1;
+            }
+        } else if (i + 1 < argc && arg == "--level-hands") {
+            if (!readNumber(arg, argv[++i], config.levelHands)) {
+                return 1;
+            }
+        } else if (i + 1 < argc && arg == "--target") {
+            if (!readNumber(arg, argv[++i], config.targetInterval)) {
+                return 1;
+            }
+        } else if (i + 1 < argc && arg == "--tables") {
+            if (!readNumber(arg, argv[++i], config.tables)) {
+                return 1;
+            }
+        } else if (i + 1 < argc && arg == "--threads") {
+            if (!readNumber(arg, argv[++i], config.threads)) {
+                return 1;
+            }
+        } else if (i + 1 < argc && arg == "--seed") {
+            if (!readNumber(arg, argv[++i], config.seed)) {
+                return 1;
+            }
+        } else {
+            std::cerr << "usage: AY_GTO simulate [--bots tight,calling,...] [--hands n] [--tournament] [--payouts 50,30,20]"
+                         " [--blinds 1/2] [--stack n] [--level-hands n] [--duplicate] [--target x] [--tables n]"
+                         " [--threads n] [--seed n]" << std::endl;
+            return 1;
+        }
+    }
+    std::vector<std::shared_ptr<const BotPolicy>> bots;
+    for (const std::string &name: names) {
+        std::shared_ptr<const BotPolicy> bot = BotPolicy::create(name);
+        if (!bot) {
+            std::cerr << "unknown bot: " << name << " (calling, random, tight)" << std::endl;
+            return 1;
+        }
+        bots.push_back(bot);
+    }
+
+    const bool tournament = config.format == GameFormat::TOURNAMENT;
+    const char *unit = tournament ? "% roi" : " bb/100";
+    auto print = [&](const SimulationStats &stats, bool final) {
+        std::cout << (tournament ? "tournaments: " : "hands: ") << (tournament ? stats.tournaments : stats.hands);
+        if (stats.seconds > 0) {
+            std::cout << " (" << static_cast<uint64_t>(static_cast<double>(stats.hands) / stats.seconds) << " hands/s)";
+        }
+        std::cout << (final ? "\n" : "");
+        for (size_t seat = 0; seat < stats.bots.size(); ++seat) {
+            const BotStats &bot = stats.bots[seat];
+            std::cout << (final ? "seat " : ", ") << seat + 1 << " " << names[seat] << ": " << bot.mean << " +/- "
+                      << bot.interval << unit;
+            if (final) {
+                std::cout << ", " << (tournament ? "first places: " : "pots won: ") << bot.wins;
+                if (!tournament) {
+                    std::cout << ", showdowns: " << bot.showdowns;
+                }
+                std::cout << "\n";
+            }
+        }
+        if (!final) {
+            std::cout << std::endl;
+        }
+    };
+
+    try {
+        Simulator simulator(bots);
+        SimulationStats stats = simulator.run(config, [&](const SimulationStats &snapshot) { print(snapshot, false); });
+        print(stats, true);
+        std::cout << "showdowns: " << stats.showdowns << ", seconds: " << stats.seconds << std::endl;
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    // 启动时构建一次牌力查找表，之后所有线程共享
+    LookupEvaluator::initialize();
+
+    if (argc > 1 && std::string(argv[1]) == "equity") {
+        return runEquity(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "range") {
+        return runRangeEquity(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "report") {
+        return runReport(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "solve") {
+        return runSolve(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "preflop") {
+        return runPreflop(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "abstract") {
+        return runAbstract(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "bucket") {
+        return runBucket(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "history") {
+        return runHistory(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "strategy") {
+        return runStrategy(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "br") {
+        return runBestResponse(argc - 2, argv + 2);
+    }
+    if (argc > 1 && std::string(argv[1]) == "serve") {
+        return runServe(argc - 2, argv + 2);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "simulate") {
+        return runSimulate(argc - 2, argv + 2);
+    }
+
+    // 不带命令时用默认设置跑一场单挑模拟
+    const int result = runSimulate(argc - 1, argv + 1);
+
+    if constexpr (Counters::ENABLED) {
+        EvaluationCounters counters = Counters::snapshot();
+        std::cout << "evaluations: " << counters.evaluations << ", getBestHand calls: " << counters.bestHandCalls
+                  << " (" << counters.bestHandNanoseconds << " ns)" << std::endl;
+    }
+
+    return result;
+}
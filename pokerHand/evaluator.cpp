@@ -0,0 +1,121 @@
+#include "evaluator.h"
+
+namespace {
+
+    int highestRank(uint32_t mask) {
+        return 31 - __builtin_clz(mask);
+    }
+
+    // 依次取出掩码中最大的 n 个点数，每个点数占 4 位，从高到低拼接
+    uint32_t packTopRanks(uint32_t mask, int n) {
+        uint32_t packed = 0;
+        for (int i = 0; i < n; ++i) {
+            packed <<= 4;
+            if (mask != 0) {
+                int rank = highestRank(mask);
+                packed |= rank;
+                mask &= ~(1u << rank);
+            }
+        }
+        return packed;
+    }
+
+    // 拼出最终的牌力值，packed 中有 n 个点数，不足 5 个时低位补 0
+    uint32_t makeStrength(HandType type, uint32_t packed, int n) {
+        return (static_cast<uint32_t>(type) << Evaluator::CATEGORY_SHIFT) | (packed << (4 * (5 - n)));
+    }
+
+}
+
+uint64_t Evaluator::handMask(const std::vector<Card> &cards) {
+    return CardSet::fromCards(cards).getBits();
+}
+
+int Evaluator::straightHigh(uint32_t ranks) {
+    // 在最低位补一张 A，用来识别 A-2-3-4-5
+    uint32_t extended = (ranks << 1) | (ranks >> 12);
+    uint32_t runs = extended & (extended >> 1) & (extended >> 2) & (extended >> 3) & (extended >> 4);
+    if (runs == 0) {
+        return -1;
+    }
+    return highestRank(runs) + 3;
+}
+
+uint32_t Evaluator::evaluate(uint64_t cards) {
+    const uint32_t clubs = suitRanks(cards, 0);
+    const uint32_t diamonds = suitRanks(cards, 1);
+    const uint32_t hearts = suitRanks(cards, 2);
+    const uint32_t spades = suitRanks(cards, 3);
+
+    // 同花和同花顺：7 张牌里有同花时不可能再组成葫芦或四条
+    for (uint32_t suit: {clubs, diamonds, hearts, spades}) {
+        if (__builtin_popcount(suit) >= 5) {
+            int high = straightHigh(suit);
+            if (high >= 0) {
+                return makeStrength(HandType::STRAIGHT_FLUSH, high, 1);
+            }
+            return makeStrength(HandType::FLUSH, packTopRanks(suit, 5), 5);
+        }
+    }
+
+    // 按位切片统计每个点数出现的次数：count = four * 4 + two * 2 + one
+    uint32_t one = 0, two = 0, four = 0;
+    for (uint32_t suit: {clubs, diamonds, hearts, spades}) {
+        uint32_t carry = one & suit;
+        one ^= suit;
+        four |= two & carry;
+        two ^= carry;
+    }
+    const uint32_t ranks = clubs | diamonds | hearts | spades;
+    const uint32_t quads = four;
+    const uint32_t trips = two & one;
+    const uint32_t pairs = two & ~one;
+
+    if (quads != 0) {
+        int quad = highestRank(quads);
+        uint32_t kicker = packTopRanks(ranks & ~(1u << quad), 1);
+        return makeStrength(HandType::FOUR_OF_A_KIND, (quad << 4) | kicker, 2);
+    }
+
+    if (trips != 0) {
+        int trip = highestRank(trips);
+        uint32_t rest = (trips & ~(1u << trip)) | pairs;
+        if (rest != 0) {
+            return makeStrength(HandType::FULL_HOUSE, (trip << 4) | highestRank(rest), 2);
+        }
+    }
+
+    int high = straightHigh(ranks);
+    if (high >= 0) {
+        return makeStrength(HandType::STRAIGHT, high, 1);
+    }
+
+    if (trips != 0) {
+        int trip = highestRank(trips);
+        uint32_t kickers = packTopRanks(ranks & ~(1u << trip), 2);
+        return makeStrength(HandType::THREE_OF_A_KIND, (trip << 8) | kickers, 3);
+    }
+
+    if (__builtin_popcount(pairs) >= 2) {
+        int highPair = highestRank(pairs);
+        int lowPair = highestRank(pairs & ~(1u << highPair));
+        uint32_t kicker = packTopRanks(ranks & ~(1u << highPair) & ~(1u << lowPair), 1);
+        return makeStrength(HandType::TWO_PAIR, (highPair << 8) | (lowPair << 4) | kicker, 3);
+    }
+
+    if (pairs != 0) {
+        int pair = highestRank(pairs);
+        uint32_t kickers = packTopRanks(ranks & ~(1u << pair), 3);
+        return makeStrength(HandType::PAIR, (pair << 12) | kickers, 4);
+    }
+
+    return makeStrength(HandType::HIGH_CARD, packTopRanks(ranks, 5), 5);
+}
+
+uint32_t Evaluator::evaluate(const std::vector<Card> &cards) {
+    return evaluate(handMask(cards));
+}
+
+HandType Evaluator::handType(uint32_t strength) {
+    return static_cast<HandType>(strength >> CATEGORY_SHIFT);
+}
@@ -0,0 +1,42 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "../Card/card.h"
+#include "../Card/cardset.h"
+#include "handtype.h"
+#include <cstdint>
+#include <vector>
+
+// 位运算牌力评估器
+// 手牌用 52 位掩码表示，第 i 位对应编号为 i 的牌（见 CardIndex），与 CardSet 的位布局相同
+// 评估结果是一个可以直接比较大小的 uint32_t：
+//   bit 20-23 为牌型，bit 0-19 为 5 个 4 位的关键点数（从高到低）
+// 支持 5、6、7 张牌，评估过程不分配内存
+class Evaluator {
+public:
+    static constexpr int RANK_COUNT = ::RANK_COUNT;
+    static constexpr uint32_t RANK_MASK = (1u << RANK_COUNT) - 1;
+    static constexpr int CATEGORY_SHIFT = 20;
+
+    [[nodiscard]] static uint64_t cardMask(const Card& card) {
+        return 1ull << card.getIndex();
+    }
+    [[nodiscard]] static uint64_t handMask(const std::vector<Card>& cards);
+
+    [[nodiscard]] static uint32_t evaluate(uint64_t cards);
+    [[nodiscard]] static uint32_t evaluate(CardSet cards) {
+        return evaluate(cards.getBits());
+    }
+    [[nodiscard]] static uint32_t evaluate(const std::vector<Card>& cards);
+    [[nodiscard]] static HandType handType(uint32_t strength);
+
+    // 取出某一花色的 13 位点数掩码
+    [[nodiscard]] static uint32_t suitRanks(uint64_t cards, int suit) {
+        return static_cast<uint32_t>(cards >> (suit * RANK_COUNT)) & RANK_MASK;
+    }
+
+    // 点数掩码中的最大顺子，返回顺子最大牌的点数强度，没有顺子返回 -1
+    [[nodiscard]] static int straightHigh(uint32_t ranks);
+};
+
+#endif  // EVALUATOR_H
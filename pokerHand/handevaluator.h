@@ -0,0 +1,234 @@
+#ifndef HANDEVALUATOR_H
+#define HANDEVALUATOR_H
+
+#include "../Card/card.h"
+#include "handtype.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// 按 13 位点数掩码查的表，编译期生成，不需要初始化，编译期求值也能使用；牌力编码同 Evaluator
+struct RankTables {
+    static constexpr int SIZE = 1 << RANK_COUNT;
+
+    uint32_t topFive[SIZE] = {};   // 最大的 5 个点数，每个 4 位从高到低拼接，不足 5 个时低位补 0
+    uint32_t distinct[SIZE] = {};  // 这些点数各一张、不成同花时的牌力：顺子或高牌
+    uint32_t flush[SIZE] = {};     // 这些点数同一花色时的牌力：同花顺或同花
+
+    constexpr RankTables() {
+        for (int mask = 0; mask < SIZE; ++mask) {
+            int high = -1;
+            for (int top = RANK_COUNT - 1; top >= 3 && high < 0; --top) {
+                // 顺子 top-4..top，top 为 3 时最小的一张是 A
+                bool run = true;
+                for (int k = 0; k < 5; ++k) {
+                    const int rank = top - k >= 0 ? top - k : RANK_COUNT - 1;
+                    run = run && ((mask >> rank) & 1);
+                }
+                high = run ? top : -1;
+            }
+
+            uint32_t packed = 0;
+            int taken = 0;
+            for (int rank = RANK_COUNT - 1; rank >= 0 && taken < 5; --rank) {
+                if ((mask >> rank) & 1) {
+                    packed = packed << 4 | static_cast<uint32_t>(rank);
+                    ++taken;
+                }
+            }
+            topFive[mask] = packed << (4 * (5 - taken));
+            distinct[mask] = high >= 0 ? strength(HandType::STRAIGHT, static_cast<uint32_t>(high) << 16)
+                                       : strength(HandType::HIGH_CARD, topFive[mask]);
+            flush[mask] = high >= 0 ? strength(HandType::STRAIGHT_FLUSH, static_cast<uint32_t>(high) << 16)
+                                    : strength(HandType::FLUSH, topFive[mask]);
+        }
+    }
+
+    static constexpr uint32_t strength(HandType type, uint32_t packed) {
+        return static_cast<uint32_t>(type) << 20 | packed;
+    }
+};
+
+inline constexpr RankTables RANK_TABLES{};
+
+// 固定张数的牌力评估器，N 为 5、6 或 7
+// 牌放在 std::array 中，不分配内存；牌力编码与 Evaluator::evaluate 相同，可以和 LookupEvaluator 的结果直接比较。
+// 各牌型的判断按 N 在编译期展开：5 张牌只看不同点数的个数就能分出牌型，
+// 6、7 张牌才需要处理两个三条、三个对子、有对子的顺子等情况；顺子、同花和取顶张都查 RANK_TABLES。
+template<int N>
+class HandEvaluator {
+    static_assert(N >= 5 && N <= 7, "HandEvaluator supports 5, 6 or 7 cards");
+
+public:
+    using Cards = std::array<Card, N>;
+
+    static constexpr int CATEGORY_SHIFT = 20;
+
+    // 牌的位掩码，编码同 CardSet
+    [[nodiscard]] static constexpr uint64_t mask(const Cards &cards) {
+        return mask(cards, std::make_index_sequence<N>());
+    }
+
+    [[nodiscard]] static constexpr uint32_t evaluate(const Cards &cards) {
+        return evaluate(mask(cards));
+    }
+
+    // cards 必须正好有 N 张牌
+    [[nodiscard]] static constexpr uint32_t evaluate(uint64_t cards) {
+        const uint32_t suits[4] = {suitRanks(cards, 0), suitRanks(cards, 1), suitRanks(cards, 2), suitRanks(cards, 3)};
+        const uint32_t ranks = suits[0] | suits[1] | suits[2] | suits[3];
+        if constexpr (N == 5) {
+            return evaluateFive(suits, ranks);
+        } else {
+            return evaluateMore(suits, ranks);
+        }
+    }
+
+    [[nodiscard]] static constexpr HandType handType(uint32_t strength) {
+        return static_cast<HandType>(strength >> CATEGORY_SHIFT);
+    }
+    [[nodiscard]] static constexpr HandType handType(const Cards &cards) {
+        return handType(evaluate(cards));
+    }
+
+private:
+    template<size_t... I>
+    static constexpr uint64_t mask(const Cards &cards, std::index_sequence<I...>) {
+        return ((1ull << cards[I].getIndex()) | ...);
+    }
+
+    static constexpr uint32_t suitRanks(uint64_t cards, int suit) {
+        return static_cast<uint32_t>(cards >> (suit * RANK_COUNT)) & ((1u << RANK_COUNT) - 1);
+    }
+
+    static constexpr uint32_t flushRanks(uint32_t suit) {
+        return __builtin_popcount(suit) >= 5 ? suit : 0;
+    }
+
+    static constexpr uint32_t highest(uint32_t mask) {
+        return static_cast<uint32_t>(31 - __builtin_clz(mask));
+    }
+
+    static constexpr uint32_t strength(HandType type, uint32_t packed, int n) {
+        return (static_cast<uint32_t>(type) << CATEGORY_SHIFT) | (packed << (4 * (5 - n)));
+    }
+
+    // 最大的 n 个点数，拼接方式同 RankTables::topFive
+    static constexpr uint32_t top(uint32_t mask, int n) {
+        return RANK_TABLES.topFive[mask] >> (4 * (5 - n));
+    }
+
+    // 按位切片统计每个点数的张数：张数 = four * 4 + two * 2 + one
+    struct RankCounts {
+        uint32_t one = 0;
+        uint32_t two = 0;
+        uint32_t four = 0;
+    };
+
+    static constexpr RankCounts countRanks(const uint32_t (&suits)[4]) {
+        RankCounts counts;
+        for (uint32_t suit: suits) {
+            const uint32_t carry = counts.one & suit;
+            counts.one ^= suit;
+            counts.four |= counts.two & carry;
+            counts.two ^= carry;
+        }
+        return counts;
+    }
+
+    // 5 张牌：不同点数有 5 个时是同花（某一花色包含全部点数）、顺子或高牌，直接查表；
+    // 4 个为一对，3 个为两对或三条，2 个为葫芦或四条
+    static constexpr uint32_t evaluateFive(const uint32_t (&suits)[4], uint32_t ranks) {
+        switch (__builtin_popcount(ranks)) {
+            case 5: {
+                const bool flush = suits[0] == ranks || suits[1] == ranks || suits[2] == ranks || suits[3] == ranks;
+                return flush ? RANK_TABLES.flush[ranks] : RANK_TABLES.distinct[ranks];
+            }
+            case 4: {
+                const RankCounts counts = countRanks(suits);
+                const uint32_t pair = highest(counts.two);
+                return strength(HandType::PAIR, pair << 12 | top(ranks & ~(1u << pair), 3), 4);
+            }
+            case 3: {
+                const RankCounts counts = countRanks(suits);
+                const uint32_t trips = counts.two & counts.one;
+                if (trips != 0) {
+                    const uint32_t trip = highest(trips);
+                    return strength(HandType::THREE_OF_A_KIND, trip << 8 | top(ranks & ~trips, 2), 3);
+                }
+                const uint32_t high = highest(counts.two);
+                const uint32_t low = highest(counts.two & ~(1u << high));
+                return strength(HandType::TWO_PAIR, high << 8 | low << 4 | highest(ranks & ~counts.two), 3);
+            }
+            default: {
+                const RankCounts counts = countRanks(suits);
+                if (counts.four != 0) {
+                    return strength(HandType::FOUR_OF_A_KIND, highest(counts.four) << 4 | highest(ranks & ~counts.four), 2);
+                }
+                const uint32_t trips = counts.two & counts.one;
+                return strength(HandType::FULL_HOUSE, highest(trips) << 4 | highest(ranks & ~trips), 2);
+            }
+        }
+    }
+
+    // 6、7 张牌：可能同时有顺子和对子、两个三条或三个对子，按牌型从大到小判断
+    static constexpr uint32_t evaluateMore(const uint32_t (&suits)[4], uint32_t ranks) {
+        // 最多一种花色够 5 张，而且有同花就不会有葫芦或四条
+        const uint32_t flush = flushRanks(suits[0]) | flushRanks(suits[1]) | flushRanks(suits[2]) |
+                               flushRanks(suits[3]);
+        if (flush != 0) {
+            return RANK_TABLES.flush[flush];
+        }
+
+        const RankCounts counts = countRanks(suits);
+        const uint32_t trips = counts.two & counts.one;
+        const uint32_t pairs = counts.two & ~counts.one;
+
+        if (counts.four != 0) {
+            const uint32_t quad = highest(counts.four);
+            return strength(HandType::FOUR_OF_A_KIND, quad << 4 | highest(ranks & ~(1u << quad)), 2);
+        }
+        if (trips != 0) {
+            const uint32_t trip = highest(trips);
+            const uint32_t rest = (trips & ~(1u << trip)) | pairs;
+            if (rest != 0) {
+                return strength(HandType::FULL_HOUSE, trip << 4 | highest(rest), 2);
+            }
+        }
+        const uint32_t distinct = RANK_TABLES.distinct[ranks];
+        if (handType(distinct) == HandType::STRAIGHT) {
+            return distinct;
+        }
+        if (trips != 0) {
+            const uint32_t trip = highest(trips);
+            return strength(HandType::THREE_OF_A_KIND, trip << 8 | top(ranks & ~(1u << trip), 2), 3);
+        }
+        if (pairs != 0) {
+            const uint32_t highPair = highest(pairs);
+            const uint32_t rest = pairs & ~(1u << highPair);
+            if (rest != 0) {
+                const uint32_t lowPair = highest(rest);
+                const uint32_t kicker = highest(ranks & ~(1u << highPair) & ~(1u << lowPair));
+                return strength(HandType::TWO_PAIR, highPair << 8 | lowPair << 4 | kicker, 3);
+            }
+            return strength(HandType::PAIR, highPair << 12 | top(ranks & ~(1u << highPair), 3), 4);
+        }
+        return distinct;
+    }
+};
+
+// 编译期检查几手已知的牌
+static_assert(HandEvaluator<5>::handType({Card(Suit::SPADES, Rank::ACE), Card(Suit::SPADES, Rank::KING),
+                                          Card(Suit::SPADES, Rank::QUEEN), Card(Suit::SPADES, Rank::JACK),
+                                          Card(Suit::SPADES, Rank::TEN)}) == HandType::STRAIGHT_FLUSH);
+static_assert(HandEvaluator<6>::handType({Card(Suit::CLUBS, Rank::ACE), Card(Suit::HEARTS, Rank::TWO),
+                                          Card(Suit::SPADES, Rank::THREE), Card(Suit::CLUBS, Rank::FOUR),
+                                          Card(Suit::DIAMONDS, Rank::FIVE), Card(Suit::DIAMONDS, Rank::ACE)}) ==
+              HandType::STRAIGHT);
+static_assert(HandEvaluator<7>::handType({Card(Suit::CLUBS, Rank::KING), Card(Suit::HEARTS, Rank::KING),
+                                          Card(Suit::SPADES, Rank::KING), Card(Suit::CLUBS, Rank::NINE),
+                                          Card(Suit::DIAMONDS, Rank::NINE), Card(Suit::HEARTS, Rank::NINE),
+                                          Card(Suit::SPADES, Rank::TWO)}) == HandType::FULL_HOUSE);
+
+#endif  // HANDEVALUATOR_H
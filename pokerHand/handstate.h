@@ -0,0 +1,59 @@
+#ifndef HANDSTATE_H
+#define HANDSTATE_H
+
+#include "../Card/cardset.h"
+#include "handtype.h"
+#include "lookupevaluator.h"
+#include <cstdint>
+
+// 可以逐张加牌的牌力状态
+// 保存牌的掩码、点数键值和以及每种花色的张数，加一张牌只是三次加法；求值时不必重新统计，
+// 直接查 LookupEvaluator 的表。状态只有 16 字节，枚举时可以按值复制，在下一张牌处分支，
+// 同一前缀（手牌、翻牌、转牌）上的工作只做一次。
+class HandState {
+public:
+    constexpr HandState() = default;
+    constexpr explicit HandState(CardSet cards) {
+        for (Card card: cards) {
+            *this = add(card);
+        }
+    }
+
+    // 加一张牌后的状态；card 不能已经在状态中
+    [[nodiscard]] constexpr HandState add(Card card) const {
+        const int index = card.getIndex();
+        HandState next = *this;
+        next.cards |= 1ull << index;
+        next.keySum += LookupEvaluator::RANK_KEYS[index % RANK_COUNT];
+        next.suitCounts += 1u << (index / RANK_COUNT * 8);
+        return next;
+    }
+    [[nodiscard]] constexpr HandState add(CardSet set) const {
+        HandState next = *this;
+        for (Card card: set) {
+            next = next.add(card);
+        }
+        return next;
+    }
+
+    [[nodiscard]] constexpr CardSet getCards() const { return CardSet(cards); }
+    [[nodiscard]] constexpr int size() const { return __builtin_popcountll(cards); }
+
+    // 以下求值要求状态中有 5~7 张牌，结果与 LookupEvaluator 对同一组牌的结果相同
+    [[nodiscard]] uint16_t evaluateClass() const;
+    [[nodiscard]] uint32_t evaluate() const;
+    [[nodiscard]] HandType handType() const {
+        return LookupEvaluator::handType(evaluate());
+    }
+
+private:
+    // 每种花色占一个字节，初值为 3，张数达到 5 时该字节的第 3 位置位
+    static constexpr uint32_t SUIT_BIAS = 0x03030303u;
+    static constexpr uint32_t FLUSH_BITS = 0x08080808u;
+
+    uint64_t cards = 0;
+    uint32_t keySum = 0;
+    uint32_t suitCounts = SUIT_BIAS;
+};
+
+#endif  // HANDSTATE_H
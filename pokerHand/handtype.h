@@ -0,0 +1,17 @@
+#ifndef HANDTYPE_H
+#define HANDTYPE_H
+
+// 牌型，按大小升序排列，可以直接比较
+enum class HandType {
+    HIGH_CARD,
+    PAIR,
+    TWO_PAIR,
+    THREE_OF_A_KIND,
+    STRAIGHT,
+    FLUSH,
+    FULL_HOUSE,
+    FOUR_OF_A_KIND,
+    STRAIGHT_FLUSH
+};
+
+#endif  // HANDTYPE_H
@@ -0,0 +1,229 @@
+#include "lookupevaluator.h"
+#include "handstate.h"
+#include "evaluator.h"
+#include "../Trace/trace.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace {
+
+    constexpr int HASH_TABLE_BITS = 17;
+    constexpr int BUCKET_BITS = 13;
+    constexpr uint32_t HASH_TABLE_SIZE = 1u << HASH_TABLE_BITS;
+    constexpr uint32_t BUCKET_COUNT = 1u << BUCKET_BITS;
+    constexpr uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+    // 键值和先做乘法散列，高位选桶，中间位是桶内的初始位置
+    inline uint32_t hashBucket(uint64_t hash) {
+        return static_cast<uint32_t>(hash >> (64 - BUCKET_BITS));
+    }
+
+    inline uint32_t hashSlot(uint64_t hash) {
+        return static_cast<uint32_t>(hash >> 20) & (HASH_TABLE_SIZE - 1);
+    }
+
+}
+
+struct LookupEvaluator::Tables {
+    uint32_t rankKeySums[1u << Evaluator::RANK_COUNT];  // 13 位点数掩码 -> 键值和
+    uint16_t flushClasses[1u << Evaluator::RANK_COUNT]; // 同花花色的点数掩码 -> 等价类
+    uint32_t displacements[BUCKET_COUNT];               // 每个桶的异或偏移
+    uint16_t rankClasses[HASH_TABLE_SIZE];              // 完美哈希位置 -> 等价类
+    uint32_t strengths[HAND_CLASS_COUNT];               // 等价类 -> Evaluator 牌力值
+
+    Tables();
+
+    [[nodiscard]] uint32_t slot(uint32_t keySum) const {
+        uint64_t hash = keySum * HASH_MULTIPLIER;
+        return hashSlot(hash) ^ displacements[hashBucket(hash)];
+    }
+
+    [[nodiscard]] uint16_t toClass(uint32_t strength) const {
+        return static_cast<uint16_t>(std::lower_bound(strengths, strengths + HAND_CLASS_COUNT, strength) - strengths);
+    }
+};
+
+LookupEvaluator::Tables::Tables() : rankKeySums(), flushClasses(), displacements(), rankClasses(), strengths() {
+    for (uint32_t mask = 0; mask < (1u << Evaluator::RANK_COUNT); ++mask) {
+        for (int rank = 0; rank < Evaluator::RANK_COUNT; ++rank) {
+            if (mask & (1u << rank)) {
+                rankKeySums[mask] += RANK_KEYS[rank];
+            }
+        }
+    }
+
+    // 枚举 5~7 张牌的所有点数多重集，花色轮流分配，保证不会出现同花
+    struct RankMultiset {
+        uint32_t keySum;
+        uint32_t strength;
+    };
+    std::vector<RankMultiset> multisets;
+    int counts[Evaluator::RANK_COUNT] = {};
+    auto enumerate = [&](auto &&self, int rank, int cards) -> void {
+        if (rank == Evaluator::RANK_COUNT) {
+            if (cards < 5) {
+                return;
+            }
+            uint64_t mask = 0;
+            uint32_t keySum = 0;
+            int suit = 0;
+            for (int r = 0; r < Evaluator::RANK_COUNT; ++r) {
+                for (int i = 0; i < counts[r]; ++i) {
+                    mask |= 1ull << (suit * Evaluator::RANK_COUNT + r);
+                    suit = (suit + 1) % 4;
+                }
+                keySum += counts[r] * RANK_KEYS[r];
+            }
+            multisets.push_back({keySum, Evaluator::evaluate(mask)});
+            return;
+        }
+        for (int count = 0; count <= 4 && cards + count <= 7; ++count) {
+            counts[rank] = count;
+            self(self, rank + 1, cards + count);
+        }
+        counts[rank] = 0;
+    };
+    enumerate(enumerate, 0, 0);
+
+    // 所有可能的牌力值排序去重，得到 7462 个等价类
+    std::vector<uint32_t> allStrengths;
+    for (const RankMultiset &multiset: multisets) {
+        allStrengths.push_back(multiset.strength);
+    }
+    for (uint32_t mask = 0; mask < (1u << Evaluator::RANK_COUNT); ++mask) {
+        if (__builtin_popcount(mask) >= 5) {
+            allStrengths.push_back(Evaluator::evaluate(mask));
+        }
+    }
+    std::sort(allStrengths.begin(), allStrengths.end());
+    allStrengths.erase(std::unique(allStrengths.begin(), allStrengths.end()), allStrengths.end());
+    assert(allStrengths.size() == HAND_CLASS_COUNT);
+    std::copy(allStrengths.begin(), allStrengths.end(), strengths);
+
+    for (uint32_t mask = 0; mask < (1u << Evaluator::RANK_COUNT); ++mask) {
+        if (__builtin_popcount(mask) >= 5) {
+            flushClasses[mask] = toClass(Evaluator::evaluate(mask));
+        }
+    }
+
+    // 完美哈希：大桶优先，为每个桶找到一个不冲突的异或偏移
+    std::vector<std::vector<uint32_t>> buckets(BUCKET_COUNT);
+    for (uint32_t i = 0; i < multisets.size(); ++i) {
+        buckets[hashBucket(multisets[i].keySum * HASH_MULTIPLIER)].push_back(i);
+    }
+    std::vector<uint32_t> order(BUCKET_COUNT);
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<bool> used(HASH_TABLE_SIZE, false);
+    for (uint32_t bucket: order) {
+        const std::vector<uint32_t> &members = buckets[bucket];
+        if (members.empty()) {
+            break;
+        }
+        uint32_t displacement = 0;
+        for (; displacement < HASH_TABLE_SIZE; ++displacement) {
+            bool fits = true;
+            for (size_t i = 0; i < members.size() && fits; ++i) {
+                uint32_t s = hashSlot(multisets[members[i]].keySum * HASH_MULTIPLIER) ^ displacement;
+                fits = !used[s];
+                for (size_t j = 0; j < i && fits; ++j) {
+                    fits = (hashSlot(multisets[members[j]].keySum * HASH_MULTIPLIER) ^ displacement) != s;
+                }
+            }
+            if (fits) {
+                break;
+            }
+        }
+        assert(displacement < HASH_TABLE_SIZE);
+        displacements[bucket] = displacement;
+        for (uint32_t member: members) {
+            uint32_t s = hashSlot(multisets[member].keySum * HASH_MULTIPLIER) ^ displacement;
+            used[s] = true;
+            rankClasses[s] = toClass(multisets[member].strength);
+        }
+    }
+}
+
+const LookupEvaluator::Tables &LookupEvaluator::tables() {
+    // 局部静态变量的初始化是线程安全的，多个线程同时首次调用也只会构建一次
+    static const Tables instance;
+    return instance;
+}
+
+void LookupEvaluator::initialize() {
+    tables();
+}
+
+uint16_t LookupEvaluator::evaluateClass(uint64_t cards) {
+    const Tables &t = tables();
+    const uint32_t clubs = Evaluator::suitRanks(cards, 0);
+    const uint32_t diamonds = Evaluator::suitRanks(cards, 1);
+    const uint32_t hearts = Evaluator::suitRanks(cards, 2);
+    const uint32_t spades = Evaluator::suitRanks(cards, 3);
+
+    for (uint32_t suit: {clubs, diamonds, hearts, spades}) {
+        if (__builtin_popcount(suit) >= 5) {
+            return t.flushClasses[suit];
+        }
+    }
+    uint32_t keySum = t.rankKeySums[clubs] + t.rankKeySums[diamonds] + t.rankKeySums[hearts] + t.rankKeySums[spades];
+    return t.rankClasses[t.slot(keySum)];
+}
+
+uint32_t LookupEvaluator::evaluate(uint64_t cards) {
+    const uint32_t strength = tables().strengths[evaluateClass(cards)];
+    Counters::recordEvaluation(strength);
+    return strength;
+}
+
+uint16_t LookupEvaluator::bestRankClass(const uint32_t *keySums, int count) {
+    const Tables &t = tables();
+    uint16_t best = 0;
+    for (int i = 0; i < count; ++i) {
+        best = std::max(best, t.rankClasses[t.slot(keySums[i])]);
+    }
+    return best;
+}
+
+uint16_t LookupEvaluator::bestFlushClass(const uint32_t *ranks, int count) {
+    const Tables &t = tables();
+    uint16_t best = 0;
+    for (int i = 0; i < count; ++i) {
+        best = std::max(best, t.flushClasses[ranks[i]]);
+    }
+    return best;
+}
+
+uint16_t HandState::evaluateClass() const {
+    const LookupEvaluator::Tables &t = LookupEvaluator::tables();
+    const uint32_t flush = suitCounts & FLUSH_BITS;
+    if (flush) {
+        const int suit = __builtin_ctz(flush) / 8;
+        return t.flushClasses[Evaluator::suitRanks(cards, suit)];
+    }
+    return t.rankClasses[t.slot(keySum)];
+}
+
+uint32_t HandState::evaluate() const {
+    const uint32_t strength = LookupEvaluator::tables().strengths[evaluateClass()];
+    Counters::recordEvaluation(strength);
+    return strength;
+}
+
+uint32_t LookupEvaluator::classStrength(uint16_t handClass) {
+    return tables().strengths[handClass];
+}
+
+HandType LookupEvaluator::handType(uint32_t strength) {
+    return Evaluator::handType(strength);
+}
+
+size_t LookupEvaluator::tableBytes() {
+    return sizeof(Tables);
+}
@@ -0,0 +1,51 @@
+#ifndef LOOKUPEVALUATOR_H
+#define LOOKUPEVALUATOR_H
+
+#include "../Card/cardset.h"
+#include "handtype.h"
+#include <cstddef>
+#include <cstdint>
+
+// 查表牌力评估器
+// 非同花牌用点数多重集的键值和做完美哈希，同花牌直接用 13 位点数掩码查同花表。
+// 评估 7 张牌只需要几次内存访问，结果与 Evaluator::evaluate 完全一致。
+// 查找表约 370KB，第一次使用时构建；多线程程序应在启动时调用 initialize()，
+// 之后所有线程只读共享同一份表。
+class LookupEvaluator {
+public:
+    // 构建查找表，可重复调用，只会构建一次
+    static void initialize();
+
+    // 输入 5~7 张牌的位掩码，编码与 Evaluator 相同
+    [[nodiscard]] static uint32_t evaluate(uint64_t cards);
+    [[nodiscard]] static uint32_t evaluate(CardSet cards) {
+        return evaluate(cards.getBits());
+    }
+    [[nodiscard]] static HandType handType(uint32_t strength);
+
+    // 等价类编号：0 为最小的高牌，7461 为皇家同花顺
+    [[nodiscard]] static uint16_t evaluateClass(uint64_t cards);
+    [[nodiscard]] static uint32_t classStrength(uint16_t handClass);
+
+    // 批量求最大的等价类，给组合很多、需要先按点数去重的场合（例如奥马哈）用，count 必须大于 0：
+    // keySums 为不成同花的 5~7 张牌的 RANK_KEYS 之和；ranks 为同一花色的 5~7 张牌的点数掩码
+    [[nodiscard]] static uint16_t bestRankClass(const uint32_t *keySums, int count);
+    [[nodiscard]] static uint16_t bestFlushClass(const uint32_t *ranks, int count);
+
+    [[nodiscard]] static size_t tableBytes();
+
+    static constexpr int HAND_CLASS_COUNT = 7462;
+
+    // 每个点数的键值，任意不超过 7 张牌（每个点数最多 4 张）的键值和互不相同；HandState 增量累加
+    static constexpr uint32_t RANK_KEYS[13] = {
+            1, 5, 24, 112, 521, 2247, 9244, 30823, 103066, 250154, 667453, 1526359, 3453520
+    };
+
+private:
+    friend class HandState;
+
+    struct Tables;
+    static const Tables &tables();
+};
+
+#endif  // LOOKUPEVALUATOR_H
@@ -0,0 +1,150 @@
+#include "omahaevaluator.h"
+#include "evaluator.h"
+#include "handevaluator.h"
+#include "lookupevaluator.h"
+#include "../Trace/trace.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+    // 6 张手牌取 2 张最多 15 组
+    constexpr int MAX_PAIRS = 15;
+
+    // 把 key 加入 keys 的前 count 个中，已有时不重复
+    void addUnique(uint32_t *keys, int &count, uint32_t key) {
+        if (std::find(keys, keys + count, key) == keys + count) {
+            keys[count++] = key;
+        }
+    }
+
+    uint32_t rankKey(Card card) {
+        return LookupEvaluator::RANK_KEYS[card.getIndex() % RANK_COUNT];
+    }
+
+    // 掩码中至少有 n 个位；没有打开 popcnt 指令时 __builtin_popcount 是库函数调用，这里只需要判断下限
+    bool hasAtLeast(uint32_t mask, int n) {
+        for (int i = 1; i < n && mask != 0; ++i) {
+            mask &= mask - 1;
+        }
+        return mask != 0;
+    }
+
+}
+
+OmahaEvaluator::OmahaEvaluator(CardSet board) : board(board) {
+    if (board.size() < 3 || board.size() > 5) {
+        throw std::invalid_argument("omaha board must have 3 to 5 cards");
+    }
+    LookupEvaluator::initialize();
+    uint64_t cards[5];
+    uint32_t cardKeys[5];
+    int count = 0;
+    for (Card card: board) {
+        cards[count] = CardSet(card).getBits();
+        cardKeys[count++] = rankKey(card);
+    }
+    uint64_t suitCards = 0;
+    for (int suit = 0; suit < SUIT_COUNT; ++suit) {
+        if (hasAtLeast(board.suitRanks(static_cast<Suit>(suit)), 3)) {
+            flushSuit = suit;
+            suitCards = static_cast<uint64_t>(Evaluator::RANK_MASK) << (suit * RANK_COUNT);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        for (int j = i + 1; j < count; ++j) {
+            for (int k = j + 1; k < count; ++k) {
+                const CardSet triple(cards[i] | cards[j] | cards[k]);
+                triples[tripleCount++] = triple.getBits();
+                addUnique(tripleKeys, tripleKeyCount, cardKeys[i] + cardKeys[j] + cardKeys[k]);
+                if (flushSuit >= 0 && (triple.getBits() & ~suitCards) == 0) {
+                    flushTriples[flushTripleCount++] = triple.suitRanks(static_cast<Suit>(flushSuit));
+                }
+            }
+        }
+    }
+}
+
+void OmahaEvaluator::checkHole(CardSet hole) const {
+    if (hole.size() < MIN_HOLE || hole.size() > MAX_HOLE || hole.intersects(board)) {
+        throw std::invalid_argument("omaha hand must have 2 to 6 cards not on the board");
+    }
+}
+
+uint16_t OmahaEvaluator::evaluateClass(CardSet hole) const {
+    checkHole(hole);
+    uint32_t cardKeys[MAX_HOLE];
+    int count = 0;
+    for (Card card: hole) {
+        cardKeys[count++] = rankKey(card);
+    }
+
+    // 点数相同的两张手牌组合在不成同花时牌力相同，只算一次
+    uint32_t pairKeys[MAX_PAIRS];
+    int pairCount = 0;
+    for (int i = 0; i < count; ++i) {
+        for (int j = i + 1; j < count; ++j) {
+            addUnique(pairKeys, pairCount, cardKeys[i] + cardKeys[j]);
+        }
+    }
+    uint32_t keys[MAX_PAIRS * MAX_TRIPLES];
+    int keyCount = 0;
+    for (int p = 0; p < pairCount; ++p) {
+        for (int t = 0; t < tripleKeyCount; ++t) {
+            keys[keyCount++] = pairKeys[p] + tripleKeys[t];
+        }
+    }
+    uint16_t best = LookupEvaluator::bestRankClass(keys, keyCount);
+
+    // 同花只可能来自公共牌三张同花的花色，而且要两张手牌都是该花色
+    if (flushSuit >= 0) {
+        const uint32_t suited = hole.suitRanks(static_cast<Suit>(flushSuit));
+        if (hasAtLeast(suited, 2) && flushTripleCount > 0) {
+            uint32_t flushes[MAX_PAIRS * MAX_TRIPLES];
+            int flushCount = 0;
+            for (uint32_t first = suited; first != 0; first &= first - 1) {
+                const uint32_t low = first & (0u - first);
+                for (uint32_t second = first & (first - 1); second != 0; second &= second - 1) {
+                    const uint32_t pair = low | (second & (0u - second));
+                    for (int t = 0; t < flushTripleCount; ++t) {
+                        flushes[flushCount++] = pair | flushTriples[t];
+                    }
+                }
+            }
+            best = std::max(best, LookupEvaluator::bestFlushClass(flushes, flushCount));
+        }
+    }
+    // 一手奥马哈牌记一次求值，与 LookupEvaluator::evaluate 的计数口径相同
+    if constexpr (Counters::ENABLED) {
+        Counters::recordEvaluation(LookupEvaluator::classStrength(best));
+    }
+    return best;
+}
+
+uint32_t OmahaEvaluator::evaluate(CardSet hole) const {
+    return LookupEvaluator::classStrength(evaluateClass(hole));
+}
+
+HandType OmahaEvaluator::handType(CardSet hole) const {
+    return LookupEvaluator::handType(evaluate(hole));
+}
+
+CardSet OmahaEvaluator::bestHand(CardSet hole) const {
+    checkHole(hole);
+    const std::vector<Card> cards = hole.toCards();
+    uint32_t bestStrength = 0;
+    uint64_t best = 0;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        for (size_t j = i + 1; j < cards.size(); ++j) {
+            const uint64_t pair = CardSet(cards[i]).getBits() | CardSet(cards[j]).getBits();
+            for (int t = 0; t < tripleCount; ++t) {
+                const uint32_t strength = HandEvaluator<5>::evaluate(pair | triples[t]);
+                if (strength > bestStrength) {
+                    bestStrength = strength;
+                    best = pair | triples[t];
+                }
+            }
+        }
+    }
+    return CardSet(best);
+}
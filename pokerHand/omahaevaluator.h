@@ -0,0 +1,46 @@
+#ifndef OMAHAEVALUATOR_H
+#define OMAHAEVALUATOR_H
+
+#include "../Card/cardset.h"
+#include "handtype.h"
+#include <cstdint>
+
+// 奥马哈牌力评估：必须正好用两张手牌加三张公共牌
+// 一副公共牌构造一次，预先算好与手牌无关的部分：每组三张公共牌的点数键值和（点数相同的组只留一组），
+// 以及唯一可能成同花的花色（公共牌有三张以上）和该花色的三张组合。求值时手牌的两张组合也按点数去重，
+// 非同花部分只是键值和相加后批量查 LookupEvaluator 的表；公共牌没有三张同花时整个同花部分都跳过。
+// 牌力编码与 LookupEvaluator 相同，可以直接比较大小。
+class OmahaEvaluator {
+public:
+    static constexpr int MIN_HOLE = 2;
+    static constexpr int MAX_HOLE = 6;
+
+    // 公共牌 3~5 张，否则抛出 std::invalid_argument
+    explicit OmahaEvaluator(CardSet board);
+
+    // 手牌 2~6 张（PLO4 为 4 张，PLO5 为 5 张），不能与公共牌重复，否则抛出 std::invalid_argument
+    [[nodiscard]] uint32_t evaluate(CardSet hole) const;
+    // 等价类编号，见 LookupEvaluator::evaluateClass
+    [[nodiscard]] uint16_t evaluateClass(CardSet hole) const;
+    [[nodiscard]] HandType handType(CardSet hole) const;
+    // 组成最大牌力的五张牌（两张手牌加三张公共牌），逐个组合求值，只在需要知道是哪五张时使用
+    [[nodiscard]] CardSet bestHand(CardSet hole) const;
+
+    [[nodiscard]] CardSet getBoard() const { return board; }
+
+private:
+    static constexpr int MAX_TRIPLES = 10;  // 5 张公共牌取 3 张
+
+    CardSet board;
+    uint64_t triples[MAX_TRIPLES] = {};       // 所有三张组合，bestHand() 用
+    int tripleCount = 0;
+    uint32_t tripleKeys[MAX_TRIPLES] = {};    // 按点数去重后的键值和
+    int tripleKeyCount = 0;
+    int flushSuit = -1;                       // 公共牌有三张以上的花色，5 张公共牌最多只有一种
+    uint32_t flushTriples[MAX_TRIPLES] = {};  // 该花色的三张组合的点数掩码
+    int flushTripleCount = 0;
+
+    void checkHole(CardSet hole) const;
+};
+
+#endif  // OMAHAEVALUATOR_H
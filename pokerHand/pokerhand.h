@@ -2,28 +2,24 @@
 #define POKERHAND_H
 
 #include "../Card/card.h"
+#include "../Card/cardset.h"
+#include "handtype.h"
+#include <cstdint>
 #include <vector>
 #include <iostream>
 
-enum class HandType {
-    HIGH_CARD,
-    PAIR,
-    TWO_PAIR,
-    THREE_OF_A_KIND,
-    STRAIGHT,
-    FLUSH,
-    FULL_HOUSE,
-    FOUR_OF_A_KIND,
-    STRAIGHT_FLUSH
-};
-
 class PokerHand {
 public:
     explicit PokerHand(const std::vector<Card>& hand);
+    explicit PokerHand(CardSet cards);
 
     [[nodiscard]] HandType getHandType() const;
+    // 可直接比较大小的牌力值，见 Evaluator::evaluate 和 LookupEvaluator::evaluate
+    [[nodiscard]] uint32_t getStrength() const;
     static int compareHands(const std::vector<Card>& hand1, const std::vector<Card>& hand2);
+    static int compareHands(CardSet hand1, CardSet hand2);
 
+    // 牌型判断：牌型恰好是该类型时返回 true，例如同花顺不算同花
     [[nodiscard]] bool isHighCard() const;
     [[nodiscard]] bool isPair() const;
     [[nodiscard]] bool isTwoPair() const;
@@ -34,11 +30,19 @@ public:
     [[nodiscard]] bool isFourOfAKind() const;
     [[nodiscard]] bool isStraightFlush() const;
     static std::vector<Card> getBestHand(const std::vector<Card>& hand1, const std::vector<Card>& hand2);
+    static CardSet getBestHand(CardSet hand1, CardSet hand2);
     void printHandType() const;
 
+    // 奥马哈（PLO4/PLO5）：必须正好用两张手牌加三张公共牌，公共牌 3~5 张，见 OmahaEvaluator
+    // 同一副公共牌上要比较很多手牌时，直接构造一个 OmahaEvaluator 反复使用更快
+    // 牌数不对、手牌与公共牌重复或两手牌有相同的牌时抛出 std::invalid_argument
+    static uint32_t evaluateOmaha(CardSet hole, CardSet board);
+    static int compareOmahaHands(CardSet hole1, CardSet hole2, CardSet board);
+    static CardSet getBestOmahaHand(CardSet hole, CardSet board);
+
 private:
-    std::vector<Card> hand;
-    static bool isBetterHand(const std::vector<Card>& hand1, const std::vector<Card>& hand2) ;
+    CardSet cards;
+    static void findBestFive(const uint64_t* masks, int count, int* best);
 };
 
 #endif  // POKERHAND_H